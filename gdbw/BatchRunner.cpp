@@ -0,0 +1,261 @@
+#include "BatchRunner.hpp"
+
+extern thread_local gdbw::DE::Engine* g_dbg;
+
+thread_local gdbw::BatchRunner* gdbw::BatchRunner::s_runner = nullptr;
+thread_local const std::string* gdbw::BatchRunner::s_input = nullptr;
+
+// Nested tables deeper than this (or cycles) are written as null
+static constexpr int MaxDepth = 32;
+
+gdbw::BatchRunner::BatchRunner(const std::string& script, const std::vector<std::string>& inputs, size_t jobs, SetupFunction setup)
+{
+	m_script = script;
+	m_inputs = inputs;
+	m_jobs = std::clamp<size_t>(jobs, 1, std::max<size_t>(inputs.size(), 1));
+	m_setup = setup;
+}
+
+std::expected<size_t, std::string> gdbw::BatchRunner::Run(void)
+{
+	std::vector<std::thread> workers;
+	workers.reserve(m_jobs);
+	for (size_t i = 0; i < m_jobs; i++)
+		workers.emplace_back(&BatchRunner::Worker, this);
+	for (auto& worker : workers)
+		worker.join();
+
+	if (!m_error.empty())
+		return std::unexpected(m_error);
+	return m_failed.load();
+}
+
+void gdbw::BatchRunner::Worker(void)
+{
+	// Workers already run one per core, scans (search, strings, ptrscan) stay on this worker
+	ScanScheduler::SetDefaultWorkers(1);
+
+	// Bindings only ever see this thread's engine through g_dbg
+	LuaManager lua;
+	m_setup(&lua);
+	DE::Engine engine;
+	auto init_result = engine.InitOffline(&lua);
+	auto script = lua.LoadScript(m_script);
+	if (!init_result || !script)
+	{
+		std::lock_guard lock(m_lock);
+		m_error = !init_result ? init_result.error() : script.error();
+		m_next = m_inputs.size(); // stop the other workers too
+		return;
+	}
+	g_dbg = &engine;
+
+	for (size_t i = m_next++; i < m_inputs.size(); i = m_next++)
+	{
+		const std::string& input = m_inputs[i];
+		std::string line = "{\"input\":";
+		EncodeString(input, line);
+
+		auto target = OpenInput(input);
+		if (!target)
+		{
+			line += ",\"error\":";
+			EncodeString(target.error(), line);
+			WriteLine(line + "}");
+			m_failed++;
+			continue;
+		}
+
+		engine.SetTarget(target->get());
+		s_runner = this;
+		s_input = &input;
+		auto result = lua.RunScript(*script, input);
+		s_runner = nullptr;
+		s_input = nullptr;
+		engine.SetTarget(nullptr);
+
+		if (!result)
+		{
+			line += ",\"error\":";
+			EncodeString(result.error(), line);
+			WriteLine(line + "}");
+			m_failed++;
+		}
+	}
+	g_dbg = nullptr;
+}
+
+std::expected<std::unique_ptr<gdbw::Target>, std::string> gdbw::BatchRunner::OpenInput(const std::string& path)
+{
+	auto dump = std::make_unique<DumpTarget>();
+	auto dump_result = dump->Open(path);
+	if (dump_result)
+		return dump;
+
+	auto snapshot = std::make_unique<SnapshotTarget>();
+	auto snapshot_result = snapshot->Load(path);
+	if (snapshot_result)
+		return snapshot;
+	return std::unexpected(std::format("{} ({})", dump_result.error(), snapshot_result.error()));
+}
+
+std::expected<bool, std::string> gdbw::BatchRunner::Emit(lua_State* L, int index)
+{
+	if (!s_runner)
+		return std::unexpected("EmitResult is only available when running a script over dumps (--script)");
+
+	std::string line = "{\"input\":";
+	EncodeString(*s_input, line);
+	line += ",\"result\":";
+	EncodeValue(L, lua_absindex(L, index), line);
+	s_runner->WriteLine(line + "}");
+	return true;
+}
+
+void gdbw::BatchRunner::WriteLine(const std::string& line)
+{
+	std::lock_guard lock(m_lock);
+	fwrite(line.data(), 1, line.size(), stdout);
+	fputc('\n', stdout);
+	fflush(stdout);
+}
+
+void gdbw::BatchRunner::EncodeValue(lua_State* L, int index, std::string& out, int depth)
+{
+	switch (lua_type(L, index))
+	{
+	case LUA_TBOOLEAN:
+		out += lua_toboolean(L, index) ? "true" : "false";
+		return;
+	case LUA_TNUMBER:
+		if (lua_isinteger(L, index))
+			out += std::to_string(lua_tointeger(L, index));
+		else if (std::isfinite(lua_tonumber(L, index)))
+			out += std::format("{}", lua_tonumber(L, index));
+		else
+			out += "null";
+		return;
+	case LUA_TSTRING:
+	{
+		size_t len = 0;
+		const char* str = lua_tolstring(L, index, &len);
+		EncodeString(std::string_view(str, len), out);
+		return;
+	}
+	case LUA_TTABLE:
+		break;
+	default:
+		out += "null";
+		return;
+	}
+
+	if (depth >= MaxDepth)
+	{
+		out += "null";
+		return;
+	}
+
+	// Sequences {1..n} become arrays, anything else an object
+	size_t keys = 0;
+	bool sequence = true;
+	lua_pushnil(L);
+	while (lua_next(L, index))
+	{
+		keys++;
+		sequence = sequence && lua_isinteger(L, -2) && lua_tointeger(L, -2) >= 1;
+		lua_pop(L, 1);
+	}
+	sequence = sequence && keys == lua_rawlen(L, index);
+
+	if (sequence && keys != 0)
+	{
+		out += '[';
+		for (size_t i = 1; i <= keys; i++)
+		{
+			if (i != 1) out += ',';
+			lua_rawgeti(L, index, (lua_Integer)i);
+			EncodeValue(L, lua_gettop(L), out, depth + 1);
+			lua_pop(L, 1);
+		}
+		out += ']';
+		return;
+	}
+
+	out += '{';
+	bool first = true;
+	lua_pushnil(L);
+	while (lua_next(L, index))
+	{
+		// Only string & number keys, convert a copy so lua_next still sees the original key
+		int type = lua_type(L, -2);
+		if (type == LUA_TSTRING || type == LUA_TNUMBER)
+		{
+			if (!first) out += ',';
+			first = false;
+			lua_pushvalue(L, -2);
+			size_t len = 0;
+			const char* key = lua_tolstring(L, -1, &len);
+			EncodeString(std::string_view(key, len), out);
+			lua_pop(L, 1);
+			out += ':';
+			EncodeValue(L, lua_gettop(L), out, depth + 1);
+		}
+		lua_pop(L, 1);
+	}
+	out += '}';
+}
+
+void gdbw::BatchRunner::EncodeString(std::string_view str, std::string& out)
+{
+	// Valid UTF-8 is written as is. Control characters & bytes that aren't part of a valid sequence
+	// (strings read out of memory) are escaped as the code point of the byte, so lines stay valid JSON.
+	out += '"';
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		unsigned char c = (unsigned char)str[i];
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += (char)c;
+		}
+		else if (c < 0x20 || c == 0x7F)
+			out += std::format("\\u{:04x}", c);
+		else if (c < 0x80)
+			out += (char)c;
+		else if (size_t len = Utf8SequenceLength(str.substr(i)))
+		{
+			out.append(str.substr(i, len));
+			i += len - 1;
+		}
+		else
+			out += std::format("\\u{:04x}", c);
+	}
+	out += '"';
+}
+
+size_t gdbw::BatchRunner::Utf8SequenceLength(std::string_view str)
+{
+	unsigned char lead = (unsigned char)str[0];
+	size_t len = 0;
+	uint32_t codepoint = 0;
+	if (lead >= 0xC2 && lead <= 0xDF)
+		len = 2, codepoint = lead & 0x1F;
+	else if (lead >= 0xE0 && lead <= 0xEF)
+		len = 3, codepoint = lead & 0x0F;
+	else if (lead >= 0xF0 && lead <= 0xF4)
+		len = 4, codepoint = lead & 0x07;
+	if (len == 0 || str.size() < len)
+		return 0;
+	for (size_t i = 1; i < len; i++)
+	{
+		unsigned char c = (unsigned char)str[i];
+		if ((c & 0xC0) != 0x80)
+			return 0;
+		codepoint = codepoint << 6 | (c & 0x3F);
+	}
+	// Overlong forms, surrogates & anything past U+10FFFF aren't valid
+	static constexpr uint32_t Minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+	if (codepoint < Minimum[len] || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+		return 0;
+	return len;
+}
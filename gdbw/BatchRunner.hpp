@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "DebugEngine.hpp"
+#include "DumpTarget.hpp"
+#include "ScanScheduler.hpp"
+#include "SnapshotTarget.hpp"
+
+namespace gdbw
+{
+	// Runs a lua script against many dumps/snapshots without a prompt. Every worker thread owns
+	// its own lua state, engine & target, results are streamed to stdout as JSON lines.
+	class BatchRunner
+	{
+	public:
+		// Registers the bindings in a worker's lua state
+		using SetupFunction = std::function<void(LuaManager* lua)>;
+
+		BatchRunner(const std::string& script, const std::vector<std::string>& inputs, size_t jobs, SetupFunction setup);
+
+		// Run the script over every input, returns the number of inputs it failed on
+		std::expected<size_t, std::string> Run(void);
+		// Emit the value at `index` as a result of the input the calling worker is processing
+		static std::expected<bool, std::string> Emit(lua_State* L, int index);
+		// Open a dump or snapshot, also used for the interactive --dump
+		static std::expected<std::unique_ptr<Target>, std::string> OpenInput(const std::string& path);
+	private:
+		void Worker(void);
+		// Write one JSON line, lines from different workers never interleave
+		void WriteLine(const std::string& line);
+		static void EncodeValue(lua_State* L, int index, std::string& out, int depth = 0);
+		static void EncodeString(std::string_view str, std::string& out);
+		// Length of the valid UTF-8 sequence at the start of `str`, 0 if there's none
+		static size_t Utf8SequenceLength(std::string_view str);
+
+		std::string m_script;
+		std::vector<std::string> m_inputs;
+		size_t m_jobs;
+		SetupFunction m_setup;
+		std::atomic<size_t> m_next = 0;
+		std::atomic<size_t> m_failed = 0;
+		std::mutex m_lock; // guards stdout & m_error
+		std::string m_error;
+
+		// Runner & input of the calling worker, only set while its script is running
+		static thread_local BatchRunner* s_runner;
+		static thread_local const std::string* s_input;
+	};
+}
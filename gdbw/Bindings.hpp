@@ -1,9 +1,19 @@
 #pragma once
+#include "BatchRunner.hpp"
 #include "DebugEngine.hpp"
 #include "Disassembler.hpp"
 #include "MemoryRegion.hpp"
-
-extern gdbw::DE::Engine* g_dbg;
+#include "MemorySearch.hpp"
+#include "PointerScan.hpp"
+#include "SnapshotTarget.hpp"
+#include "Telescope.hpp"
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// Per thread, batch mode workers each drive their own engine
+extern thread_local gdbw::DE::Engine* g_dbg;
 
 // Set a field in a table, assumes table is currently at the top of the lua stack.
 static inline void setfieldi(lua_State* L, const char* key, size_t value, int idx = -2)
@@ -12,36 +22,141 @@ static inline void setfieldi(lua_State* L, const char* key, size_t value, int id
 	lua_setfield(L, idx, key);
 }
 
+// Get an integer field from the table at `idx`, or `fallback` if it's missing.
+static inline lua_Integer getfieldi(lua_State* L, int idx, const char* key, lua_Integer fallback)
+{
+	if (!lua_istable(L, idx))
+		return fallback;
+	lua_getfield(L, idx, key);
+	lua_Integer value = lua_isinteger(L, -1) ? lua_tointeger(L, -1) : fallback;
+	lua_pop(L, 1);
+	return value;
+}
+
+// Push scan statistics as a table to the top of the lua stack.
+static inline void pushscanstats(lua_State* L, const gdbw::ScanScheduler::Stats& stats)
+{
+	lua_createtable(L, 0, 4);
+	setfieldi(L, "bytes", stats.bytes);
+	lua_pushnumber(L, stats.seconds);
+	lua_setfield(L, -2, "seconds");
+	lua_pushnumber(L, stats.BytesPerSecond());
+	lua_setfield(L, -2, "bytespersecond");
+	lua_pushboolean(L, stats.cancelled);
+	lua_setfield(L, -2, "cancelled");
+}
+
+// Push a symbol as a table to the top of the lua stack.
+static inline void pushsymbol(lua_State* L, const gdbw::Symbol& symbol)
+{
+	lua_createtable(L, 0, 6);
+	setfieldi(L, "address", symbol.Address());
+	setfieldi(L, "displacement", symbol.Displacement());
+	setfieldi(L, "flags", symbol.Flags());
+	setfieldi(L, "modbase", symbol.ModBase());
+	lua_pushstring(L, symbol.Name());
+	lua_setfield(L, -2, "name");
+	setfieldi(L, "size", symbol.Size());
+}
+
+// Push a register context as a table to the top of the lua stack.
+// Register names are static strings, which lua's string cache resolves without rehashing.
+static inline void pushregisters(lua_State* L, const gdbw::DE::RegisterContext& context)
+{
+	lua_createtable(L, 0, (int)context.count);
+	for (size_t i = 0; i < context.count; i++)
+		setfieldi(L, context.names[i], context.values[i]);
+}
+
+// Push a list of regions as an array of tables to the top of the lua stack.
+static inline void pushregions(lua_State* L, const std::vector<MemoryRegion>& regions)
+{
+	lua_createtable(L, (int)regions.size(), 0);
+	for (size_t i = 0; i < regions.size(); i++)
+	{
+		lua_createtable(L, 0, 5);
+		setfieldi(L, "baseaddress", regions[i].BaseAddress());
+		setfieldi(L, "protections", regions[i].Protections());
+		setfieldi(L, "size", regions[i].Size());
+		setfieldi(L, "state", regions[i].State());
+		setfieldi(L, "type", regions[i].Type());
+		lua_rawseti(L, -2, i + 1);
+	}
+}
+
+// Push region `index` of a region map, with its kind & module, as a table to the top of the lua stack.
+static inline void pushregioninfo(lua_State* L, const gdbw::RegionMap& regions, size_t index)
+{
+	const MemoryRegion& region = regions.Regions()[index];
+	lua_createtable(L, 0, 7);
+	setfieldi(L, "baseaddress", region.BaseAddress());
+	setfieldi(L, "size", region.Size());
+	setfieldi(L, "protections", region.Protections());
+	setfieldi(L, "state", region.State());
+	setfieldi(L, "type", region.Type());
+	lua_pushstring(L, gdbw::RegionMap::KindName(regions.Kind(index)));
+	lua_setfield(L, -2, "kind");
+	lua_pushstring(L, regions.Module(index));
+	lua_setfield(L, -2, "module");
+}
+
 namespace gdbw::bindings
 {
 	static int AddressToSymbol(lua_State* L)
 	{
 		size_t address = luaL_checkinteger(L, 1);
 
-		auto result = g_dbg->GetSymbolManager()->SymbolFromAddress(address);
+		// DbgHelp for a live DbgEng session, otherwise the target's own symbols (if it has any)
+		auto result = g_dbg->GetTarget()->SymbolFromAddress(address);
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
-		auto symbol = *result;
-		lua_createtable(L, 0, 5);
+		pushsymbol(L, *result);
 
-		lua_pushinteger(L, symbol->Address());
-		lua_setfield(L, -2, "address");
-		lua_pushinteger(L, symbol->Displacement());
-		lua_setfield(L, -2, "displacement");
-		lua_pushinteger(L, symbol->Flags());
-		lua_setfield(L, -2, "flags");
-		lua_pushinteger(L, symbol->ModBase());
-		lua_setfield(L, -2, "modbase");
-		lua_pushlstring(L, symbol->Name(), strlen(symbol->Name()));
-		lua_setfield(L, -2, "name");
-		lua_pushinteger(L, symbol->Size());
-		lua_setfield(L, -2, "size");
+		return 1;
+	}
+
+	static int AddressesToSymbols(lua_State* L)
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		lua_Integer count = luaL_len(L, 1);
+
+		// (address, index in the input table)
+		std::vector<std::pair<uint64_t, lua_Integer>> inputs;
+		inputs.reserve(count);
+		for (lua_Integer i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			if (lua_isinteger(L, -1))
+				inputs.push_back({ (uint64_t)lua_tointeger(L, -1), i });
+			lua_pop(L, 1);
+		}
+		std::sort(inputs.begin(), inputs.end());
+
+		std::vector<uint64_t> addresses;
+		addresses.reserve(inputs.size());
+		for (auto& input : inputs)
+			if (addresses.empty() || addresses.back() != input.first)
+				addresses.push_back(input.first);
 
+		auto symbols = g_dbg->SymbolsFromAddresses(addresses);
+
+		// Parallel to the input table, misses are left as nil
+		lua_createtable(L, (int)count, 0);
+		size_t j = 0;
+		for (auto& input : inputs)
+		{
+			while (addresses[j] != input.first)
+				j++;
+			if (!symbols[j])
+				continue;
+			pushsymbol(L, *symbols[j]);
+			lua_rawseti(L, -2, input.second);
+		}
 		return 1;
 	}
 
@@ -59,7 +174,7 @@ namespace gdbw::bindings
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
@@ -78,16 +193,19 @@ namespace gdbw::bindings
 			return 2;
 		}
 
-		auto result = g_dbg->BreakpointAdd(address);
+		bool created = false;
+		auto result = g_dbg->BreakpointAdd(address, &created);
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
+		// Commands only roll back a breakpoint they created, not one that was already there
 		lua_pushinteger(L, *result);
-		return 1;
+		lua_pushboolean(L, created);
+		return 2;
 	}
 
 	static int BreakpointSetFlags(lua_State* L)
@@ -99,7 +217,7 @@ namespace gdbw::bindings
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
@@ -114,64 +232,171 @@ namespace gdbw::bindings
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
 		return 0;
 	}
 
-	static int BreakpointGetAll(lua_State* L)
+	static int BreakpointSetCondition(lua_State* L)
 	{
-		std::vector<PDEBUG_BREAKPOINT> bps = g_dbg->GetBreakpoints();
+		size_t id = luaL_checkinteger(L, 1);
+		const char* expression = luaL_optstring(L, 2, "");
 
-		lua_createtable(L, (int)bps.size(), 0);
-		for (size_t i = 0; i < bps.size(); i++)
+		auto result = g_dbg->BreakpointSetCondition(id, expression);
+		if (!result)
 		{
-			PDEBUG_BREAKPOINT bp = bps[i];
-			ULONG64 address = 0;
-			ULONG bpflags = 0;
-			int enabled = 0;
-			if (bp == nullptr) continue;
-			auto hr = bp->GetOffset(&address);
-			if (FAILED(hr))
-			{
-				lua_pushnil(L);
-				luaL_error(L, std::format("Failed to get address for breakpoint {}", i).c_str());
-				return 2;
-			}
-			hr = bp->GetFlags(&bpflags);
-			if (FAILED(hr))
-			{
-				lua_pushnil(L);
-				luaL_error(L, std::format("Failed to get flags for breakpoint {}", i).c_str());
-				return 2;
-			}
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
 
-			enabled = bpflags & DEBUG_BREAKPOINT_ENABLED;
+		return 0;
+	}
+
+	static int TracepointAdd(lua_State* L)
+	{
+		size_t address = luaL_checkinteger(L, 1);
+		const char* fields = luaL_checkstring(L, 2);
+		size_t capacity = luaL_optinteger(L, 3, 0x10000);
+
+		auto result = g_dbg->TracepointAdd(address, fields, capacity);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, *result);
+		return 1;
+	}
+
+	static int WatchAdd(lua_State* L)
+	{
+		size_t address = luaL_checkinteger(L, 1);
+		size_t size = luaL_optinteger(L, 2, g_dbg->Is64BitTarget() ? 8 : 4);
+		std::string access = luaL_optstring(L, 3, "write");
+		bool changed = lua_toboolean(L, 4);
+
+		bool created = false;
+		std::expected<ULONG, std::string> result = std::unexpected(std::format("WatchAdd unknown access '{}'", access));
+		if (access == "write")
+			result = g_dbg->WatchAdd(address, (ULONG)size, DEBUG_BREAK_WRITE, changed, &created);
+		else if (access == "read")
+			result = g_dbg->WatchAdd(address, (ULONG)size, DEBUG_BREAK_READ, changed, &created);
+		else if (access == "execute")
+			result = g_dbg->WatchAdd(address, (ULONG)size, DEBUG_BREAK_EXECUTE, changed, &created);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, *result);
+		lua_pushboolean(L, created);
+		return 2;
+	}
+
+	static int TracepointDump(lua_State* L)
+	{
+		size_t id = luaL_checkinteger(L, 1);
+		std::string path = luaL_checkstring(L, 2);
+		std::string format = luaL_optstring(L, 3, "csv");
+
+		const Tracepoint* tracepoint = g_dbg->GetTracepoint(id);
+		std::expected<bool, std::string> result = std::unexpected(std::format("Breakpoint {} is not a tracepoint", id));
+		if (tracepoint && format == "csv")
+			result = tracepoint->WriteCsv(path);
+		else if (tracepoint && format == "binary")
+			result = tracepoint->WriteBinary(path);
+		else if (tracepoint)
+			result = std::unexpected(std::format("TracepointDump unknown format '{}'", format));
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, tracepoint->Size());
+		return 1;
+	}
+
+	static int BreakpointGetAll(lua_State* L)
+	{
+		const BreakpointRegistry& bps = g_dbg->GetBreakpoints();
+
+		// Address & flags are tracked by the registry, listing makes no DbgEng calls
+		lua_createtable(L, (int)bps.Size(), 0);
+		bps.ForEach([L](const Breakpoint& bp) {
+			// Coverage breakpoints are listed by CoverageGetStats
+			if (bp.block)
+				return;
 
 			// child table (Breakpoint)
-			lua_createtable(L, 0, 3);
+			lua_createtable(L, 0, 4);
 
-			lua_pushinteger(L, i);
+			lua_pushinteger(L, bp.id);
 			lua_setfield(L, -2, "id");
-			lua_pushinteger(L, address);
+			lua_pushinteger(L, bp.address);
 			lua_setfield(L, -2, "address");
-			lua_pushboolean(L, enabled);
+			lua_pushboolean(L, bp.flags & DEBUG_BREAKPOINT_ENABLED);
 			lua_setfield(L, -2, "enabled");
+			if (bp.condition)
+			{
+				lua_pushstring(L, bp.condition->Expression().c_str());
+				lua_setfield(L, -2, "condition");
+			}
+			if (bp.datasize)
+			{
+				lua_createtable(L, 0, 3);
+				setfieldi(L, "size", bp.datasize);
+				const char* access = bp.access == DEBUG_BREAK_EXECUTE ? "execute" : bp.access == DEBUG_BREAK_READ ? "read" : "write";
+				lua_pushstring(L, access);
+				lua_setfield(L, -2, "access");
+				lua_pushboolean(L, bp.value.has_value());
+				lua_setfield(L, -2, "changed");
+				lua_setfield(L, -2, "watch");
+			}
+			if (bp.tracepoint)
+			{
+				const Tracepoint* tracepoint = &*bp.tracepoint;
+				lua_createtable(L, 0, 5);
+				lua_createtable(L, (int)tracepoint->Fields().size(), 0);
+				for (size_t j = 0; j < tracepoint->Fields().size(); j++)
+				{
+					lua_pushstring(L, tracepoint->Fields()[j].Expression().c_str());
+					lua_rawseti(L, -2, j + 1);
+				}
+				lua_setfield(L, -2, "fields");
+				setfieldi(L, "hits", tracepoint->Hits());
+				setfieldi(L, "records", tracepoint->Size());
+				setfieldi(L, "dropped", tracepoint->Dropped());
+				setfieldi(L, "capacity", tracepoint->Capacity());
+				lua_setfield(L, -2, "tracepoint");
+			}
 
-			// push breakpoint index (in parent table)
-			lua_rawseti(L, -2, i + 1);
-		}
+			// push breakpoint by id (in parent table)
+			lua_rawseti(L, -2, bp.id + 1);
+		});
 		return 1;
 	}
 
 	static int ConsoleCols(lua_State* L)
 	{
-		CONSOLE_SCREEN_BUFFER_INFO csbi;
 		int cols;
+#ifdef _WIN32
+		CONSOLE_SCREEN_BUFFER_INFO csbi;
 		GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
 		cols = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+#else
+		winsize ws = { 0 };
+		ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
+		cols = ws.ws_col;
+#endif
 
 		lua_pushinteger(L, cols);
 		return 1;
@@ -179,15 +404,118 @@ namespace gdbw::bindings
 
 	static int ConsoleRows(lua_State* L)
 	{
-		CONSOLE_SCREEN_BUFFER_INFO csbi;
 		int rows;
+#ifdef _WIN32
+		CONSOLE_SCREEN_BUFFER_INFO csbi;
 		GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi);
 		rows = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+#else
+		winsize ws = { 0 };
+		ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
+		rows = ws.ws_row;
+#endif
 
 		lua_pushinteger(L, rows);
 		return 1;
 	}
 
+	static int CoverageAdd(lua_State* L)
+	{
+		size_t address = luaL_checkinteger(L, 1);
+
+		// Blocks are module offsets, either integers or {offset, size} tables
+		std::vector<Coverage::Block> blocks;
+		if (lua_istable(L, 2))
+		{
+			lua_Integer count = luaL_len(L, 2);
+			blocks.reserve(count);
+			for (lua_Integer i = 1; i <= count; i++)
+			{
+				lua_rawgeti(L, 2, i);
+				if (lua_isinteger(L, -1))
+					blocks.push_back({ (uint32_t)lua_tointeger(L, -1), 1, 0 });
+				else if (lua_istable(L, -1))
+					blocks.push_back({ (uint32_t)getfieldi(L, -1, "offset", 0), (uint32_t)getfieldi(L, -1, "size", 1), 0 });
+				lua_pop(L, 1);
+			}
+		}
+
+		auto result = g_dbg->CoverageAdd(address, std::move(blocks));
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, *result);
+		return 1;
+	}
+
+	static int CoverageClear(lua_State* L)
+	{
+		auto result = g_dbg->CoverageClear();
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, *result);
+		return 1;
+	}
+
+	static int CoverageDump(lua_State* L)
+	{
+		std::string path = luaL_checkstring(L, 1);
+
+		const Coverage& coverage = g_dbg->GetCoverage();
+		auto result = coverage.WriteDrcov(path);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		lua_pushinteger(L, coverage.Hits());
+		return 1;
+	}
+
+	static int CoverageGetStats(lua_State* L)
+	{
+		const Coverage& coverage = g_dbg->GetCoverage();
+
+		// Per module counts in one pass over the blocks
+		std::vector<std::pair<size_t, size_t>> counts(coverage.Modules().size());
+		for (size_t i = 0; i < coverage.Blocks().size(); i++)
+		{
+			auto& count = counts[coverage.Blocks()[i].module];
+			count.first++;
+			count.second += coverage.IsHit((uint32_t)i);
+		}
+
+		lua_createtable(L, 0, 3);
+		setfieldi(L, "blocks", coverage.Blocks().size());
+		setfieldi(L, "hits", coverage.Hits());
+		lua_createtable(L, (int)coverage.Modules().size(), 0);
+		for (size_t i = 0; i < coverage.Modules().size(); i++)
+		{
+			auto& module = coverage.Modules()[i];
+			lua_createtable(L, 0, 5);
+			setfieldi(L, "base", module.base);
+			setfieldi(L, "size", module.size);
+			lua_pushstring(L, module.path.c_str());
+			lua_setfield(L, -2, "path");
+			setfieldi(L, "blocks", counts[i].first);
+			setfieldi(L, "hits", counts[i].second);
+			lua_rawseti(L, -2, i + 1);
+		}
+		lua_setfield(L, -2, "modules");
+		return 1;
+	}
+
 	static int Continue(lua_State* L)
 	{
 		g_dbg->SetState(DE::State::RUN);
@@ -200,35 +528,61 @@ namespace gdbw::bindings
 		ULONG len = (ULONG)luaL_checkinteger(L, 2);
 		size_t count = luaL_checkinteger(L, 3);
 
-		unsigned char* code = (unsigned char*)calloc(len, 1);
-		auto readmem_result = g_dbg->ReadVMUncached(address, &len, code);
-		if (!readmem_result)
+		// Disassemble straight out of the target when it can hand out a pointer (dumps)
+		const uint8_t* view = g_dbg->GetTarget()->View(address, len);
+		unsigned char* code = view ? nullptr : (unsigned char*)calloc(len, 1);
+		if (!view)
 		{
-			lua_pushnil(L);
-			luaL_error(L, readmem_result.error().c_str());
-			free(code);
-			return 2;
+			auto readmem_result = g_dbg->ReadVM(address, &len, code);
+			if (!readmem_result)
+			{
+				lua_pushnil(L);
+				luaL_error(L, "%s", readmem_result.error().c_str());
+				free(code);
+				return 2;
+			}
 		}
 
-		// TODO: when debugging syswow binary and executing 64-bit code, this assumes 32-bit code is also 64bit.
-		cs_mode mode = g_dbg->Is64BitTarget() ? cs_mode::CS_MODE_64 : cs_mode::CS_MODE_32;
-		auto dis = gdbw::Disassembler(cs_arch::CS_ARCH_X86, mode);
-
-		auto disasm_result = dis.Disasm((const uint8_t*)code, len, count, address);
+		InstructionBatch& insns = g_dbg->GetDisassembler()->ScratchBatch();
+		auto disasm_result = g_dbg->GetDisassembler()->Disasm(view ? view : (const uint8_t*)code, len, count, insns, address);
 		if (!disasm_result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, readmem_result.error().c_str());
+			luaL_error(L, "%s", disasm_result.error().c_str());
 			free(code);
 			return 2;
 		}
-		auto insns = *disasm_result;
-		Instruction::CreateInstructionsTable(L, insns);
+		InstructionBatch::CreateInstructionsTable(L, insns);
 
 		free(code);
 		return 1; // returns a single table
 	}
 
+	static int GetDisasmCacheStats(lua_State* L)
+	{
+		InstructionCache* cache = g_dbg->GetDisassembler()->GetCache();
+
+		lua_createtable(L, 0, 3);
+		setfieldi(L, "hits", cache->Hits());
+		setfieldi(L, "misses", cache->Misses());
+		setfieldi(L, "instructions", cache->Size());
+		return 1;
+	}
+
+	static int EmitResult(lua_State* L)
+	{
+		luaL_checkany(L, 1);
+
+		auto result = gdbw::BatchRunner::Emit(L, 1);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+		return 0;
+	}
+
 	static int Evaluate(lua_State* L)
 	{
 		PSTR expression = (PSTR)luaL_checkstring(L, 1);
@@ -303,58 +657,119 @@ namespace gdbw::bindings
 
 	static int GetContext32(lua_State* L)
 	{
-		const std::set<const char*> regs = {
-			"eax","ebx","ecx","edx","esi","edi","eip","esp","ebp"
-		};
-
-		auto result = g_dbg->GetRegisters(regs);
+		auto result = g_dbg->GetTarget()->GetRegisters(DE::RegisterSet::GP32);
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
-		lua_createtable(L, 0, regs.size());
-		auto registers = *result;
-		for (auto pair : registers)
-			setfieldi(L, pair.first.c_str(), pair.second);
-
+		pushregisters(L, *result);
 		return 1;
 	}
 
 	static int GetContext64(lua_State* L)
 	{
-		const std::set<const char*> regs = {
-			"rax","rbx","rcx","rdx","rsi","rdi","rip","rsp","rbp",
-			"r8","r9","r10","r11","r12","r13","r14","r15"
-		};
+		auto result = g_dbg->GetTarget()->GetRegisters(DE::RegisterSet::GP64);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		pushregisters(L, *result);
+		return 1;
+	}
 
-		auto result = g_dbg->GetRegisters(regs);
+	static int GetFullContext(lua_State* L)
+	{
+		auto result = g_dbg->GetFullContext();
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
-		lua_createtable(L, 0, regs.size());
-		auto registers = *result;
-		for (auto pair : registers)
-			setfieldi(L, pair.first.c_str(), pair.second);
-		
+		auto& context = *result;
+		lua_createtable(L, 0, (int)context.size());
+		for (auto& reg : context)
+		{
+			// vector registers as packed little endian binary strings, unpack with string.unpack
+			if (reg.isvector)
+				lua_pushlstring(L, (const char*)reg.bytes, reg.size);
+			else
+				lua_pushinteger(L, reg.value);
+			lua_setfield(L, -2, reg.name);
+		}
 		return 1;
 	}
 
+	static int GetThreads(lua_State* L)
+	{
+		auto threads = g_dbg->GetTarget()->GetThreads();
+		lua_createtable(L, (int)threads.size(), 0);
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			lua_pushinteger(L, threads[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+		return 1;
+	}
+
+	static int SetThread(lua_State* L)
+	{
+		uint32_t id = (uint32_t)luaL_checkinteger(L, 1);
+
+		auto result = g_dbg->GetTarget()->SetThread(id);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+
+		return 0;
+	}
+
+	static int GetMemoryCacheStats(lua_State* L)
+	{
+		PageCache* cache = g_dbg->GetPageCache();
+
+		lua_createtable(L, 0, 3);
+		setfieldi(L, "hits", cache->Hits());
+		setfieldi(L, "misses", cache->Misses());
+		setfieldi(L, "pages", cache->CachedPages());
+		return 1;
+	}
 
 	static int GetVMRegion(lua_State* L)
 	{
 		size_t address = luaL_checkinteger(L, 1);
 
-		MEMORY_BASIC_INFORMATION64 mbi = { 0 };
-
-		g_dbg->QueryVM(address, &mbi);
-		MemoryRegion region(&mbi);
+		MemoryRegion region({});
+#ifdef _WIN32
+		if (g_dbg->IsLiveSession())
+		{
+			MEMORY_BASIC_INFORMATION64 mbi = { 0 };
+			g_dbg->QueryVM(address, &mbi);
+			region = MemoryRegion({ mbi.BaseAddress, mbi.AllocationBase, mbi.RegionSize, (uint32_t)mbi.Protect, (uint32_t)mbi.State, (uint32_t)mbi.Type });
+		}
+		else
+#endif
+		{
+			// Other targets only report committed regions
+			const RegionMap& regions = g_dbg->GetRegionMap();
+			ptrdiff_t index = regions.Find(address);
+			if (index < 0)
+			{
+				lua_pushnil(L);
+				return 1;
+			}
+			region = regions.Regions()[index];
+		}
 
 		lua_createtable(L, 0, 4);
 
@@ -375,21 +790,46 @@ namespace gdbw::bindings
 
 	static int GetVMRegions(lua_State* L)
 	{
-		MEMORY_BASIC_INFORMATION64 mbi = { 0 };
-		std::vector<MemoryRegion*> regions(0);
+		pushregions(L, g_dbg->GetVMRegions());
+		return 1;
+	}
 
-		g_dbg->QueryVM(0, &mbi);
-		while (g_dbg->QueryVM(mbi.BaseAddress + mbi.RegionSize, &mbi))
-		{
-			if (mbi.State & MEM_COMMIT)
-				regions.push_back(new MemoryRegion(&mbi));
-		}
+	static int GetTargetGeneration(lua_State* L)
+	{
+		lua_pushinteger(L, g_dbg->GetGeneration());
+		return 1;
+	}
 
-		MemoryRegion::CreateMemoryRegionTable(L, regions);
+	static int RegionOf(lua_State* L)
+	{
+		size_t address = luaL_checkinteger(L, 1);
+		const RegionMap& regions = g_dbg->GetRegionMap();
+		ptrdiff_t index = regions.Find(address);
+		if (index < 0)
+			lua_pushnil(L);
+		else
+			pushregioninfo(L, regions, index);
+		return 1;
+	}
 
-		for (auto region : regions)
-			delete region;
+	static int RegionsOf(lua_State* L)
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		lua_Integer count = luaL_len(L, 1);
+		const RegionMap& regions = g_dbg->GetRegionMap();
 
+		// Parallel to the input table, addresses outside any committed region are left as nil
+		lua_createtable(L, (int)count, 0);
+		for (lua_Integer i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			ptrdiff_t index = lua_isinteger(L, -1) ? regions.Find(lua_tointeger(L, -1)) : -1;
+			lua_pop(L, 1);
+			if (index < 0)
+				continue;
+			pushregioninfo(L, regions, index);
+			lua_rawseti(L, -2, i);
+		}
 		return 1;
 	}
 
@@ -400,6 +840,221 @@ namespace gdbw::bindings
 		return 1;
 	}
 
+	static int SaveSnapshot(lua_State* L)
+	{
+		const char* path = luaL_checkstring(L, 1);
+
+		auto result = gdbw::SnapshotTarget::Save(*g_dbg->GetTarget(), path);
+		if (!result)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", result.error().c_str());
+			return 2;
+		}
+		return 0;
+	}
+
+	static int SearchMemory(lua_State* L)
+	{
+		// opts: type ("hex", "string", "wstring", "byte", "word", "dword", "qword"), start, end, limit, align
+		std::string type = "hex";
+		if (lua_istable(L, 2))
+		{
+			lua_getfield(L, 2, "type");
+			if (lua_isstring(L, -1))
+				type = lua_tostring(L, -1);
+			lua_pop(L, 1);
+		}
+		uint64_t start = (uint64_t)getfieldi(L, 2, "start", 0);
+		uint64_t end = (uint64_t)getfieldi(L, 2, "end", -1);
+		size_t limit = (size_t)getfieldi(L, 2, "limit", 0);
+		uint32_t alignment = (uint32_t)getfieldi(L, 2, "align", 1);
+
+		std::expected<BytePattern, std::string> pattern = std::unexpected(std::format("SearchMemory unknown pattern type '{}'", type));
+		size_t len = 0;
+		if (type == "hex")
+			pattern = BytePattern::FromHex(luaL_checkstring(L, 1));
+		else if (type == "string")
+		{
+			const char* str = luaL_checklstring(L, 1, &len);
+			pattern = BytePattern::FromBytes(str, len);
+		}
+		else if (type == "wstring")
+		{
+			const char* str = luaL_checklstring(L, 1, &len);
+			pattern = BytePattern::FromWide(std::string_view(str, len));
+		}
+		else if (type == "byte" || type == "word" || type == "dword" || type == "qword")
+		{
+			// Little endian, same as the target
+			uint64_t value = (uint64_t)luaL_checkinteger(L, 1);
+			size_t size = type == "byte" ? 1 : type == "word" ? 2 : type == "dword" ? 4 : 8;
+			pattern = BytePattern::FromBytes(&value, size);
+		}
+		if (!pattern)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", pattern.error().c_str());
+			return 2;
+		}
+		if (pattern->Size() == 0)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "SearchMemory empty pattern");
+			return 2;
+		}
+
+		// Readable committed memory within [start, end)
+		std::vector<SearchRange> ranges;
+		for (auto& region : g_dbg->GetVMRegions())
+		{
+			if ((region.Protections() & 0xFF) == PAGE_NOACCESS || (region.Protections() & PAGE_GUARD))
+				continue;
+			uint64_t first = std::max<uint64_t>(region.BaseAddress(), start);
+			uint64_t last = std::min<uint64_t>(region.BaseAddress() + region.Size(), end);
+			if (first < last)
+				ranges.push_back({ first, last - first });
+		}
+
+		ScanScheduler::Stats stats;
+		auto matches = MemorySearch::Search(*g_dbg->GetTarget(), ranges, *pattern, alignment, limit, &stats);
+		lua_createtable(L, (int)matches.size(), 0);
+		for (size_t i = 0; i < matches.size(); i++)
+		{
+			lua_pushinteger(L, matches[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+		pushscanstats(L, stats);
+		return 2;
+	}
+
+	static int FindPointerPaths(lua_State* L)
+	{
+		// opts: depth, offset, limit
+		uint64_t address = (uint64_t)luaL_checkinteger(L, 1);
+		PointerScan::Options options;
+		options.depth = (size_t)getfieldi(L, 2, "depth", options.depth);
+		options.offset = (uint32_t)getfieldi(L, 2, "offset", options.offset);
+		options.limit = (size_t)getfieldi(L, 2, "limit", options.limit);
+
+		// Pointers that can change at runtime are stored in writable memory, .data of images included
+		const RegionMap& regions = g_dbg->GetRegionMap();
+		std::vector<SearchRange> ranges;
+		for (auto& region : regions.Regions())
+		{
+			DWORD protect = region.Protections() & 0xFF;
+			if (region.Protections() & PAGE_GUARD)
+				continue;
+			if (protect == PAGE_READWRITE || protect == PAGE_WRITECOPY || protect == PAGE_EXECUTE_READWRITE || protect == PAGE_EXECUTE_WRITECOPY)
+				ranges.push_back({ region.BaseAddress(), region.Size() });
+		}
+
+		ScanScheduler::Stats stats;
+		auto index = PointerIndex::Build(*g_dbg->GetTarget(), regions, ranges, g_dbg->Is64BitTarget(), &stats);
+		auto paths = PointerScan::Find(index, regions, address, options);
+
+		lua_createtable(L, (int)paths.size(), 0);
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			const PointerPath& path = paths[i];
+			ptrdiff_t region = regions.Find(path.base);
+			lua_createtable(L, 0, 4);
+			setfieldi(L, "base", path.base);
+			lua_pushstring(L, regions.Module(region));
+			lua_setfield(L, -2, "module");
+			setfieldi(L, "moduleoffset", path.base - regions.Regions()[region].AllocationBase());
+			lua_createtable(L, (int)path.offsets.size(), 0);
+			for (size_t j = 0; j < path.offsets.size(); j++)
+			{
+				lua_pushinteger(L, path.offsets[j]);
+				lua_rawseti(L, -2, j + 1);
+			}
+			lua_setfield(L, -2, "offsets");
+			lua_rawseti(L, -2, i + 1);
+		}
+		pushscanstats(L, stats);
+		return 2;
+	}
+
+	static int FindStrings(lua_State* L)
+	{
+		// query: start, end, contains, limit
+		uint32_t minlength = (uint32_t)luaL_optinteger(L, 1, 4);
+		std::string encoding = luaL_optstring(L, 2, "all");
+		uint8_t encodings = encoding == "ascii" ? STRING_ASCII : encoding == "utf16" ? STRING_UTF16 : encoding == "all" ? STRING_ASCII | STRING_UTF16 : 0;
+		if (encodings == 0)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", std::format("FindStrings unknown encoding '{}'", encoding).c_str());
+			return 2;
+		}
+		uint64_t start = (uint64_t)getfieldi(L, 3, "start", 0);
+		uint64_t end = (uint64_t)getfieldi(L, 3, "end", -1);
+		size_t limit = (size_t)getfieldi(L, 3, "limit", 0);
+		std::string contains;
+		if (lua_istable(L, 3))
+		{
+			lua_getfield(L, 3, "contains");
+			if (lua_isstring(L, -1))
+				contains = lua_tostring(L, -1);
+			lua_pop(L, 1);
+		}
+
+		// Index every encoding at the shortest length asked for so far, later queries are served from it until
+		// the memory layout changes
+		StringIndex& index = g_dbg->GetStringIndex();
+		bool rebuilt = false;
+		ScanScheduler::Stats stats;
+		const RegionMap& regions = g_dbg->GetRegionMap();
+		if (!index.Covers(g_dbg->GetRegionGeneration(), minlength, encodings))
+		{
+			std::vector<SearchRange> ranges;
+			for (auto& region : regions.Regions())
+			{
+				if ((region.Protections() & 0xFF) == PAGE_NOACCESS || (region.Protections() & PAGE_GUARD))
+					continue;
+				ranges.push_back({ region.BaseAddress(), region.Size() });
+			}
+			index.Build(*g_dbg->GetTarget(), regions, ranges, g_dbg->GetRegionGeneration(), std::min<uint32_t>(minlength, 4),
+				STRING_ASCII | STRING_UTF16, &stats);
+			rebuilt = true;
+		}
+
+		// An index built at an earlier stop may hold strings that changed since, those are skipped. Reads go
+		// through the page cache, so checking costs about one read per page of results.
+		std::function<bool(const StringIndex::Entry&)> current;
+		if (!rebuilt)
+		{
+			auto read = [](uint64_t address, uint32_t len, void* out) -> std::expected<uint32_t, std::string> {
+				ULONG read = len;
+				auto result = g_dbg->ReadVM(address, &read, out);
+				if (!result)
+					return std::unexpected(result.error());
+				return read;
+			};
+			current = [&](const StringIndex::Entry& entry) { return index.Verify(entry, read); };
+		}
+		auto matches = index.Query(start, end, contains, minlength, encodings, limit, current);
+		lua_createtable(L, (int)matches.size(), 0);
+		for (size_t i = 0; i < matches.size(); i++)
+		{
+			const StringIndex::Entry& entry = *matches[i];
+			std::string_view text = index.Text(entry);
+			lua_createtable(L, 0, 3);
+			setfieldi(L, "address", entry.address);
+			lua_pushlstring(L, text.data(), text.size());
+			lua_setfield(L, -2, "string");
+			lua_pushstring(L, entry.encoding == STRING_UTF16 ? "utf16" : "ascii");
+			lua_setfield(L, -2, "encoding");
+			lua_rawseti(L, -2, i + 1);
+		}
+		if (rebuilt)
+			pushscanstats(L, stats);
+		else
+			lua_pushnil(L);
+		return 2;
+	}
+
 	static int StepInto(lua_State* L)
 	{
 		g_dbg->SetState(DE::State::STEP_INTO);
@@ -418,11 +1073,11 @@ namespace gdbw::bindings
 		ULONG len = (ULONG)luaL_checkinteger(L, 2);
 
 		unsigned char* out = (unsigned char*)calloc(len, 1);
-		auto result = g_dbg->ReadVMUncached(address, &len, out);
+		auto result = g_dbg->ReadVM(address, &len, out);
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			free(out);
 			return 2;
 		}
@@ -432,6 +1087,78 @@ namespace gdbw::bindings
 		return 1;
 	}
 
+	static int Telescope(lua_State* L)
+	{
+		size_t address = luaL_checkinteger(L, 1);
+		size_t count = luaL_checkinteger(L, 2);
+		size_t depth = luaL_optinteger(L, 3, 4);
+
+		// Every read goes through the page cache, chains usually land in pages that were already read
+		auto read = [](uint64_t address, uint32_t len, void* out) -> std::expected<uint32_t, std::string> {
+			ULONG bytesread = len;
+			auto result = g_dbg->ReadVM(address, &bytesread, out);
+			if (!result) return std::unexpected(result.error());
+			return (uint32_t)bytesread;
+		};
+		const RegionMap& regions = g_dbg->GetRegionMap();
+		auto entries = gdbw::Telescope::Walk(read, regions, g_dbg->Is64BitTarget(), address, count, depth);
+		if (!entries)
+		{
+			lua_pushnil(L);
+			luaL_error(L, "%s", entries.error().c_str());
+			return 2;
+		}
+
+		// Symbolize every value pointing into an image at once
+		std::vector<uint64_t> images;
+		for (auto& entry : *entries)
+			for (auto& hop : entry.hops)
+				if (hop.region >= 0 && regions.Kind(hop.region) == RegionKind::IMAGE)
+					images.push_back(hop.value);
+		std::sort(images.begin(), images.end());
+		images.erase(std::unique(images.begin(), images.end()), images.end());
+		std::vector<std::optional<Symbol>> symbols;
+		if (!images.empty())
+			symbols = g_dbg->SymbolsFromAddresses(images);
+
+		lua_createtable(L, (int)entries->size(), 0);
+		for (size_t i = 0; i < entries->size(); i++)
+		{
+			const TelescopeEntry& entry = (*entries)[i];
+			lua_createtable(L, 0, 2);
+			setfieldi(L, "address", entry.address);
+			lua_createtable(L, (int)entry.hops.size(), 0);
+			for (size_t j = 0; j < entry.hops.size(); j++)
+			{
+				const TelescopeHop& hop = entry.hops[j];
+				lua_createtable(L, 0, 4);
+				setfieldi(L, "value", hop.value);
+				if (hop.region >= 0)
+				{
+					pushregioninfo(L, regions, hop.region);
+					lua_setfield(L, -2, "region");
+				}
+				if (!hop.string.empty())
+				{
+					lua_pushlstring(L, hop.string.data(), hop.string.size());
+					lua_setfield(L, -2, "string");
+				}
+				auto symbol = std::lower_bound(images.begin(), images.end(), hop.value);
+				if (!symbols.empty() && symbol != images.end() && *symbol == hop.value && symbols[symbol - images.begin()])
+				{
+					const Symbol& resolved = *symbols[symbol - images.begin()];
+					std::string name = resolved.Displacement() ? std::format("{}+{:#x}", resolved.Name(), resolved.Displacement()) : resolved.Name();
+					lua_pushstring(L, name.c_str());
+					lua_setfield(L, -2, "symbol");
+				}
+				lua_rawseti(L, -2, j + 1);
+			}
+			lua_setfield(L, -2, "hops");
+			lua_rawseti(L, -2, i + 1);
+		}
+		return 1;
+	}
+
 	static int WriteMemory(lua_State* L)
 	{
 		size_t address = luaL_checkinteger(L, 1);
@@ -450,7 +1177,7 @@ namespace gdbw::bindings
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
@@ -467,29 +1194,15 @@ namespace gdbw::bindings
 			return 2;
 		}
 
-		auto result = g_dbg->GetSymbolManager()->SymbolFromName(symname);
+		auto result = g_dbg->GetTarget()->SymbolFromName(symname);
 		if (!result)
 		{
 			lua_pushnil(L);
-			luaL_error(L, result.error().c_str());
+			luaL_error(L, "%s", result.error().c_str());
 			return 2;
 		}
 
-		auto symbol = *result;
-		lua_createtable(L, 0, 5);
-
-		lua_pushinteger(L, symbol->Address());
-		lua_setfield(L, -2, "address");
-		lua_pushinteger(L, symbol->Displacement());
-		lua_setfield(L, -2, "displacement");
-		lua_pushinteger(L, symbol->Flags());
-		lua_setfield(L, -2, "flags");
-		lua_pushinteger(L, symbol->ModBase());
-		lua_setfield(L, -2, "modbase");
-		lua_pushlstring(L, symbol->Name(), strlen(symbol->Name()));
-		lua_setfield(L, -2, "name");
-		lua_pushinteger(L, symbol->Size());
-		lua_setfield(L, -2, "size");
+		pushsymbol(L, *result);
 
 		return 1;
 	}
@@ -0,0 +1,52 @@
+#include "BreakpointRegistry.hpp"
+
+gdbw::Breakpoint& gdbw::BreakpointRegistry::Add(PDEBUG_BREAKPOINT bp, uint64_t address, ULONG flags)
+{
+	ULONG id = NextId();
+	if (m_free.empty())
+		m_entries.emplace_back();
+	else
+		m_free.pop_back();
+
+	Breakpoint& entry = m_entries[id];
+	entry = Breakpoint();
+	entry.id = id;
+	entry.bp = bp;
+	entry.address = address;
+	entry.flags = flags;
+	m_addresses.emplace(address, id);
+	return entry;
+}
+
+void gdbw::BreakpointRegistry::Remove(ULONG id)
+{
+	Breakpoint* entry = Get(id);
+	if (!entry)
+		return;
+
+	auto [first, last] = m_addresses.equal_range(entry->address);
+	for (auto it = first; it != last; it++)
+	{
+		if (it->second == id)
+		{
+			m_addresses.erase(it);
+			break;
+		}
+	}
+	// Conditions & tracepoint buffers go with it
+	*entry = Breakpoint();
+	m_free.push_back(id);
+}
+
+void gdbw::BreakpointRegistry::Clear(void)
+{
+	m_entries.clear();
+	m_free.clear();
+	m_addresses.clear();
+}
+
+const gdbw::Breakpoint* gdbw::BreakpointRegistry::Find(uint64_t address) const
+{
+	auto it = m_addresses.find(address);
+	return it != m_addresses.end() ? &m_entries[it->second] : nullptr;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "Condition.hpp"
+#include "Platform.hpp"
+#include "Tracepoint.hpp"
+
+namespace gdbw
+{
+	// Everything the engine knows about a breakpoint
+	struct Breakpoint
+	{
+		ULONG id = 0;
+		PDEBUG_BREAKPOINT bp = nullptr; // nullptr while the slot is free
+		uint64_t address = 0;
+		ULONG flags = 0;                // DEBUG_BREAKPOINT_*, kept in sync by the engine
+		// Data breakpoints only, access is DEBUG_BREAK_* (0 for code breakpoints)
+		ULONG datasize = 0;
+		ULONG access = 0;
+		// Last value seen by a watch that only stops when the value changes
+		std::optional<uint64_t> value;
+		std::optional<Condition> condition;
+		std::optional<Tracepoint> tracepoint;
+		// Coverage block, one shot breakpoints record it & free their slot on the first hit
+		std::optional<uint32_t> block;
+	};
+
+	// Breakpoints by id with an address index. Ids of removed breakpoints go on a free list and are
+	// handed out again, so the table only grows to the most breakpoints alive at once. Entries live in
+	// a deque and keep their address for as long as their id is in use.
+	class BreakpointRegistry
+	{
+	public:
+		// Id the next Add will use
+		inline ULONG NextId(void) const { return m_free.empty() ? (ULONG)m_entries.size() : m_free.back(); }
+		// Register `bp` under NextId(), returns its entry
+		Breakpoint& Add(PDEBUG_BREAKPOINT bp, uint64_t address, ULONG flags);
+		// Drop a breakpoint, its id becomes free. The engine removes it from DbgEng first.
+		void Remove(ULONG id);
+		// Drop everything
+		void Clear(void);
+
+		// Get a breakpoint by id, nullptr if there's none
+		inline Breakpoint* Get(size_t id) { return id < m_entries.size() && m_entries[id].bp ? &m_entries[id] : nullptr; }
+		inline const Breakpoint* Get(size_t id) const { return id < m_entries.size() && m_entries[id].bp ? &m_entries[id] : nullptr; }
+		// Get a breakpoint at `address`, nullptr if there's none
+		const Breakpoint* Find(uint64_t address) const;
+		// Get a breakpoint at `address` matching `pred`, nullptr if there's none
+		template <typename F>
+		const Breakpoint* Find(uint64_t address, F pred) const
+		{
+			auto [first, last] = m_addresses.equal_range(address);
+			for (auto it = first; it != last; it++)
+				if (pred(m_entries[it->second]))
+					return &m_entries[it->second];
+			return nullptr;
+		}
+		inline size_t Size(void) const { return m_entries.size() - m_free.size(); }
+
+		// Call `fn` with every breakpoint in id order
+		template <typename F>
+		void ForEach(F fn) const
+		{
+			for (auto& entry : m_entries)
+				if (entry.bp)
+					fn(entry);
+		}
+	private:
+		std::deque<Breakpoint> m_entries; // indexed by id
+		std::vector<ULONG> m_free;
+		std::unordered_multimap<uint64_t, ULONG> m_addresses;
+	};
+}
@@ -0,0 +1,348 @@
+#include "Condition.hpp"
+
+namespace
+{
+	// Deepest the evaluation stack may get, plenty for anything typed at a prompt
+	constexpr size_t MaxStack = 64;
+}
+
+// Recursive descent parser emitting code as it goes, one method per precedence level
+class gdbw::Condition::Parser
+{
+public:
+	Parser(std::string_view text, Condition& out) : m_text(text), m_out(out) {}
+
+	std::expected<bool, std::string> Parse(void)
+	{
+		auto result = Binary(0);
+		if (!result)
+			return result;
+		SkipSpace();
+		if (m_pos != m_text.size())
+			return Error("unexpected input");
+		return true;
+	}
+private:
+	// Binary operators from lowest to highest precedence, longer operators first within a level
+	struct Operator
+	{
+		std::string_view token;
+		Op op;
+	};
+	static constexpr size_t Levels = 10;
+	static constexpr Operator Operators[Levels][4] = {
+		{ { "||", Op::JNZ } },
+		{ { "&&", Op::JZ } },
+		{ { "|", Op::OR } },
+		{ { "^", Op::XOR } },
+		{ { "&", Op::AND } },
+		{ { "==", Op::EQ }, { "!=", Op::NE } },
+		{ { "<=", Op::LE }, { ">=", Op::GE }, { "<", Op::LT }, { ">", Op::GT } },
+		{ { "<<", Op::SHL }, { ">>", Op::SHR } },
+		{ { "+", Op::ADD }, { "-", Op::SUB } },
+		{ { "*", Op::MUL }, { "/", Op::DIV }, { "%", Op::MOD } },
+	};
+
+	std::unexpected<std::string> Error(std::string_view what)
+	{
+		return std::unexpected(std::format("Condition {} at column {}: {}", what, m_pos + 1, m_text));
+	}
+
+	void SkipSpace(void)
+	{
+		while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t'))
+			m_pos++;
+	}
+
+	// Consume `token` unless it's the start of a longer operator (e.g. & of &&, < of <<)
+	bool Match(std::string_view token)
+	{
+		SkipSpace();
+		if (m_text.substr(m_pos, token.size()) != token)
+			return false;
+		if (token.size() == 1 && m_pos + 1 < m_text.size())
+		{
+			char next = m_text[m_pos + 1];
+			char c = token[0];
+			if ((c == '&' || c == '|' || c == '<' || c == '>') && next == c)
+				return false;
+			if ((c == '<' || c == '>' || c == '!') && next == '=')
+				return false;
+		}
+		m_pos += token.size();
+		return true;
+	}
+
+	void Emit(Op op, uint8_t size = 0, uint32_t index = 0, uint64_t value = 0)
+	{
+		m_out.m_code.push_back({ op, size, index, value });
+		if (op == Op::PUSH || op == Op::REG)
+			m_depth++;
+		else if (op >= Op::MUL && op <= Op::JNZ)
+			m_depth--; // binary operators, and the fall through of a short circuit jump
+		m_out.m_stack = std::max(m_out.m_stack, m_depth);
+	}
+
+	std::expected<bool, std::string> Binary(size_t level)
+	{
+		if (level == Levels)
+			return Unary();
+		auto result = Binary(level + 1);
+		if (!result)
+			return result;
+
+		while (true)
+		{
+			const Operator* matched = nullptr;
+			for (auto& op : Operators[level])
+			{
+				if (!op.token.empty() && Match(op.token))
+				{
+					matched = &op;
+					break;
+				}
+			}
+			if (!matched)
+				return true;
+
+			if (matched->op == Op::JZ || matched->op == Op::JNZ)
+			{
+				size_t jump = m_out.m_code.size();
+				Emit(matched->op);
+				result = Binary(level + 1);
+				if (!result)
+					return result;
+				Emit(Op::BOOL);
+				m_out.m_code[jump].index = (uint32_t)m_out.m_code.size();
+				continue;
+			}
+			result = Binary(level + 1);
+			if (!result)
+				return result;
+			Emit(matched->op);
+		}
+	}
+
+	std::expected<bool, std::string> Unary(void)
+	{
+		if (++m_nesting > MaxStack)
+			return Error("nested too deeply");
+		std::expected<bool, std::string> result = true;
+		if (Match("!"))
+		{
+			result = Unary();
+			Emit(Op::NOT);
+		}
+		else if (Match("~"))
+		{
+			result = Unary();
+			Emit(Op::BNOT);
+		}
+		else if (Match("-"))
+		{
+			result = Unary();
+			Emit(Op::NEG);
+		}
+		else if (Match("+"))
+			result = Unary();
+		else
+			result = Primary();
+		m_nesting--;
+		return result;
+	}
+
+	// [expr] with the size already known
+	std::expected<bool, std::string> Dereference(uint8_t size, char close)
+	{
+		auto result = Binary(0);
+		if (!result)
+			return result;
+		if (!Match(std::string_view(&close, 1)))
+			return Error(std::format("expected '{}'", std::string(1, close)));
+		Emit(Op::READ, size);
+		return true;
+	}
+
+	std::expected<bool, std::string> Primary(void)
+	{
+		uint8_t pointer = m_out.m_set == DE::RegisterSet::GP64 ? 8 : 4;
+		if (Match("("))
+		{
+			auto result = Binary(0);
+			if (!result)
+				return result;
+			if (!Match(")"))
+				return Error("expected ')'");
+			return true;
+		}
+		if (Match("["))
+			return Dereference(pointer, ']');
+
+		SkipSpace();
+		size_t start = m_pos;
+		while (m_pos < m_text.size() && (isalnum((unsigned char)m_text[m_pos]) || m_text[m_pos] == '_' || m_text[m_pos] == '`'))
+			m_pos++;
+		std::string word(m_text.substr(start, m_pos - start));
+		if (word.empty())
+			return Error("expected a value");
+		for (auto& c : word)
+			c = (char)tolower((unsigned char)c);
+
+		// Sized reads, windbg's poi() is a pointer sized one
+		static constexpr std::pair<std::string_view, uint8_t> sizes[] = { { "byte", 1 }, { "word", 2 }, { "dword", 4 }, { "qword", 8 } };
+		for (auto& [name, size] : sizes)
+		{
+			if (word == name && Match("["))
+				return Dereference(size, ']');
+		}
+		if (word == "poi" && Match("("))
+			return Dereference(pointer, ')');
+
+		// Registers of the set, plus the low halves on x64 (the 32 bit set uses the same order)
+		const char* const* names = nullptr;
+		size_t count = DE::GetRegisterSetNames(m_out.m_set, &names);
+		for (size_t i = 0; i < count; i++)
+		{
+			if (word == names[i])
+			{
+				Emit(Op::REG, 8, (uint32_t)i);
+				return true;
+			}
+		}
+		if (m_out.m_set == DE::RegisterSet::GP64)
+		{
+			count = DE::GetRegisterSetNames(DE::RegisterSet::GP32, &names);
+			for (size_t i = 0; i < count; i++)
+			{
+				if (word == names[i])
+				{
+					Emit(Op::REG, 4, (uint32_t)i);
+					return true;
+				}
+			}
+		}
+
+		// Numbers, hex unless prefixed with 0n. ` separators are allowed (e.g. 00007ff6`12340000)
+		std::erase(word, '`');
+		int base = 16;
+		std::string_view digits = word;
+		if (digits.starts_with("0x"))
+			digits.remove_prefix(2);
+		else if (digits.starts_with("0n"))
+		{
+			digits.remove_prefix(2);
+			base = 10;
+		}
+		uint64_t value = 0;
+		auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, base);
+		if (digits.empty() || ec != std::errc() || ptr != digits.data() + digits.size())
+		{
+			m_pos = start;
+			return Error(std::format("unknown register or number '{}'", word));
+		}
+		Emit(Op::PUSH, 0, 0, value);
+		return true;
+	}
+
+	std::string_view m_text;
+	Condition& m_out;
+	size_t m_pos = 0;
+	size_t m_depth = 0;
+	size_t m_nesting = 0;
+};
+
+std::expected<gdbw::Condition, std::string> gdbw::Condition::Compile(std::string_view expression, DE::RegisterSet set)
+{
+	Condition condition;
+	condition.m_expression = std::string(expression);
+	condition.m_set = set;
+	Parser parser(expression, condition);
+	auto result = parser.Parse();
+	if (!result)
+		return std::unexpected(result.error());
+	if (condition.m_stack > MaxStack)
+		return std::unexpected(std::format("Condition too complex: {}", expression));
+	return condition;
+}
+
+std::expected<uint64_t, std::string> gdbw::Condition::Evaluate(const DE::RegisterContext& registers, const ReadFunction& read) const
+{
+	if (registers.set != m_set)
+		return std::unexpected("Condition compiled for a different register set");
+
+	uint64_t stack[MaxStack];
+	size_t sp = 0;
+	size_t pc = 0;
+	while (pc < m_code.size())
+	{
+		const Instruction& ins = m_code[pc++];
+		if (ins.op == Op::PUSH)
+		{
+			stack[sp++] = ins.value;
+			continue;
+		}
+		if (ins.op == Op::REG)
+		{
+			stack[sp++] = ins.size == 4 ? (uint32_t)registers.values[ins.index] : registers.values[ins.index];
+			continue;
+		}
+
+		uint64_t b = 0;
+		if (ins.op >= Op::MUL && ins.op <= Op::OR)
+			b = stack[--sp];
+		uint64_t& top = stack[sp - 1];
+		switch (ins.op)
+		{
+		case Op::READ:
+		{
+			uint64_t value = 0;
+			auto result = read(top, ins.size, &value);
+			if (!result || *result != ins.size)
+				return std::unexpected(std::format("Condition failed to read memory at {:#x}", top));
+			top = value;
+			break;
+		}
+		case Op::NOT: top = !top; break;
+		case Op::BNOT: top = ~top; break;
+		case Op::NEG: top = 0 - top; break;
+		case Op::MUL: top *= b; break;
+		case Op::DIV:
+		case Op::MOD:
+			if (b == 0)
+				return std::unexpected(std::format("Condition division by zero: {}", m_expression));
+			top = ins.op == Op::DIV ? top / b : top % b;
+			break;
+		case Op::ADD: top += b; break;
+		case Op::SUB: top -= b; break;
+		case Op::SHL: top = b < 64 ? top << b : 0; break;
+		case Op::SHR: top = b < 64 ? top >> b : 0; break;
+		case Op::LT: top = top < b; break;
+		case Op::LE: top = top <= b; break;
+		case Op::GT: top = top > b; break;
+		case Op::GE: top = top >= b; break;
+		case Op::EQ: top = top == b; break;
+		case Op::NE: top = top != b; break;
+		case Op::AND: top &= b; break;
+		case Op::XOR: top ^= b; break;
+		case Op::OR: top |= b; break;
+		case Op::JZ:
+			if (top == 0)
+				pc = ins.index;
+			else
+				sp--;
+			break;
+		case Op::JNZ:
+			if (top != 0)
+			{
+				top = 1;
+				pc = ins.index;
+			}
+			else
+				sp--;
+			break;
+		case Op::BOOL: top = top != 0; break;
+		default: break; // PUSH & REG are handled above
+		}
+	}
+	return sp == 1 ? stack[0] : 0;
+}
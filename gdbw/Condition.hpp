@@ -0,0 +1,64 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Registers.hpp"
+
+namespace gdbw
+{
+	// Breakpoint condition compiled once into stack machine code, e.g. `rcx == 0x10 && [rdx+8] > 4`.
+	// Operators and precedence follow C, && and || short circuit. Numbers are hex like windbg's default
+	// radix (0n prefix for decimal). [x] reads a pointer sized value, byte/word/dword/qword [x] a sized one.
+	// On x64 targets the 32 bit register names read the low half of their 64 bit register.
+	class Condition
+	{
+	public:
+		// Reads `len` bytes at `address` into `out`, returns the number of bytes read
+		using ReadFunction = std::function<std::expected<uint32_t, std::string>(uint64_t address, uint32_t len, void* out)>;
+
+		static std::expected<Condition, std::string> Compile(std::string_view expression, DE::RegisterSet set);
+
+		// Evaluate against the registers of a stop, memory is only read when an operand needs it
+		std::expected<uint64_t, std::string> Evaluate(const DE::RegisterContext& registers, const ReadFunction& read) const;
+
+		inline const std::string& Expression(void) const { return m_expression; }
+		inline DE::RegisterSet Set(void) const { return m_set; }
+	private:
+		enum class Op : uint8_t
+		{
+			PUSH, REG, READ,
+			NOT, BNOT, NEG,
+			MUL, DIV, MOD, ADD, SUB, SHL, SHR,
+			LT, LE, GT, GE, EQ, NE,
+			AND, XOR, OR,
+			// Short circuit: leave the result of the left operand & jump if it decides the outcome, else pop it
+			JZ, JNZ,
+			BOOL
+		};
+
+		struct Instruction
+		{
+			Op op;
+			uint8_t size;    // READ: bytes to read, REG: 4 for the low half
+			uint32_t index;  // REG: register index, JZ/JNZ: target instruction
+			uint64_t value;  // PUSH
+		};
+
+		class Parser;
+
+		Condition() = default;
+
+		std::vector<Instruction> m_code;
+		size_t m_stack = 0; // deepest the stack gets
+		std::string m_expression;
+		DE::RegisterSet m_set = DE::RegisterSet::GP64;
+	};
+}
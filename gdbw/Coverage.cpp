@@ -0,0 +1,153 @@
+#include "Coverage.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+template <typename T>
+static T Field(const std::vector<uint8_t>& buffer, size_t offset)
+{
+	T value{};
+	if (offset + sizeof(T) <= buffer.size())
+		std::memcpy(&value, buffer.data() + offset, sizeof(T));
+	return value;
+}
+
+std::expected<uint16_t, std::string> gdbw::Coverage::AddModule(uint64_t base, uint64_t size, const std::string& path)
+{
+	for (size_t i = 0; i < m_modules.size(); i++)
+	{
+		if (m_modules[i].base == base)
+			return (uint16_t)i;
+	}
+	if (m_modules.size() > std::numeric_limits<uint16_t>::max())
+		return std::unexpected("Coverage.AddModule too many modules");
+	m_modules.push_back({ base, size, path });
+	return (uint16_t)(m_modules.size() - 1);
+}
+
+uint32_t gdbw::Coverage::AddBlock(uint16_t module, uint32_t offset, uint32_t size)
+{
+	uint32_t block = (uint32_t)m_blocks.size();
+	m_blocks.push_back({ offset, size, module });
+	m_hits.resize((m_blocks.size() + 63) / 64);
+	m_index.emplace((uint64_t)module << 32 | offset, block);
+	return block;
+}
+
+std::optional<uint32_t> gdbw::Coverage::Find(uint16_t module, uint32_t offset) const
+{
+	auto it = m_index.find((uint64_t)module << 32 | offset);
+	if (it == m_index.end())
+		return std::nullopt;
+	return it->second;
+}
+
+size_t gdbw::Coverage::Hits(void) const
+{
+	size_t hits = 0;
+	for (uint64_t word : m_hits)
+		hits += std::popcount(word);
+	return hits;
+}
+
+void gdbw::Coverage::Clear(void)
+{
+	m_modules.clear();
+	m_blocks.clear();
+	m_hits.clear();
+	m_index.clear();
+}
+
+std::expected<bool, std::string> gdbw::Coverage::WriteDrcov(const std::string& path) const
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return std::unexpected(std::format("Coverage.WriteDrcov failed to open {}", path));
+
+	out << "DRCOV VERSION: 2\nDRCOV FLAVOR: drcov\n";
+	out << std::format("Module Table: version 2, count {}\n", m_modules.size());
+	out << "Columns: id, base, end, entry, checksum, timestamp, path\n";
+	for (size_t i = 0; i < m_modules.size(); i++)
+	{
+		auto& module = m_modules[i];
+		out << std::format("{:3}, {:#018x}, {:#018x}, {:#018x}, {:#010x}, {:#010x}, {}\n",
+			i, module.base, module.base + module.size, 0, 0, 0, module.path);
+	}
+
+	out << std::format("BB Table: {} bbs\n", Hits());
+	for (size_t i = 0; i < m_blocks.size(); i++)
+	{
+		if (!IsHit((uint32_t)i))
+			continue;
+		// drcov sizes are 16 bit, a whole function is reported as its first 64K
+		struct { uint32_t start; uint16_t size; uint16_t module; } entry = {
+			m_blocks[i].offset, (uint16_t)std::clamp<uint32_t>(m_blocks[i].size, 1, 0xffff), m_blocks[i].module };
+		out.write((const char*)&entry, sizeof(entry));
+	}
+
+	if (!out)
+		return std::unexpected(std::format("Coverage.WriteDrcov failed writing {}", path));
+	return true;
+}
+
+std::expected<std::vector<gdbw::Coverage::Block>, std::string> gdbw::Coverage::ImageFunctions(Target& target, uint64_t base)
+{
+	// Headers fit in the first page
+	std::vector<uint8_t> headers(0x1000);
+	auto read = target.ReadMemory(base, (uint32_t)headers.size(), headers.data());
+	if (!read)
+		return std::unexpected(read.error());
+	headers.resize(*read);
+	if (Field<uint16_t>(headers, 0) != 0x5a4d)
+		return std::unexpected(std::format("No image at {:#x}", base));
+
+	uint32_t nt = Field<uint32_t>(headers, 0x3c);
+	if (Field<uint32_t>(headers, nt) != 0x4550)
+		return std::unexpected(std::format("Image at {:#x} has no PE header", base));
+	size_t optional = nt + 24;
+	bool pe32plus = Field<uint16_t>(headers, optional) == 0x20b;
+	uint32_t entry = Field<uint32_t>(headers, optional + 16);
+	uint32_t imagesize = Field<uint32_t>(headers, optional + 56);
+	uint32_t directories = Field<uint32_t>(headers, optional + (pe32plus ? 108 : 92));
+	size_t exception = optional + (pe32plus ? 112 : 96) + 3 * 8;
+
+	std::vector<Block> functions;
+	if (directories > 3)
+	{
+		uint32_t rva = Field<uint32_t>(headers, exception);
+		uint32_t size = Field<uint32_t>(headers, exception + 4);
+		if (rva && size && (uint64_t)rva + size <= imagesize)
+		{
+			// RUNTIME_FUNCTION { u32 begin u32 end u32 unwind }
+			std::vector<uint32_t> table(size / 12 * 3);
+			size_t done = 0;
+			size_t bytes = table.size() * sizeof(uint32_t);
+			while (done < bytes)
+			{
+				auto result = target.ReadMemory(base + rva + done, (uint32_t)(bytes - done), (uint8_t*)table.data() + done);
+				if (!result)
+					return std::unexpected(result.error());
+				if (*result == 0)
+					return std::unexpected(std::format("Coverage.ImageFunctions failed to read the exception directory at {:#x}", base + rva + done));
+				done += *result;
+			}
+
+			functions.reserve(table.size() / 3 + 1);
+			for (size_t i = 0; i < table.size(); i += 3)
+			{
+				uint32_t begin = table[i];
+				uint32_t end = table[i + 1];
+				if (begin < end && end <= imagesize)
+					functions.push_back({ begin, end - begin, 0 });
+			}
+		}
+	}
+	if (entry && entry < imagesize)
+		functions.push_back({ entry, 1, 0 });
+
+	// Chained unwind entries & the entry point can repeat a start
+	std::sort(functions.begin(), functions.end(), [](const Block& a, const Block& b) { return a.offset < b.offset || (a.offset == b.offset && a.size > b.size); });
+	functions.erase(std::unique(functions.begin(), functions.end(), [](const Block& a, const Block& b) { return a.offset == b.offset; }), functions.end());
+	return functions;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Block coverage of one or more modules, hits are a bitmap over the blocks. Filled by one shot
+	// breakpoints, one per block, that record the hit and remove themselves the first time they execute.
+	//
+	// Written in drcov (version 2) format: a text header & module table followed by
+	//   "BB Table: N bbs\n" { u32 start (module offset) u16 size u16 module id }[N]
+	// holding only the blocks that were hit.
+	class Coverage
+	{
+	public:
+		struct Module
+		{
+			uint64_t base;
+			uint64_t size;
+			std::string path;
+		};
+		struct Block
+		{
+			uint32_t offset; // from the module base
+			uint32_t size;
+			uint16_t module;
+		};
+
+		// Add a module (or get the id of an already added one at `base`)
+		std::expected<uint16_t, std::string> AddModule(uint64_t base, uint64_t size, const std::string& path);
+		// Add a block of `module`, returns its index
+		uint32_t AddBlock(uint16_t module, uint32_t offset, uint32_t size);
+		// Index of the block of `module` at `offset`, if it was added
+		std::optional<uint32_t> Find(uint16_t module, uint32_t offset) const;
+		inline void Hit(uint32_t block) { m_hits[block >> 6] |= 1ull << (block & 63); }
+		inline bool IsHit(uint32_t block) const { return m_hits[block >> 6] & (1ull << (block & 63)); }
+		// Blocks hit so far
+		size_t Hits(void) const;
+		void Clear(void);
+
+		std::expected<bool, std::string> WriteDrcov(const std::string& path) const;
+
+		inline const std::vector<Module>& Modules(void) const { return m_modules; }
+		inline const std::vector<Block>& Blocks(void) const { return m_blocks; }
+
+		// Function starts & sizes of the image at `base` from its exception directory (x64 .pdata), plus
+		// the entry point. Empty for images without one (e.g. x86), use symbols there instead.
+		static std::expected<std::vector<Block>, std::string> ImageFunctions(Target& target, uint64_t base);
+	private:
+		std::vector<Module> m_modules;
+		std::vector<Block> m_blocks;
+		std::vector<uint64_t> m_hits; // bit per block
+		std::unordered_map<uint64_t, uint32_t> m_index; // module << 32 | offset -> block
+	};
+}
@@ -1,13 +1,58 @@
 #include "DebugEngine.hpp"
 
-gdbw::DE::Engine::~Engine()
+#ifndef _WIN32
+// Off Windows everything goes through the target given to SetTarget
+static constexpr const char* NoSession = "No target set, DbgEng sessions are only available on Windows";
+#endif
+
+#ifdef _WIN32
+HRESULT gdbw::DE::EventCallbacks::LoadModule(
+	ULONG64 imagehandle, ULONG64 baseoffset, ULONG modulesize,
+	PCSTR ModuleName, PCSTR imagename, ULONG checksum, ULONG timestamp)
 {
-	// remove breakpoints (only freed once RemoveBreakpoint is called)
-	for (auto bp : m_breakpoints)
+	m_engine->OnModuleChange(baseoffset, modulesize);
+	return DEBUG_STATUS_NO_CHANGE;
+}
+
+HRESULT gdbw::DE::EventCallbacks::Breakpoint(PDEBUG_BREAKPOINT bp)
+{
+	ULONG id = 0;
+	auto hr = bp->GetId(&id);
+	// Just want to warn, not exit. This should never be hit - if it is there's
+	// an issue with the [Add/Remove]Breakpoint bindings
+	if (FAILED(hr))
 	{
-		if (bp != nullptr)
-			m_control->RemoveBreakpoint(bp);
+		std::println("Warning: Failed to get breakpoint id, hr={:#x}", hr);
+		return DEBUG_STATUS_NO_CHANGE;
 	}
+	return m_engine->OnBreakpoint(id);
+}
+
+HRESULT gdbw::DE::EventCallbacks::UnloadModule(PCSTR imagename, ULONG64 baseoffset)
+{
+	// Size isn't given on unload
+	m_engine->OnModuleChange(baseoffset, 0);
+	return DEBUG_STATUS_NO_CHANGE;
+}
+
+HRESULT gdbw::DE::EventCallbacks::CreateThread(ULONG64 handle, ULONG64 dataoffset, ULONG64 startoffset)
+{
+	m_engine->OnThreadChange();
+	return DEBUG_STATUS_NO_CHANGE;
+}
+
+HRESULT gdbw::DE::EventCallbacks::ExitThread(ULONG exitcode)
+{
+	m_engine->OnThreadChange();
+	return DEBUG_STATUS_NO_CHANGE;
+}
+#endif
+
+gdbw::DE::Engine::~Engine()
+{
+#ifdef _WIN32
+	// remove breakpoints (only freed once RemoveBreakpoint is called)
+	m_breakpoints.ForEach([this](const Breakpoint& entry) { m_control->RemoveBreakpoint(entry.bp); });
 
 	// end debug session
 	if (m_client)
@@ -55,7 +100,15 @@ gdbw::DE::Engine::~Engine()
 
 	if (m_symmanager)
 		delete m_symmanager;
+#endif
+
+	if (m_pagecache)
+		delete m_pagecache;
 
+	if (m_disassembler)
+		delete m_disassembler;
+
+#ifdef _WIN32
 	// release client
 	if (m_client)
 	{
@@ -63,18 +116,19 @@ gdbw::DE::Engine::~Engine()
 		m_client = nullptr;
 	}
 
-	// remove lua reference
-	if (m_lua) m_lua = nullptr;
-
 	if (m_hdebuggee)
 		CloseHandle(m_hdebuggee);
+#endif
+
+	// remove lua reference
+	if (m_lua) m_lua = nullptr;
 }
 
+#ifdef _WIN32
 std::expected<bool, std::string> gdbw::DE::Engine::Init(gdbw::LuaManager* lua)
 {
-	m_lua = lua;
-
-	m_breakpoints = std::vector<PDEBUG_BREAKPOINT>(0);
+	auto offline_result = InitOffline(lua);
+	if (!offline_result) return offline_result;
 
 	HRESULT hr;
 	hr = DebugCreate(__uuidof(IDebugClient), (void**)&m_client);
@@ -96,7 +150,7 @@ std::expected<bool, std::string> gdbw::DE::Engine::Init(gdbw::LuaManager* lua)
 	RTN_IF_ERR_HR(hr, "QueryInterface[IDebugSystemObjects4]");
 
 	// Setup client event callbacks
-	m_eventcallbacks = new EventCallbacks();
+	m_eventcallbacks = new EventCallbacks(this);
 	hr = m_client->SetEventCallbacks(m_eventcallbacks);
 	RTN_IF_ERR_HR(hr, "SetEventCallbacks");
 	
@@ -110,7 +164,28 @@ std::expected<bool, std::string> gdbw::DE::Engine::Init(gdbw::LuaManager* lua)
 	
 	return true;
 }
+#endif
+
+std::expected<bool, std::string> gdbw::DE::Engine::InitOffline(gdbw::LuaManager* lua)
+{
+	m_lua = lua;
 
+	m_breakpoints.Clear();
+
+	// All reads made while the target is suspended are served from here, see ReadVM
+	m_pagecache = new PageCache([this](uint64_t address, uint32_t len, void* out) -> std::expected<uint32_t, std::string> {
+		ULONG bytesread = len;
+		auto result = ReadVMUncached(address, &bytesread, out);
+		if (!result) return std::unexpected(result.error());
+		return (uint32_t)bytesread;
+	});
+
+	// Capstone handles are kept open for the whole session, mode is synced on every event
+	m_disassembler = new Disassembler(cs_arch::CS_ARCH_X86, cs_mode::CS_MODE_64);
+	return true;
+}
+
+#ifdef _WIN32
 std::expected<bool, std::string> gdbw::DE::Engine::Attach(DWORD pid, bool break_on_entry)
 {
 	HRESULT hr;
@@ -154,9 +229,69 @@ std::expected<bool, std::string> gdbw::DE::Engine::EnterDebugLoop(void)
 	}
 	return true;
 }
+#endif
+
+std::expected<bool, std::string> gdbw::DE::Engine::EnterTargetLoop(void)
+{
+	while (true)
+	{
+		m_state = State::SUSPEND;
+		while (m_state == State::SUSPEND)
+			if (m_lua->Prompt()) break;
+		if (m_state == State::STOP)
+			return true;
+
+		// Targets only single step, step over runs a call to its return address instead
+		bool step = m_state == State::STEP_INTO || m_state == State::STEP_OVER;
+		std::optional<uint64_t> callreturn = m_state == State::STEP_OVER ? CallReturnAddress() : std::nullopt;
+		InvalidateTargetState();
+		m_state = State::RUN;
+		auto stop = callreturn ? m_target->RunTo(*callreturn) : step ? m_target->StepInto() : m_target->Continue();
+		if (!stop)
+		{
+			// e.g. a dump can't run, let the user keep inspecting it
+			std::println("{}", stop.error());
+			continue;
+		}
+		if (*stop < 0)
+		{
+			std::println("Target exited");
+			return true;
+		}
+	}
+}
+
+std::optional<uint64_t> gdbw::DE::Engine::CallReturnAddress(void)
+{
+	auto context = m_target->GetRegisters(m_target->Is64Bit() ? RegisterSet::GP64 : RegisterSet::GP32);
+	if (!context)
+		return std::nullopt;
+	uint64_t pc = context->values[6]; // rip/eip
+
+	uint8_t code[16] = { 0 };
+	ULONG len = sizeof(code);
+	if (!ReadVM(pc, &len, code))
+		return std::nullopt;
+	InstructionBatch& insns = m_disassembler->ScratchBatch();
+	auto decoded = m_disassembler->Disasm(code, len, 1, insns, pc);
+	if (!decoded || *decoded != 1 || strncmp(insns.Mnemonic(insns[0]), "call", 4) != 0)
+		return std::nullopt;
+	return pc + insns[0].size;
+}
 
 std::expected<std::string, std::string> gdbw::DE::Engine::AddressToModule(ULONG64 address)
 {
+	// Other targets name their image regions through the region map
+	if (m_target != this)
+	{
+		const RegionMap& regions = GetRegionMap();
+		ptrdiff_t index = regions.Find(address);
+		if (index < 0 || *regions.Module(index) == 0)
+			return std::unexpected("Could not locate module containing the specified address");
+		return std::string(regions.Module(index));
+	}
+
+#ifdef _WIN32
 	ULONG64 modbase = 0;
 	auto hr = m_symbols->GetModuleByOffset(address, 0, NULL, &modbase);
 	RTN_IF_ERR_HR(hr, "Could not locate module containing the specified address");
@@ -166,108 +301,953 @@ std::expected<std::string, std::string> gdbw::DE::Engine::AddressToModule(ULONG6
 		return std::unexpected("Failed to retrieve specified module name");
 	std::string result = imagename;
 	return result;
+#else
+	return std::unexpected(NoSession);
+#endif
 }
 
-std::expected<ULONG, std::string> gdbw::DE::Engine::BreakpointAdd(size_t address)
+std::vector<std::optional<gdbw::Symbol>> gdbw::DE::Engine::SymbolsFromAddresses(const std::vector<uint64_t>& addresses)
 {
+#ifdef _WIN32
+	// DbgHelp resolves a batch in one pass
+	if (m_target == this)
+	{
+		if (m_symmanager == nullptr)
+			return std::vector<std::optional<Symbol>>(addresses.size());
+		return m_symmanager->SymbolsFromAddresses(addresses);
+	}
+#endif
+
+	std::vector<std::optional<Symbol>> symbols;
+	symbols.reserve(addresses.size());
+	for (uint64_t address : addresses)
+	{
+		auto symbol = m_target->SymbolFromAddress(address);
+		symbols.push_back(symbol ? std::optional<Symbol>(*symbol) : std::nullopt);
+	}
+	return symbols;
+}
+
+#ifdef _WIN32
+std::expected<gdbw::Symbol, std::string> gdbw::DE::Engine::SymbolFromAddress(uint64_t address)
+{
+	// No symbol manager until the first event
+	if (m_symmanager == nullptr)
+		return std::unexpected("Symbols not available for the current target");
+	return m_symmanager->SymbolFromAddress(address);
+}
+
+std::expected<gdbw::Symbol, std::string> gdbw::DE::Engine::SymbolFromName(const std::string& name)
+{
+	if (m_symmanager == nullptr)
+		return std::unexpected("Symbols not available for the current target");
+	return m_symmanager->SymbolFromName(name.c_str());
+}
+#endif
+
+std::expected<ULONG, std::string> gdbw::DE::Engine::BreakpointAdd(size_t address, bool* created)
+{
+	if (created)
+		*created = false;
+
+	// Other targets manage their own breakpoints
+	if (m_target != this)
+	{
+		if (auto existing = m_target->FindBreakpoint(address))
+			return *existing;
+		auto id = m_target->SetBreakpoint(address);
+		if (id && created)
+			*created = true;
+		return id;
+	}
+
+	// Like the other backends, a second breakpoint at an address gets the existing id. Watches &
+	// pending coverage breakpoints there don't count, the latter go away on their first hit.
+	const Breakpoint* existing = m_breakpoints.Find(address, [](const Breakpoint& entry) { return !entry.datasize && !entry.block; });
+	if (existing)
+		return existing->id;
+
+	auto bp = CreateBreakpoint(address, 0);
+	if (!bp)
+		return std::unexpected(bp.error());
+	if (created)
+		*created = true;
+	return (*bp)->id;
+}
+
+std::expected<gdbw::Breakpoint*, std::string> gdbw::DE::Engine::CreateBreakpoint(uint64_t address, ULONG flags, ULONG datasize, ULONG access)
+{
+#ifdef _WIN32
+	// Ids of removed breakpoints are reused, the registry only grows with the number alive at once
 	PDEBUG_BREAKPOINT bp = nullptr;
-	ULONG desired_id = m_breakpoints.size();
-	
-	auto hr = m_control->AddBreakpoint(DEBUG_BREAKPOINT_CODE, desired_id, &bp);
+	ULONG desired_id = m_breakpoints.NextId();
+
+	auto hr = m_control->AddBreakpoint(datasize ? DEBUG_BREAKPOINT_DATA : DEBUG_BREAKPOINT_CODE, desired_id, &bp);
 	RTN_IF_ERR_HR(hr, "IDebugControl->AddBreakpoint");
-	m_breakpoints.push_back(bp);
 
 	hr = bp->SetOffset(address);
-	RTN_IF_ERR_HR(hr, "IDebugBreakpoint->SetOffset[address]");
-	hr = bp->AddFlags(DEBUG_BREAKPOINT_ENABLED);
-	RTN_IF_ERR_HR(hr, "IDebugBreakpoint->AddFlags[DEBUG_BREAKPOINT_ENABLED]");
-	return desired_id;
+	if (SUCCEEDED(hr) && datasize)
+		hr = bp->SetDataParameters(datasize, access);
+	if (SUCCEEDED(hr))
+		hr = bp->AddFlags(DEBUG_BREAKPOINT_ENABLED | flags);
+	if (FAILED(hr))
+	{
+		m_control->RemoveBreakpoint(bp);
+		RTN_IF_ERR_HR(hr, "IDebugBreakpoint->SetOffset/SetDataParameters/AddFlags");
+	}
+	ULONG bpflags = 0;
+	bp->GetFlags(&bpflags);
+	Breakpoint& entry = m_breakpoints.Add(bp, address, bpflags);
+	entry.datasize = datasize;
+	entry.access = access;
+	return &entry;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+std::expected<ULONG, std::string> gdbw::DE::Engine::WatchAdd(size_t address, ULONG size, ULONG access, bool changed, bool* created)
+{
+	if (created)
+		*created = false;
+	if (m_target != this)
+		return std::unexpected("Data breakpoints not supported by the current target");
+
+	// Debug registers only take naturally aligned lengths
+	if (size != 1 && size != 2 && size != 4 && size != 8)
+		return std::unexpected("Data breakpoint size must be 1, 2, 4 or 8");
+	if (size == 8 && !Is64BitTarget())
+		return std::unexpected("8 byte data breakpoints need a 64bit target");
+	if (address % size)
+		return std::unexpected(std::format("Data breakpoint address {:#x} isn't aligned to its size", address));
+	if (access == DEBUG_BREAK_EXECUTE && size != 1)
+		return std::unexpected("Execute data breakpoints must have size 1");
+
+	const Breakpoint* existing = m_breakpoints.Find(address, [&](const Breakpoint& entry) {
+		return entry.datasize == size && entry.access == access && entry.value.has_value() == changed;
+	});
+	if (existing)
+		return existing->id;
+
+	// Every data breakpoint takes a debug register on every thread, there are only 4
+	size_t used = 0;
+	m_breakpoints.ForEach([&](const Breakpoint& entry) {
+		if (entry.datasize)
+			used++;
+	});
+	if (used >= MaxDataBreakpoints)
+		return std::unexpected(std::format("All {} data breakpoints are in use", MaxDataBreakpoints));
+
+	std::optional<uint64_t> initial;
+	if (changed)
+	{
+		uint64_t value = 0;
+		auto read = ReadMemory(address, size, &value);
+		if (!read || *read != size)
+			return std::unexpected(std::format("Failed to read the watched value at {:#x}", address));
+		initial = value;
+	}
+
+	auto bp = CreateBreakpoint(address, 0, size, access);
+	if (!bp)
+		return std::unexpected(bp.error());
+	(*bp)->value = initial;
+	if (created)
+		*created = true;
+	return (*bp)->id;
 }
 
 std::expected<bool, std::string> gdbw::DE::Engine::BreakpointSetFlags(size_t id, ULONG flags)
 {
-	if (id >= m_breakpoints.size()
-		|| id < 0
-		|| m_breakpoints[id] == nullptr)
+	if (m_target != this)
+		return std::unexpected("Breakpoint flags not supported by the current target");
+
+	Breakpoint* entry = m_breakpoints.Get(id);
+	if (!entry)
 		return std::unexpected("Invalid breakpoint id");
 
-	auto hr = m_breakpoints[id]->SetFlags(flags);
+#ifdef _WIN32
+	auto hr = entry->bp->SetFlags(flags);
 	RTN_IF_ERR_HR(hr, "IDebugBreakpoint->SetFlags");
+#endif
+	entry->flags = flags;
 	return true;
 }
 
 std::expected<bool, std::string> gdbw::DE::Engine::BreakpointRemove(size_t id)
 {
-	if (id >= m_breakpoints.size()
-		|| id < 0
-		|| m_breakpoints[id] == nullptr)
+	if (m_target != this)
+		return m_target->ClearBreakpoint((uint32_t)id);
+
+	Breakpoint* entry = m_breakpoints.Get(id);
+	if (!entry)
 		return std::unexpected("Invalid breakpoint id");
 
-	auto hr = m_control->RemoveBreakpoint(m_breakpoints[id]);
+#ifdef _WIN32
+	auto hr = m_control->RemoveBreakpoint(entry->bp);
 	RTN_IF_ERR_HR(hr, "IDebugControl->RemoveBreakpoint");
-	m_breakpoints[id] = nullptr;
+#endif
+	m_breakpoints.Remove((ULONG)id);
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::DE::Engine::BreakpointSetCondition(size_t id, std::string_view expression)
+{
+	// Other targets report stops without the breakpoint that caused them
+	if (m_target != this)
+		return std::unexpected("Breakpoint conditions not supported by the current target");
+
+	Breakpoint* entry = m_breakpoints.Get(id);
+	if (!entry)
+		return std::unexpected("Invalid breakpoint id");
+
+	if (expression.empty())
+	{
+		entry->condition.reset();
+		return true;
+	}
+	auto condition = Condition::Compile(expression, Is64BitTarget() ? RegisterSet::GP64 : RegisterSet::GP32);
+	if (!condition)
+		return std::unexpected(condition.error());
+	entry->condition = std::move(*condition);
 	return true;
 }
 
+const gdbw::Condition* gdbw::DE::Engine::BreakpointGetCondition(size_t id) const
+{
+	const Breakpoint* entry = m_breakpoints.Get(id);
+	return entry && entry->condition ? &*entry->condition : nullptr;
+}
+
+std::expected<ULONG, std::string> gdbw::DE::Engine::TracepointAdd(size_t address, std::string_view fields, size_t capacity)
+{
+	if (m_target != this)
+		return std::unexpected("Tracepoints not supported by the current target");
+
+	// Compile first so a bad field doesn't leave a breakpoint behind
+	auto tracepoint = Tracepoint::Compile(fields, Is64BitTarget() ? RegisterSet::GP64 : RegisterSet::GP32, capacity);
+	if (!tracepoint)
+		return std::unexpected(tracepoint.error());
+
+	// BreakpointAdd would hand back a breakpoint already there, which would stop halting (and be
+	// removed with the tracepoint). Only one code breakpoint is ever kept per address.
+	const Breakpoint* existing = m_breakpoints.Find(address, [](const Breakpoint& entry) { return !entry.datasize && !entry.block; });
+	if (existing)
+		return std::unexpected(std::format("Breakpoint {} is already set at {:#x}", existing->id, address));
+
+	auto bp = CreateBreakpoint(address, 0);
+	if (!bp)
+		return std::unexpected(bp.error());
+	(*bp)->tracepoint = std::move(*tracepoint);
+	return (*bp)->id;
+}
+
+const gdbw::Tracepoint* gdbw::DE::Engine::GetTracepoint(size_t id) const
+{
+	const Breakpoint* entry = m_breakpoints.Get(id);
+	return entry && entry->tracepoint ? &*entry->tracepoint : nullptr;
+}
+
+std::expected<size_t, std::string> gdbw::DE::Engine::CoverageAdd(size_t address, std::vector<Coverage::Block> blocks)
+{
+	// Hits are only seen through DbgEng breakpoint callbacks
+	if (m_target != this)
+		return std::unexpected("Coverage not supported by the current target");
+
+	auto modules = GetModules();
+	if (!modules)
+		return std::unexpected(modules.error());
+	auto module = std::find_if(modules->begin(), modules->end(), [&](const TargetModule& m) { return address >= m.base && address < m.base + m.size; });
+	if (module == modules->end())
+		return std::unexpected(std::format("No module at {:#x}", address));
+
+	if (blocks.empty())
+	{
+		auto functions = Coverage::ImageFunctions(*this, module->base);
+		if (!functions)
+			return std::unexpected(functions.error());
+		blocks = std::move(*functions);
+
+#ifdef _WIN32
+		// x86 images have no exception directory, only the entry point is found without symbols
+		if (blocks.size() <= 1 && m_symmanager)
+		{
+			auto symbols = m_symmanager->FunctionsInModule(module->base);
+			if (symbols)
+			{
+				for (auto& [start, size] : *symbols)
+				{
+					if (start >= module->base && start < module->base + module->size)
+						blocks.push_back({ (uint32_t)(start - module->base), (uint32_t)size, 0 });
+				}
+			}
+		}
+#endif
+	}
+
+	auto id = m_coverage.AddModule(module->base, module->size, module->name);
+	if (!id)
+		return std::unexpected(id.error());
+
+	// All placed in one go, DbgEng only writes them to the target on the next resume. Blocks already
+	// placed (hit or not) aren't placed twice, hit ones have no breakpoint left so Coverage is asked.
+	size_t count = 0;
+	for (auto& block : blocks)
+	{
+		if (block.offset >= module->size || m_coverage.Find(*id, block.offset))
+			continue;
+		auto bp = CreateBreakpoint(module->base + block.offset, DEBUG_BREAKPOINT_ONE_SHOT);
+		if (!bp)
+			return std::unexpected(std::format("{} after placing {} coverage breakpoints", bp.error(), count));
+		(*bp)->block = m_coverage.AddBlock(*id, block.offset, block.size);
+		count++;
+	}
+	return count;
+}
+
+std::expected<size_t, std::string> gdbw::DE::Engine::CoverageClear(void)
+{
+	if (m_target != this)
+		return std::unexpected("Coverage not supported by the current target");
+
+	std::vector<ULONG> pending;
+	m_breakpoints.ForEach([&](const Breakpoint& entry) {
+		if (entry.block)
+			pending.push_back(entry.id);
+	});
+	for (ULONG id : pending)
+	{
+#ifdef _WIN32
+		auto hr = m_control->RemoveBreakpoint(m_breakpoints.Get(id)->bp);
+		RTN_IF_ERR_HR(hr, "IDebugControl->RemoveBreakpoint");
+#endif
+		m_breakpoints.Remove(id);
+	}
+	m_coverage.Clear();
+	return pending.size();
+}
+
 std::expected<ULONG64, std::string> gdbw::DE::Engine::Evaluate(PSTR expression)
 {
+#ifdef _WIN32
+	if (m_target != this)
+		return EvaluateSimple(expression);
+
 	DEBUG_VALUE val = { 0 };
 	ULONG flags = 0;
 	m_control->GetExpressionSyntax(&flags);
 	auto hr = m_control->Evaluate(expression, DEBUG_VALUE_INT64, &val, NULL);
 	RTN_IF_ERR_HR(hr, "IDebugControl[Evaluate]");
 	return val.I64;
+#else
+	return EvaluateSimple(expression);
+#endif
+}
+
+std::expected<ULONG64, std::string> gdbw::DE::Engine::EvaluateSimple(const std::string& expression)
+{
+	auto context = m_target->GetRegisters(m_target->Is64Bit() ? RegisterSet::GP64 : RegisterSet::GP32);
+	ULONG64 result = 0;
+	size_t pos = 0;
+	bool negate = false;
+	while (pos < expression.size())
+	{
+		size_t end = expression.find_first_of("+-", pos);
+		if (end == std::string::npos)
+			end = expression.size();
+		std::string term = expression.substr(pos, end - pos);
+		term.erase(0, term.find_first_not_of(" \t"));
+		term.erase(term.find_last_not_of(" \t") + 1);
+		if (!term.empty() && term[0] == '@')
+			term.erase(0, 1); // masm register prefix
+
+		ULONG64 value = 0;
+		bool found = false;
+		for (size_t i = 0; context && i < context->count && !found; i++)
+		{
+			if (term == context->names[i])
+			{
+				value = context->values[i];
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			// Numbers are hex like windbg's default radix
+			std::string digits = term.starts_with("0x") ? term.substr(2) : term;
+			auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, 16);
+			if (digits.empty() || ec != std::errc() || ptr != digits.data() + digits.size())
+				return std::unexpected(std::format("Engine.Evaluate couldn't resolve '{}'", term));
+		}
+
+		result = negate ? result - value : result + value;
+		if (end == expression.size())
+			break;
+		negate = expression[end] == '-';
+		pos = end + 1;
+	}
+	return result;
 }
 
 std::expected<bool, std::string> gdbw::DE::Engine::Interrupt(ULONG flags)
 {
+	if (m_target != this)
+	{
+		m_target->Interrupt();
+		return true;
+	}
+
+#ifdef _WIN32
 	auto hr = m_control->SetInterrupt(flags);
 	RTN_IF_ERR_HR(hr, "Engine.Interrupt[SetInterrupt]");
 	return true;
+#else
+	return std::unexpected(NoSession);
+#endif
 }
 
-std::expected<std::map<std::string, size_t>, std::string> gdbw::DE::Engine::GetRegisters(std::set<const char*> regs)
+std::expected<gdbw::DE::RegisterContext, std::string> gdbw::DE::Engine::GetRegisters(RegisterSet set)
 {
-	std::map<std::string, size_t> registers;
-	DEBUG_VALUE val = { 0 };
-	ULONG idx = 0;
+#ifdef _WIN32
+	RegisterContext context = { set, 0, nullptr, { 0 } };
+	context.count = GetRegisterSetNames(set, &context.names);
+	if (context.count == 0)
+		return std::unexpected("Engine.GetRegisters invalid register set");
+
+	// Indices only change with the processor type, so resolve them once per type
+	auto& indices = m_registerindices[{ m_processortype, set }];
+	if (indices.empty())
+	{
+		ULONG idx = 0;
+		for (size_t i = 0; i < context.count; i++)
+		{
+			auto hr = m_registers->GetIndexByName(context.names[i], &idx);
+			if (FAILED(hr))
+			{
+				indices.clear();
+				return std::unexpected(std::format("Engine.GetRegisters failed to resolve {} hr={:#x}", context.names[i], hr));
+			}
+			indices.push_back(idx);
+		}
+	}
+
+	DEBUG_VALUE values[MaxRegisters] = { 0 };
+	auto hr = m_registers->GetValues((ULONG)context.count, indices.data(), 0, values);
+	RTN_IF_ERR_HR(hr, "Engine.GetRegisters[GetValues]");
 
-	for (auto name : regs)
+	for (size_t i = 0; i < context.count; i++)
 	{
-		RTN_IF_ERR_HR(m_registers->GetIndexByName(name, &idx), "Engine.GetContext");
-		RTN_IF_ERR_HR(m_registers->GetValue(idx, &val), "Engine.GetContext");
-		registers[name] = val.I64;
+		switch (values[i].Type)
+		{
+		case DEBUG_VALUE_INT8: context.values[i] = values[i].I8; break;
+		case DEBUG_VALUE_INT16: context.values[i] = values[i].I16; break;
+		case DEBUG_VALUE_INT32: context.values[i] = values[i].I32; break;
+		default: context.values[i] = values[i].I64; break;
+		}
 	}
-	return registers;
+	return context;
+#else
+	return std::unexpected(NoSession);
+#endif
 }
 
+std::expected<std::vector<gdbw::DE::FullContextValue>, std::string> gdbw::DE::Engine::GetFullContext(void)
+{
+	// Only the live session exposes the full register file
+	if (m_target != this)
+		return std::unexpected("Engine.GetFullContext not supported by the current target");
+
+#ifdef _WIN32
+	auto layout_result = GetFullContextLayout();
+	if (!layout_result)
+		return std::unexpected(layout_result.error());
+	const FullContextLayout* layout = *layout_result;
+
+	std::vector<DEBUG_VALUE> values(layout->indices.size());
+	auto hr = m_registers->GetValues((ULONG)layout->indices.size(), (PULONG)layout->indices.data(), 0, values.data());
+	RTN_IF_ERR_HR(hr, "Engine.GetFullContext[GetValues]");
+
+	std::vector<FullContextValue> context;
+	context.reserve(layout->registers.size());
+	for (auto& reg : layout->registers)
+	{
+		FullContextValue value = { 0 };
+		value.name = reg.name.c_str();
+		value.isvector = reg.isvector;
+
+		if (!reg.isvector)
+		{
+			const DEBUG_VALUE& v = values[reg.parts[0]];
+			switch (v.Type)
+			{
+			case DEBUG_VALUE_INT8: value.value = v.I8; break;
+			case DEBUG_VALUE_INT16: value.value = v.I16; break;
+			case DEBUG_VALUE_INT32: value.value = v.I32; break;
+			default: value.value = v.I64; break;
+			}
+		}
+		else
+		{
+			// Concatenate the raw bytes of every part, low part first
+			for (auto part : reg.parts)
+			{
+				const DEBUG_VALUE& v = values[part];
+				size_t width = 0;
+				switch (v.Type)
+				{
+				case DEBUG_VALUE_FLOAT80: width = 10; break;
+				case DEBUG_VALUE_FLOAT82: width = 11; break;
+				case DEBUG_VALUE_FLOAT128:
+				case DEBUG_VALUE_VECTOR128: width = 16; break;
+				case DEBUG_VALUE_VECTOR64:
+				case DEBUG_VALUE_FLOAT64:
+				case DEBUG_VALUE_INT64: width = 8; break;
+				default: width = 4; break;
+				}
+				width = std::min(width, sizeof(value.bytes) - value.size);
+				memcpy(value.bytes + value.size, v.RawBytes, width);
+				value.size += (uint8_t)width;
+			}
+		}
+		context.push_back(value);
+	}
+	return context;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+#ifdef _WIN32
+std::expected<const gdbw::DE::FullContextLayout*, std::string> gdbw::DE::Engine::GetFullContextLayout(void)
+{
+	auto existing = m_fullcontextlayouts.find(m_processortype);
+	if (existing != m_fullcontextlayouts.end())
+		return &existing->second;
+
+	// Available register names differ between processor types (and CPU features for AVX),
+	// so enumerate what the engine actually exposes rather than guessing.
+	ULONG count = 0;
+	auto hr = m_registers->GetNumberRegisters(&count);
+	RTN_IF_ERR_HR(hr, "Engine.GetFullContext[GetNumberRegisters]");
+
+	std::map<std::string, ULONG> available;
+	for (ULONG i = 0; i < count; i++)
+	{
+		char name[64] = { 0 };
+		DEBUG_REGISTER_DESCRIPTION desc = { 0 };
+		if (FAILED(m_registers->GetDescription(i, name, sizeof(name), NULL, &desc)))
+			continue;
+		if (desc.Flags & DEBUG_REGISTER_SUB_REGISTER)
+			continue;
+		available[name] = i;
+	}
+
+	FullContextLayout layout;
+	std::map<std::string, size_t> slots; // engine register name -> index into layout.indices
+	auto add = [&](const std::string& name, bool isvector, std::initializer_list<std::string> parts) {
+		for (auto& part : parts)
+			if (!available.contains(part))
+				return;
+
+		FullContextRegister reg = { name, isvector, {} };
+		for (auto& part : parts)
+		{
+			auto slot = slots.find(part);
+			if (slot == slots.end())
+			{
+				slot = slots.insert({ part, layout.indices.size() }).first;
+				layout.indices.push_back(available[part]);
+			}
+			reg.parts.push_back(slot->second);
+		}
+		layout.registers.push_back(reg);
+	};
+
+	add("eflags", false, { "efl" });
+	for (auto name : { "cs", "ds", "es", "fs", "gs", "ss" })
+		add(name, false, { name });
+	for (auto name : { "dr0", "dr1", "dr2", "dr3", "dr6", "dr7" })
+		add(name, false, { name });
+	for (auto name : { "fpcw", "fpsw", "fptw", "mxcsr" })
+		add(name, false, { name });
+	for (int i = 0; i < 8; i++)
+		add(std::format("st{}", i), true, { std::format("st{}", i) });
+	for (int i = 0; i < 16; i++)
+	{
+		auto xmm = std::format("xmm{}", i);
+		add(xmm, true, { xmm });
+		// upper 128 bits are exposed separately as ymm<n>h
+		add(std::format("ymm{}", i), true, { xmm, std::format("ymm{}h", i) });
+	}
+
+	if (layout.indices.empty())
+		return std::unexpected("Engine.GetFullContext no registers available for this processor type");
+
+	auto inserted = m_fullcontextlayouts.insert({ m_processortype, std::move(layout) }).first;
+	return &inserted->second;
+}
+#endif
+
+#ifdef _WIN32
 std::expected<bool, std::string> gdbw::DE::Engine::QueryVM(ULONG64 address, PMEMORY_BASIC_INFORMATION64 mbi)
 {
 	auto hr = m_dataspaces->QueryVirtual(address, mbi);
 	RTN_IF_ERR_HR(hr, "IDebugDataSpaces2[QueryVirtual]");
 	return true;
 }
+#endif
+
+std::expected<std::vector<gdbw::TargetRegion>, std::string> gdbw::DE::Engine::GetRegions(void)
+{
+#ifdef _WIN32
+	std::vector<TargetRegion> regions;
+	MEMORY_BASIC_INFORMATION64 mbi = { 0 };
+	ULONG64 address = 0;
+	while (QueryVM(address, &mbi))
+	{
+		if (mbi.State & MEM_COMMIT)
+			regions.push_back({ mbi.BaseAddress, mbi.AllocationBase, mbi.RegionSize, (uint32_t)mbi.Protect, (uint32_t)mbi.State, (uint32_t)mbi.Type });
+
+		// Stop at the top of the address space
+		if (mbi.RegionSize == 0 || mbi.BaseAddress + mbi.RegionSize <= address)
+			break;
+		address = mbi.BaseAddress + mbi.RegionSize;
+	}
+	return regions;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+std::expected<std::vector<gdbw::TargetModule>, std::string> gdbw::DE::Engine::GetModules(void)
+{
+#ifdef _WIN32
+	ULONG loaded = 0;
+	ULONG unloaded = 0;
+	auto hr = m_symbols->GetNumberModules(&loaded, &unloaded);
+	RTN_IF_ERR_HR(hr, "Engine.GetModules[GetNumberModules]");
+
+	std::vector<DEBUG_MODULE_PARAMETERS> params(loaded);
+	if (loaded)
+	{
+		hr = m_symbols->GetModuleParameters(loaded, NULL, 0, params.data());
+		RTN_IF_ERR_HR(hr, "Engine.GetModules[GetModuleParameters]");
+	}
+
+	std::vector<TargetModule> modules;
+	modules.reserve(loaded);
+	for (auto& param : params)
+	{
+		char imagename[256] = { 0 };
+		hr = m_symbols->GetModuleNames(DEBUG_ANY_ID, param.Base, imagename, 256, 0, NULL, 0, NULL, NULL, 0, NULL);
+		if (hr != S_OK && hr != S_FALSE)
+			continue;
+		modules.push_back({ param.Base, param.Size, imagename });
+	}
+	return modules;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+const gdbw::RegionMap& gdbw::DE::Engine::GetRegionMap(void)
+{
+	if (m_regionscheckedgeneration != m_generation)
+	{
+		m_regionscheckedgeneration = m_generation;
+		if (m_regionsgeneration == m_regiongeneration && !RegionMapValid())
+			m_regiongeneration++;
+	}
+	if (m_regionsgeneration == m_regiongeneration)
+		return m_regions;
+
+	m_regions.Clear();
+	auto regions = m_target->GetRegions();
+	if (regions)
+	{
+		for (auto& region : *regions)
+			m_regions.Add(MemoryRegion(region));
+		AnnotateRegionMap();
+	}
+
+	m_regionsgeneration = m_regiongeneration;
+	return m_regions;
+}
+
+bool gdbw::DE::Engine::RegionMapValid(void)
+{
+	// Other targets report their regions per stop & can't tell us about layout changes, always rebuild
+	if (m_target != this)
+		return false;
+
+#ifdef _WIN32
+	auto context = GetRegisters(Is64Bit() ? RegisterSet::GP64 : RegisterSet::GP32);
+	if (!context)
+		return false;
+	// rip/eip & rsp/esp
+	for (uint64_t address : { context->values[6], context->values[7] })
+	{
+		MEMORY_BASIC_INFORMATION64 mbi = { 0 };
+		if (!QueryVM(address, &mbi) || !(mbi.State & MEM_COMMIT))
+			continue;
+		ptrdiff_t index = m_regions.Find(address);
+		if (index < 0)
+			return false;
+		const MemoryRegion& region = m_regions.Regions()[index];
+		if (region.BaseAddress() != mbi.BaseAddress || region.Size() != mbi.RegionSize || region.Protections() != mbi.Protect)
+			return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void gdbw::DE::Engine::AnnotateRegionMap(void)
+{
+	// Image allocations start at the module base
+	auto modules = m_target->GetModules();
+	if (modules)
+	{
+		for (auto& module : *modules)
+			m_regions.SetModule(module.base, module.name);
+	}
+
+	// Stacks & heaps are found through the TEB/PEB, only the live session can walk those
+	if (m_target != this)
+		return;
+
+#ifdef _WIN32
+	bool is64 = Is64BitTarget();
+	ULONG ptrsize = is64 ? 8 : 4;
+	auto readptr = [&](ULONG64 address, ULONG64* out) {
+		*out = 0;
+		ULONG len = ptrsize;
+		return ReadVM(address, &len, out) && len == ptrsize;
+	};
+
+	// Stacks, NT_TIB.StackLimit is the lowest committed page of each thread's stack
+	ULONG threads = 0;
+	ULONG current = 0;
+	if (SUCCEEDED(m_systemobjects->GetNumberThreads(&threads))
+		&& SUCCEEDED(m_systemobjects->GetCurrentThreadId(&current)))
+	{
+		std::vector<ULONG> ids(threads);
+		if (threads && SUCCEEDED(m_systemobjects->GetThreadIdsByIndex(0, threads, ids.data(), NULL)))
+		{
+			for (ULONG id : ids)
+			{
+				ULONG64 teb = 0;
+				ULONG64 stacklimit = 0;
+				if (FAILED(m_systemobjects->SetCurrentThreadId(id))
+					|| FAILED(m_systemobjects->GetCurrentThreadTeb(&teb))
+					|| !readptr(teb + 2 * ptrsize, &stacklimit))
+					continue;
+
+				ptrdiff_t i = m_regions.Find(stacklimit);
+				if (i >= 0)
+					m_regions.SetKind(m_regions.Regions()[i].AllocationBase(), RegionKind::STACK);
+			}
+		}
+		m_systemobjects->SetCurrentThreadId(current);
+	}
+
+	// Heaps, PEB.ProcessHeaps only lists the first segment of each heap
+	ULONG64 peb = 0;
+	ULONG64 numheaps = 0;
+	ULONG64 heaps = 0;
+	if (FAILED(m_systemobjects->GetCurrentProcessPeb(&peb))
+		|| !readptr(peb + (is64 ? 0xE8 : 0x88), &numheaps)
+		|| !readptr(peb + (is64 ? 0xF0 : 0x90), &heaps))
+		return;
+
+	// NumberOfHeaps is a ULONG in both layouts
+	numheaps &= 0xFFFFFFFF;
+	for (ULONG64 i = 0; i < numheaps && i < 0x1000; i++)
+	{
+		ULONG64 heap = 0;
+		if (!readptr(heaps + i * ptrsize, &heap))
+			break;
+		ptrdiff_t index = m_regions.Find(heap);
+		if (index >= 0)
+			m_regions.SetKind(m_regions.Regions()[index].AllocationBase(), RegionKind::HEAP);
+	}
+#endif
+}
+
+std::expected<bool, std::string> gdbw::DE::Engine::ReadVM(ULONG64 address, PULONG len, PVOID out)
+{
+	// Targets backed by a mapping (dumps) are already as fast as the cache, skip it
+	const uint8_t* view = m_target->View(address, *len);
+	if (view)
+	{
+		memcpy(out, view, *len);
+		return true;
+	}
+
+	auto result = m_pagecache->Read(address, *len, out);
+	if (!result)
+		return std::unexpected(result.error());
+	*len = *result;
+	return true;
+}
 
 std::expected<bool, std::string> gdbw::DE::Engine::ReadVMUncached(ULONG64 address, PULONG len, PVOID out)
 {
-	ULONG bytesread = 0;
-	auto hr = m_dataspaces->ReadVirtualUncached(address, out, *len, &bytesread);
-	RTN_IF_ERR_HR(hr, "Engine.ReadVMUncached");
-	if (bytesread != *len)
-		*len = bytesread;
+	auto result = m_target->ReadMemory(address, *len, out);
+	if (!result)
+		return std::unexpected(result.error());
+	*len = *result;
 	return true;
 }
 
 std::expected<bool, std::string> gdbw::DE::Engine::WriteVMUncached(ULONG64 address, PULONG len, PVOID in)
 {
-	ULONG byteswritten = 0;
-	auto hr = m_dataspaces->WriteVirtualUncached(address, in, *len, &byteswritten);
-	RTN_IF_ERR_HR(hr, "Engine.WriteVMUncached");
-	if (byteswritten != *len)
-		*len = byteswritten;
+	// Drop cached pages/instructions first, a partial write still changes memory
+	m_pagecache->Invalidate(address, *len);
+	m_disassembler->GetCache()->Invalidate(address, *len);
+	m_generation++;
+	m_regiongeneration++;
+	auto result = m_target->WriteMemory(address, *len, in);
+	if (!result)
+		return std::unexpected(result.error());
+	*len = *result;
 	return true;
 }
 
+std::expected<uint32_t, std::string> gdbw::DE::Engine::ReadMemory(uint64_t address, uint32_t len, void* out)
+{
+#ifdef _WIN32
+	ULONG bytesread = 0;
+	auto hr = m_dataspaces->ReadVirtualUncached(address, out, len, &bytesread);
+	RTN_IF_ERR_HR(hr, "Engine.ReadMemory");
+	return bytesread;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+std::expected<uint32_t, std::string> gdbw::DE::Engine::WriteMemory(uint64_t address, uint32_t len, const void* in)
+{
+#ifdef _WIN32
+	ULONG byteswritten = 0;
+	auto hr = m_dataspaces->WriteVirtualUncached(address, (PVOID)in, len, &byteswritten);
+	RTN_IF_ERR_HR(hr, "Engine.WriteMemory");
+	return byteswritten;
+#else
+	return std::unexpected(NoSession);
+#endif
+}
+
+void gdbw::DE::Engine::SetTarget(Target* target)
+{
+	m_target = target ? target : this;
+	m_disassembler->SetMode(m_target->Is64Bit() ? cs_mode::CS_MODE_64 : cs_mode::CS_MODE_32);
+
+	// Nothing cached about the old target applies to the new one
+	m_pagecache->Flush();
+	m_disassembler->GetCache()->Flush();
+#ifdef _WIN32
+	if (m_symmanager)
+		m_symmanager->InvalidateCache(0, 0);
+#endif
+	m_generation++;
+	m_regiongeneration++;
+}
+
+void gdbw::DE::Engine::OnModuleChange(ULONG64 base, ULONG64 size)
+{
+	m_generation++;
+	m_regiongeneration++;
+
+	// New code may now live where an old module was
+	if (size == 0)
+		m_disassembler->GetCache()->Flush();
+	else
+		m_disassembler->GetCache()->Invalidate(base, size);
+
+#ifdef _WIN32
+	// Symbol manager is only created once we've attached
+	if (m_symmanager)
+		m_symmanager->InvalidateCache(base, size);
+#endif
+}
+
+#ifdef _WIN32
+ULONG gdbw::DE::Engine::OnBreakpoint(ULONG id)
+{
+	Breakpoint* entry = m_breakpoints.Get(id);
+	if (!entry)
+		return DEBUG_STATUS_NO_CHANGE;
+
+	// Coverage breakpoints are one shot, DbgEng drops them after this event so only the slot is freed
+	if (entry->block)
+	{
+		m_coverage.Hit(*entry->block);
+		m_breakpoints.Remove(id);
+		return DEBUG_STATUS_GO;
+	}
+
+	// Data breakpoints trap after the access, memory already holds the new value
+	if (entry->value)
+	{
+		uint64_t value = 0;
+		auto read = ReadMemory(entry->address, entry->datasize, &value);
+		if (read && *read == entry->datasize)
+		{
+			if (value == *entry->value)
+				return DEBUG_STATUS_GO;
+			entry->value = value;
+		}
+	}
+
+	if (!entry->condition && !entry->tracepoint)
+		return DEBUG_STATUS_NO_CHANGE;
+
+	// Runs on every hit, so go straight to the target: one GetValues call plus an uncached read
+	// of whatever gets dereferenced. Nothing is cached, so resuming needs no invalidation.
+	RegisterSet set = entry->condition ? entry->condition->Set() : entry->tracepoint->Set();
+	auto registers = GetRegisters(set);
+	if (!registers)
+	{
+		std::println("Breakpoint {} registers unavailable: {}", id, registers.error());
+		return DEBUG_STATUS_NO_CHANGE;
+	}
+	auto read = [this](uint64_t address, uint32_t len, void* out) { return ReadMemory(address, len, out); };
+
+	if (entry->condition)
+	{
+		auto result = entry->condition->Evaluate(*registers, read);
+		if (!result)
+		{
+			// Stopping is the safe choice, the user can fix or remove the condition
+			std::println("Breakpoint {} condition failed: {}", id, result.error());
+			return DEBUG_STATUS_NO_CHANGE;
+		}
+		if (*result == 0)
+			return DEBUG_STATUS_GO;
+	}
+
+	// Tracepoints never stop & never print, a hit is only a record in the ring buffer
+	if (entry->tracepoint)
+	{
+		ULONG thread = 0;
+		m_systemobjects->GetCurrentThreadSystemId(&thread);
+		entry->tracepoint->Record(*registers, read, thread);
+		return DEBUG_STATUS_GO;
+	}
+	return DEBUG_STATUS_NO_CHANGE;
+}
+#endif
+
+void gdbw::DE::Engine::InvalidateTargetState(void)
+{
+	// Target memory is only stable while suspended
+	m_pagecache->Flush();
+	m_generation++;
+}
+
+#ifdef _WIN32
 std::expected<bool, std::string> gdbw::DE::Engine::WaitAndHandleDebugEvent(bool firstevent)
 {
 	// Always running until WaitForEvent returns
@@ -307,10 +1287,15 @@ std::expected<bool, std::string> gdbw::DE::Engine::WaitAndHandleDebugEvent(bool
 	hr = m_control->SetEffectiveProcessorType(executing_type);
 	RTN_IF_ERR_HR(hr, "IDebugControl[SetEffectiveProcessorType]");
 	uint8_t old_bitness = m_debuggeebitness;
+	m_processortype = executing_type;
 	m_debuggeebitness = executing_type == IMAGE_FILE_MACHINE_AMD64 ? 64 : 32;
 
 	if (m_debuggeebitness != old_bitness)
+	{
 		m_symmanager->RefreshModuleList();
+		// TODO: when debugging syswow binary and executing 64-bit code, this assumes 32-bit code is also 64bit.
+		m_disassembler->SetMode(Is64BitTarget() ? cs_mode::CS_MODE_64 : cs_mode::CS_MODE_32);
+	}
 
 	// For any break status event the debugger is suspended, so run the prompt
 	if (exec_status == DEBUG_STATUS_BREAK)
@@ -324,6 +1309,7 @@ std::expected<bool, std::string> gdbw::DE::Engine::WaitAndHandleDebugEvent(bool
 		else if (m_state == State::STEP_OVER) new_status = DEBUG_STATUS_STEP_OVER;
 		else if (m_state == State::STOP) return false;
 
+		InvalidateTargetState();
 		hr = m_control->SetExecutionStatus(new_status);
 		RTN_IF_ERR_HR(hr, "SetExecutionStatus");
 	}
@@ -355,3 +1341,4 @@ std::expected<bool, std::string> gdbw::DE::Engine::HandleFirstEvent()
 	m_control->Execute(DEBUG_OUTCTL_IGNORE, ".reload /f", DEBUG_EXECUTE_NOT_LOGGED);
 	return true;
 }
+#endif
@@ -1,12 +1,27 @@
 #pragma once
+#include <charconv>
+#include <algorithm>
+#include <unordered_map>
 #include <expected>
 #include <map>
-#include <set>
 #include <string>
 #include <print>
-#include <DbgEng.h>
+#include "BreakpointRegistry.hpp"
+#include "Condition.hpp"
+#include "Coverage.hpp"
+#include "Disassembler.hpp"
 #include "LuaManager.hpp"
+#include "MemoryRegion.hpp"
+#include "PageCache.hpp"
+#include "Platform.hpp"
+#include "RegionMap.hpp"
+#include "StringIndex.hpp"
+#include "Registers.hpp"
+#ifdef _WIN32
 #include "Symbols.hpp"
+#endif
+#include "Target.hpp"
+#include "Tracepoint.hpp"
 
 #define RTN_IF_ERR_HR(hr, funcname) if (FAILED(hr)) return std::unexpected(std::format(funcname " failed with hr={:#x}", hr))
 
@@ -26,9 +41,13 @@ namespace gdbw::DE
 		STOP
 	};
 
+	class Engine;
+
+#ifdef _WIN32
 	class EventCallbacks : public DebugBaseEventCallbacks
 	{
 	public:
+		EventCallbacks(Engine* engine) : m_engine(engine) {}
 		virtual ~EventCallbacks() { Release(); }
 
 		ULONG STDMETHODCALLTYPE AddRef() override
@@ -60,30 +79,16 @@ namespace gdbw::DE
 			return S_OK;
 		}
 
-		HRESULT Breakpoint(PDEBUG_BREAKPOINT bp) override
-		{
-			ULONG id = 0;
-			auto hr = bp->GetId(&id);
-			// Just want to warn, not exit. This should never be hit - if it is there's
-			// an issue with the [Add/Remove]Breakpoint bindings
-			if (FAILED(hr)) std::println("Warning: Failed to get breakpoint id, hr={:#x}", hr);
-			return DEBUG_STATUS_NO_CHANGE;
-		}
+		HRESULT Breakpoint(PDEBUG_BREAKPOINT bp) override;
 
 		HRESULT Exception(PEXCEPTION_RECORD64 exception, ULONG fistchance) override
 		{
 			return DEBUG_STATUS_NO_CHANGE;
 		}
 
-		HRESULT CreateThread(ULONG64 handle, ULONG64 dataoffset, ULONG64 startoffset) override
-		{
-			return DEBUG_STATUS_NO_CHANGE;
-		}
+		HRESULT CreateThread(ULONG64 handle, ULONG64 dataoffset, ULONG64 startoffset) override;
 
-		HRESULT ExitThread(ULONG exitcode) override
-		{
-			return DEBUG_STATUS_NO_CHANGE;
-		}
+		HRESULT ExitThread(ULONG exitcode) override;
 
 		HRESULT CreateProcess(
 			ULONG64 imagehandle, ULONG64 handle, ULONG64 baseoffset, ULONG modulesize,
@@ -100,15 +105,9 @@ namespace gdbw::DE
 
 		HRESULT LoadModule(
 			ULONG64 imagehandle, ULONG64 baseoffset, ULONG modulesize,
-			PCSTR ModuleName, PCSTR imagename, ULONG checksum, ULONG timestamp) override
-		{
-			return DEBUG_STATUS_NO_CHANGE;
-		}
+			PCSTR ModuleName, PCSTR imagename, ULONG checksum, ULONG timestamp) override;
 
-		HRESULT UnloadModule(PCSTR imagename, ULONG64 baseoffset) override
-		{
-			return DEBUG_STATUS_NO_CHANGE;
-		}
+		HRESULT UnloadModule(PCSTR imagename, ULONG64 baseoffset) override;
 
 		HRESULT SystemError(ULONG error, ULONG level) override
 		{
@@ -134,6 +133,8 @@ namespace gdbw::DE
 		{
 			return DEBUG_STATUS_NO_CHANGE;
 		}
+	private:
+		Engine* m_engine = nullptr;
 	}; // end of EventCallbacks class
 	
 	class IOCallbacks : public IDebugInputCallbacks, public IDebugOutputCallbacks
@@ -180,20 +181,36 @@ namespace gdbw::DE
 			return S_OK;
 		}
 	};
+#endif
 
-	class Engine
+	// Live DbgEng session. The engine is itself the DbgEng Target, caches & bindings go through
+	// GetTarget() so another backend (e.g. a snapshot) can be swapped in.
+	class Engine : public Target
 	{
 	public:
+		// Data breakpoints are backed by the debug registers (DR0-DR3)
+		static constexpr size_t MaxDataBreakpoints = 4;
+
 		Engine() = default;
 		~Engine();
+#ifdef _WIN32
 		// Initialize debugger, Constructor does not do this!
 		std::expected<bool, std::string> Init(gdbw::LuaManager* lua);
+#endif
+		// Initialize caches only, without a DbgEng session. Only usable with SetTarget (e.g. batch mode over dumps,
+		// or any target off Windows).
+		std::expected<bool, std::string> InitOffline(gdbw::LuaManager* lua);
+#ifdef _WIN32
 		// Attach to a process given a pid
 		std::expected<bool, std::string> Attach(DWORD pid, bool break_on_entry = true);
 		// Create and attach to a new process given a command line
 		std::expected<bool, std::string> CreateAndAttach(PSTR commandline, bool break_on_entry = true);
 		// Enter debug loop
 		std::expected<bool, std::string> EnterDebugLoop(void);
+#endif
+		// Enter the session loop for a target with its own run control (e.g. a remote stub),
+		// the target must have been set with SetTarget
+		std::expected<bool, std::string> EnterTargetLoop(void);
 
 		//
 		// Useful functions for bindings
@@ -203,45 +220,171 @@ namespace gdbw::DE
 		inline void SetState(State s) { m_state = s; }
 		// Get a pointer to the lua manager
 		inline LuaManager* GetLuaManager(void) { return m_lua; }
+#ifdef _WIN32
 		// Get a pointer to the symbol manager
 		inline SymbolManager* GetSymbolManager(void) { return m_symmanager; }
-		// Get breakpoints
-		inline std::vector<PDEBUG_BREAKPOINT> GetBreakpoints(void) { return m_breakpoints; }
+#endif
+		// Get a pointer to the disassembler (mode follows the executing processor type)
+		inline Disassembler* GetDisassembler(void) { return m_disassembler; }
+		// Get a pointer to the memory read cache
+		inline PageCache* GetPageCache(void) { return m_pagecache; }
+		// Get breakpoints (live session only, other targets keep their own)
+		inline const BreakpointRegistry& GetBreakpoints(void) const { return m_breakpoints; }
 		// Check if debuggee is 64bit. Returns true if so
-		inline bool Is64BitTarget(void) { return m_debuggeebitness == 64; }
-
+		inline bool Is64BitTarget(void) { return m_target->Is64Bit(); }
+		// Get the target all memory, register & region access goes through
+		inline Target* GetTarget(void) { return m_target; }
+		// True while debugging a process through DbgEng rather than another target
+		inline bool IsLiveSession(void) const { return m_target == this; }
+		// Swap in another target (nullptr for the live session), drops everything cached about the old one
+		void SetTarget(Target* target);
+		// Get the target generation. Bumped whenever the target runs, a module is (un)loaded or memory is
+		// written, anything derived from target state is stale once this changes.
+		inline uint64_t GetGeneration(void) { return m_generation; }
+		// Get the region generation. Only bumped when the memory layout is known to change (module (un)load,
+		// thread create/exit, writes, a new target) or GetRegionMap's check finds the map out of date, so
+		// things derived from the region map (e.g. the string index) survive stepping.
+		inline uint64_t GetRegionGeneration(void) { return m_regiongeneration; }
+
+		// Resolve many addresses in one pass, `addresses` must be sorted & unique.
+		// Result is parallel to `addresses`, misses are std::nullopt.
+		std::vector<std::optional<Symbol>> SymbolsFromAddresses(const std::vector<uint64_t>& addresses);
 		// Get a module name from its base address
 		std::expected<std::string, std::string> AddressToModule(ULONG64 address);
-		// Add a breakpoint
-		std::expected<ULONG, std::string> BreakpointAdd(size_t address);
+		// Add a breakpoint, or get the id of the code breakpoint already at `address`. `created` (if given)
+		// is set when a new breakpoint was added.
+		std::expected<ULONG, std::string> BreakpointAdd(size_t address, bool* created = nullptr);
 		// Set a breakpoint's flags (e.g. enable/disable)
 		std::expected<bool, std::string> BreakpointSetFlags(size_t id, ULONG flags);
 		// Remove a breakpoint
 		std::expected<bool, std::string> BreakpointRemove(size_t id);
-		// Evaluate an expression (windbg format)
+		// Only stop at a breakpoint when `expression` is non zero, an empty expression removes the condition
+		std::expected<bool, std::string> BreakpointSetCondition(size_t id, std::string_view expression);
+		// Get a breakpoint's condition, nullptr if it always stops
+		const Condition* BreakpointGetCondition(size_t id) const;
+		// Add a breakpoint recording comma separated `fields` into a ring buffer of `capacity` records on every hit.
+		// Fails if there's already a code breakpoint at `address`.
+		std::expected<ULONG, std::string> TracepointAdd(size_t address, std::string_view fields, size_t capacity);
+		// Get a breakpoint's tracepoint, nullptr if it isn't one
+		const Tracepoint* GetTracepoint(size_t id) const;
+		// Add a data breakpoint on `size` (1, 2, 4 or 8) bytes at `address`, triggered by `access` (DEBUG_BREAK_READ, _WRITE
+		// or _EXECUTE). With `changed` it only stops when the value differs from the last one seen. An identical watch
+		// already set is returned instead of taking another debug register, `created` (if given) is set otherwise.
+		std::expected<ULONG, std::string> WatchAdd(size_t address, ULONG size, ULONG access, bool changed, bool* created = nullptr);
+		// Place a one shot breakpoint on every block (offset & size from the module base) of the module containing
+		// `address`, or on every function when `blocks` is empty. Returns the number of breakpoints placed.
+		std::expected<size_t, std::string> CoverageAdd(size_t address, std::vector<Coverage::Block> blocks);
+		// Remove the coverage breakpoints not hit yet & forget all coverage, returns the number removed
+		std::expected<size_t, std::string> CoverageClear(void);
+		inline const Coverage& GetCoverage(void) const { return m_coverage; }
+		// Evaluate an expression (windbg format). Other targets only support registers & hex numbers joined by +/-
 		std::expected<ULONG64, std::string> Evaluate(PSTR expression);
 		// Set an interrupt, useful for breaking into the debugger
 		std::expected<bool, std::string> Interrupt(ULONG flags);
-		// Get all registers
-		std::expected<std::map<std::string, size_t>, std::string> GetRegisters(std::set<const char*> regs);
+		// Get flags, segment, debug, x87, SSE & AVX registers with a single GetValues call
+		std::expected<std::vector<FullContextValue>, std::string> GetFullContext(void);
+#ifdef _WIN32
 		// Query virtual memory
 		std::expected<bool, std::string> QueryVM(ULONG64 address, PMEMORY_BASIC_INFORMATION64 mbi);
-		// Read virtual memory (uncached)
+#endif
+		// Get all committed memory regions, sorted by address. Rebuilt lazily when the generation changes.
+		inline const std::vector<MemoryRegion>& GetVMRegions(void) { return GetRegionMap().Regions(); }
+		// Get the classified region map (stack/heap/image/...), rebuilt lazily when the generation changes.
+		const RegionMap& GetRegionMap(void);
+		// Get the string index, the caller rebuilds it once it no longer Covers() the current generation
+		inline StringIndex& GetStringIndex(void) { return m_strings; }
+		// Read virtual memory (cached until the target is resumed)
+		std::expected<bool, std::string> ReadVM(ULONG64 address, PULONG len, PVOID out);
+		// Read virtual memory from the current target (uncached)
 		std::expected<bool, std::string> ReadVMUncached(ULONG64 address, PULONG len, PVOID out);
-		// Write virtual memory (uncached)
+		// Write virtual memory to the current target (uncached)
 		std::expected<bool, std::string> WriteVMUncached(ULONG64 address, PULONG len, PVOID in);
+
+		//
+		// Target implementation (live DbgEng session)
+		//
+
+		std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override;
+		std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override;
+		std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) override;
+		// Get all registers in a set with a single GetValues call
+		std::expected<RegisterContext, std::string> GetRegisters(RegisterSet set) override;
+		std::expected<std::vector<TargetModule>, std::string> GetModules(void) override;
+		inline bool Is64Bit(void) override { return m_debuggeebitness == 64; }
+#ifdef _WIN32
+		// Resolve through DbgHelp, once attached
+		std::expected<Symbol, std::string> SymbolFromAddress(uint64_t address) override;
+		std::expected<Symbol, std::string> SymbolFromName(const std::string& name) override;
+#endif
+
+		//
+		// Event hooks, called from EventCallbacks
+		//
+
+		// A module was loaded or unloaded, drop anything cached about the old layout
+		void OnModuleChange(ULONG64 base, ULONG64 size);
+		// A thread was created or exited, its stack (& TEB) came or went
+		inline void OnThreadChange(void) { m_regiongeneration++; }
+#ifdef _WIN32
+		// A breakpoint was hit, returns DEBUG_STATUS_GO to resume without stopping (e.g. its condition is false
+		// or it's a tracepoint)
+		ULONG OnBreakpoint(ULONG id);
+#endif
 	private:
+		// Target is about to run (or has been changed), drop everything cached about its state
+		void InvalidateTargetState(void);
+		// Cheap check of the region map after the target ran, true if the regions at the instruction &
+		// stack pointers are still the ones in the map. Catches e.g. JIT code & new stacks without a full walk.
+		bool RegionMapValid(void);
+		// Address after the call at the target's instruction pointer, nullopt if it isn't a call
+		std::optional<uint64_t> CallReturnAddress(void);
+		// Add an enabled breakpoint with extra `flags` (e.g. DEBUG_BREAKPOINT_ONE_SHOT) to DbgEng & the registry.
+		// A non zero `datasize` makes it a data breakpoint triggered by `access` (DEBUG_BREAK_*).
+		std::expected<Breakpoint*, std::string> CreateBreakpoint(uint64_t address, ULONG flags, ULONG datasize = 0, ULONG access = 0);
+#ifdef _WIN32
 		// Handle a single iteration of the debug loop (including prompt)
 		// Returns false if debugger should detach and exit.
 		// Rf firstevent is true, further engine initialisation will take place after the first WaitForEvent call.
 		std::expected<bool, std::string> WaitAndHandleDebugEvent(bool firstevent);
+#endif
+		// Classify stack & heap regions and name image regions, called after a region map rebuild
+		void AnnotateRegionMap(void);
+		// Evaluate `reg+0x20-8` style expressions against m_target, used when there's no DbgEng session
+		std::expected<ULONG64, std::string> EvaluateSimple(const std::string& expression);
+#ifdef _WIN32
+		// Resolve the full context register layout for the current processor type
+		std::expected<const FullContextLayout*, std::string> GetFullContextLayout(void);
 		// To be called upon first attach, gets target information to be used in commands.
 		std::expected<bool, std::string> HandleFirstEvent();
+#endif
 		State m_state = State::NONE;
-		HANDLE m_hdebuggee = INVALID_HANDLE_VALUE;
+		Target* m_target = this;
 		uint8_t m_debuggeebitness = 0;
-		std::vector<PDEBUG_BREAKPOINT> m_breakpoints;
+#ifdef _WIN32
+		HANDLE m_hdebuggee = INVALID_HANDLE_VALUE;
+		ULONG m_processortype = 0;
+		// Register indices per (processor type, register set), resolved on first use
+		std::map<std::pair<ULONG, RegisterSet>, std::vector<ULONG>> m_registerindices;
+#endif
+		uint64_t m_generation = 1;
+		// Region map, valid while m_regionsgeneration == m_regiongeneration. Checked once per stop
+		// (m_regionscheckedgeneration) by RegionMapValid.
+		uint64_t m_regiongeneration = 1;
+		RegionMap m_regions;
+		uint64_t m_regionsgeneration = 0;
+		uint64_t m_regionscheckedgeneration = 0;
+		StringIndex m_strings;
+#ifdef _WIN32
+		// Full context layouts per processor type, resolved on first use
+		std::map<ULONG, FullContextLayout> m_fullcontextlayouts;
+#endif
+		// Breakpoints by id, with their conditions & tracepoints
+		BreakpointRegistry m_breakpoints;
+		Coverage m_coverage;
 		LuaManager* m_lua = nullptr;
+		PageCache* m_pagecache = nullptr;
+		Disassembler* m_disassembler = nullptr;
+#ifdef _WIN32
 		SymbolManager* m_symmanager = nullptr; // Initialized in EnterDebugLoop since we need a handle
 		IDebugClient* m_client = nullptr;
 		IDebugControl3* m_control = nullptr;
@@ -251,6 +394,7 @@ namespace gdbw::DE
 		IDebugSystemObjects4* m_systemobjects = nullptr;
 		EventCallbacks* m_eventcallbacks = nullptr;
 		IOCallbacks* m_iocallbacks = nullptr;
+#endif
 	};
 }
 
@@ -4,41 +4,83 @@ gdbw::Disassembler::Disassembler(cs_arch arch, cs_mode mode)
 {
 	m_arch = arch;
 	m_mode = mode;
+	m_handles.reserve(2); // 32 & 64-bit
 }
 
 gdbw::Disassembler::~Disassembler()
 {
+	for (auto& handle : m_handles)
+	{
+		cs_free(handle.insn, 1);
+		cs_close(&handle.handle);
+	}
 }
 
-std::expected<std::vector<gdbw::Instruction*>, std::string> gdbw::Disassembler::Disasm(
-	const uint8_t* code, size_t len, size_t count, uint64_t address)
+void gdbw::Disassembler::SetMode(cs_mode mode)
 {
-	auto result = std::vector<Instruction*>(0);
-	csh handle;
-	cs_insn* insn;
+	// Same bytes decode differently in another mode
+	if (mode != m_mode)
+		m_cache.Flush();
+	m_mode = mode;
+}
 
-	if (count < 0)
-		return std::unexpected("Disassembler.Disasm cannot disassemble <0 instructions");
+std::expected<gdbw::Disassembler::Handle*, std::string> gdbw::Disassembler::GetHandle(void)
+{
+	for (auto& handle : m_handles)
+		if (handle.mode == m_mode)
+			return &handle;
 
-	if (cs_open(m_arch, m_mode, &handle) != cs_err::CS_ERR_OK)
+	Handle handle = { m_mode, 0, nullptr };
+	if (cs_open(m_arch, m_mode, &handle.handle) != cs_err::CS_ERR_OK)
 		return std::unexpected("Disassembler.Disasm failed to open capstone handle");
 
-	count = cs_disasm(handle, code, len, address, count, &insn);
-	if (count == 0)
+	handle.insn = cs_malloc(handle.handle);
+	if (handle.insn == nullptr)
 	{
-		std::string err = std::format("Disassembler.Disasm cs_disasm failed (0x{:#x})", (int)cs_errno(handle));
-		cs_free(insn, count);
-		cs_close(&handle);
-		return std::unexpected(err);
+		cs_close(&handle.handle);
+		return std::unexpected("Disassembler.Disasm failed to allocate instruction buffer");
 	}
 
-	result.reserve(count);
-	for (size_t i = 0; i < count; i++)
-		result.push_back(new Instruction(&insn[i]));
-
-	cs_free(insn, count);
-	cs_close(&handle);
-	return result;
+	m_handles.push_back(handle);
+	return &m_handles.back();
 }
 
+std::expected<size_t, std::string> gdbw::Disassembler::Disasm(
+	const uint8_t* code, size_t len, size_t count, InstructionBatch& out, uint64_t address)
+{
+	auto handle_result = GetHandle();
+	if (!handle_result)
+		return std::unexpected(handle_result.error());
+	Handle* handle = *handle_result;
 
+	// count == 0 disassembles the whole buffer, same as cs_disasm. Average x86 instruction
+	// is a little under 4 bytes, so that's a decent guess at how much to reserve.
+	out.Reserve(out.Size() + (count != 0 ? count : len / 4 + 1));
+
+	size_t decoded = 0;
+	while ((count == 0 || decoded < count) && len > 0)
+	{
+		auto cached = m_cache.Lookup(address, code, len);
+		if (cached != nullptr)
+		{
+			out.Add(address, m_cache.Mnemonic(cached), m_cache.OpStr(cached), cached->bytes, cached->size);
+			code += cached->size;
+			len -= cached->size;
+			address += cached->size;
+		}
+		else
+		{
+			// cs_disasm_iter advances code/len/address past the decoded instruction
+			if (!cs_disasm_iter(handle->handle, &code, &len, &address, handle->insn))
+				break;
+			m_cache.Store(handle->insn);
+			out.Add(handle->insn);
+		}
+		decoded++;
+	}
+
+	if (decoded == 0)
+		return std::unexpected(std::format("Disassembler.Disasm cs_disasm_iter failed (({:#x})", (int)cs_errno(handle->handle)));
+
+	return decoded;
+}
@@ -3,6 +3,7 @@
 #include <vector>
 #include "thirdparty/capstone/capstone/capstone.h"
 #include "Instruction.hpp"
+#include "InstructionCache.hpp"
 
 namespace gdbw
 {
@@ -11,14 +12,38 @@ namespace gdbw
 	public:
 		Disassembler(cs_arch arch, cs_mode mode);
 		~Disassembler();
-		// Disassemble a region of memory, stopping at the first invalid instruction.
-		// Returns vector of Instructions.
-		std::expected<std::vector<Instruction*>, std::string> Disasm(
-			const uint8_t* code, size_t len, size_t count, uint64_t address = 0x1000);
+		// Owns capstone handles & instruction buffers
+		Disassembler(const Disassembler&) = delete;
+		Disassembler& operator=(const Disassembler&) = delete;
+		// Switch the mode used by Disasm (e.g. CS_MODE_32 <-> CS_MODE_64).
+		// Handles are opened on first use and kept for the lifetime of the Disassembler.
+		void SetMode(cs_mode mode);
+		// Get the decoded instruction cache, used for invalidation when memory changes
+		inline InstructionCache* GetCache(void) { return &m_cache; }
+		// Disassemble a region of memory into `out`, stopping at the first invalid instruction.
+		// Instructions whose bytes haven't changed since they were last decoded come from the cache.
+		// Returns the number of instructions decoded.
+		std::expected<size_t, std::string> Disasm(
+			const uint8_t* code, size_t len, size_t count, InstructionBatch& out, uint64_t address = 0x1000);
+		// Cleared batch reused between calls, so its string pool & instruction storage are only allocated
+		// once. Valid until the next call.
+		inline InstructionBatch& ScratchBatch(void) { m_batch.Clear(); return m_batch; }
 	private:
+		// Capstone handle + reusable instruction buffer for a single mode
+		struct Handle
+		{
+			cs_mode mode;
+			csh handle;
+			cs_insn* insn;
+		};
+
+		// Get (or open) the handle for the current mode
+		std::expected<Handle*, std::string> GetHandle(void);
+
 		cs_arch m_arch;
 		cs_mode m_mode;
+		std::vector<Handle> m_handles;
+		InstructionCache m_cache;
+		InstructionBatch m_batch;
 	};
 }
-
-
@@ -0,0 +1,418 @@
+#include "DumpTarget.hpp"
+#include <map>
+
+// Windows values, regions are reported the same way regardless of backend
+static constexpr uint32_t PageReadOnly = 0x02;
+static constexpr uint32_t PageReadWrite = 0x04;
+static constexpr uint32_t PageExecuteRead = 0x20;
+static constexpr uint32_t PageExecuteReadWrite = 0x40;
+static constexpr uint32_t MemCommit = 0x1000;
+static constexpr uint32_t MemPrivate = 0x20000;
+static constexpr uint32_t MemMapped = 0x40000;
+static constexpr uint32_t MemImage = 0x1000000;
+
+//
+// Minidump layout (minidumpapiset.h), redeclared so dumps can be opened on any platform
+//
+
+static constexpr uint32_t MinidumpSignature = 0x504D444D; // "MDMP"
+static constexpr uint32_t ThreadListStream = 3;
+static constexpr uint32_t ModuleListStream = 4;
+static constexpr uint32_t MemoryListStream = 5;
+static constexpr uint32_t ExceptionStream = 6;
+static constexpr uint32_t SystemInfoStream = 7;
+static constexpr uint32_t Memory64ListStream = 9;
+static constexpr uint32_t MemoryInfoListStream = 16;
+static constexpr uint16_t ProcessorArchitectureAmd64 = 9;
+
+#pragma pack(push, 4)
+struct MdHeader { uint32_t signature, version, streams, directoryrva, checksum, timestamp; uint64_t flags; };
+struct MdLocation { uint32_t size, rva; };
+struct MdDirectory { uint32_t type; MdLocation location; };
+struct MdMemoryDescriptor { uint64_t start; MdLocation memory; };
+struct MdMemoryDescriptor64 { uint64_t start, size; };
+struct MdMemoryInfoList { uint32_t headersize, entrysize; uint64_t count; };
+struct MdMemoryInfo { uint64_t base, allocationbase; uint32_t allocationprotect, alignment1; uint64_t size; uint32_t state, protect, type, alignment2; };
+struct MdThread { uint32_t id, suspendcount, priorityclass, priority; uint64_t teb; MdMemoryDescriptor stack; MdLocation context; };
+struct MdModule { uint64_t base; uint32_t size, checksum, timestamp, namerva; uint8_t versioninfo[52]; MdLocation cvrecord, miscrecord; uint64_t reserved0, reserved1; };
+struct MdException { uint32_t threadid, alignment; uint32_t code, flags; uint64_t record, address; uint32_t parameters, alignment2; uint64_t information[15]; MdLocation context; };
+#pragma pack(pop)
+static_assert(sizeof(MdModule) == 108 && sizeof(MdThread) == 48 && sizeof(MdException) == 168);
+
+// CONTEXT offsets of GP64Registers / GP32Registers
+static constexpr uint32_t Amd64ContextOffsets[] = { 0x78, 0x90, 0x80, 0x88, 0xA8, 0xB0, 0xF8, 0x98, 0xA0, 0xB8, 0xC0, 0xC8, 0xD0, 0xD8, 0xE0, 0xE8, 0xF0 };
+static constexpr uint32_t X86ContextOffsets[] = { 0xB0, 0xA4, 0xAC, 0xA8, 0xA0, 0x9C, 0xB8, 0xC4, 0xB4 };
+
+//
+// ELF core layout (elf.h), same reason
+//
+
+static constexpr uint16_t ElfCore = 4;
+static constexpr uint16_t ElfMachineX86_64 = 62;
+static constexpr uint32_t ElfLoad = 1;
+static constexpr uint32_t ElfNote = 4;
+static constexpr uint32_t NotePrStatus = 1;
+static constexpr uint32_t NoteFile = 0x46494C45;
+// offsetof(struct elf_prstatus, pr_pid / pr_reg) on x86-64
+static constexpr uint64_t PrStatusPidOffset = 32;
+static constexpr uint64_t PrStatusRegsOffset = 112;
+
+struct ElfHeader { uint8_t ident[16]; uint16_t type, machine; uint32_t version; uint64_t entry, phoff, shoff; uint32_t flags; uint16_t ehsize, phentsize, phnum, shentsize, shnum, shstrndx; };
+struct ElfProgramHeader { uint32_t type, flags; uint64_t offset, vaddr, paddr, filesz, memsz, align; };
+struct ElfNoteHeader { uint32_t namesz, descsz, type; };
+
+// user_regs_struct indices of GP64Registers
+static constexpr uint32_t CoreRegIndices[] = { 10, 5, 11, 12, 13, 14, 16, 19, 4, 9, 8, 7, 6, 3, 2, 1, 0 };
+
+std::expected<bool, std::string> gdbw::DumpTarget::Open(const std::string& path)
+{
+	auto opened = m_file.Open(path);
+	if (!opened) return opened;
+
+	uint32_t magic = 0;
+	if (!Get(0, &magic))
+		return std::unexpected(std::format("DumpTarget.Open {} is too small", path));
+
+	std::expected<bool, std::string> loaded;
+	if (magic == MinidumpSignature)
+		loaded = LoadMinidump();
+	else if (magic == 0x464C457F) // "\x7FELF"
+		loaded = LoadCore();
+	else
+		return std::unexpected(std::format("DumpTarget.Open {} is not a minidump or core file", path));
+	if (!loaded) return loaded;
+
+	std::sort(m_ranges.begin(), m_ranges.end(), [](const Range& a, const Range& b) { return a.address < b.address; });
+	std::sort(m_regions.begin(), m_regions.end(), [](const TargetRegion& a, const TargetRegion& b) { return a.baseaddress < b.baseaddress; });
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::DumpTarget::LoadMinidump(void)
+{
+	MdHeader header = { 0 };
+	if (!Get(0, &header))
+		return std::unexpected("DumpTarget truncated minidump header");
+
+	std::map<uint32_t, MdLocation> streams;
+	for (uint32_t i = 0; i < header.streams; i++)
+	{
+		MdDirectory entry = { 0 };
+		if (!Get(header.directoryrva + (uint64_t)i * sizeof(MdDirectory), &entry))
+			return std::unexpected("DumpTarget truncated minidump stream directory");
+		streams.try_emplace(entry.type, entry.location);
+	}
+
+	uint16_t architecture = ProcessorArchitectureAmd64;
+	if (streams.contains(SystemInfoStream))
+		Get(streams[SystemInfoStream].rva, &architecture);
+	m_is64 = architecture == ProcessorArchitectureAmd64;
+
+	// Full memory dumps store every range back to back after the descriptors
+	if (streams.contains(Memory64ListStream))
+	{
+		uint64_t count = 0, offset = 0;
+		uint64_t rva = streams[Memory64ListStream].rva;
+		if (!Get(rva, &count) || !Get(rva + 8, &offset))
+			return std::unexpected("DumpTarget truncated memory64 list");
+		for (uint64_t i = 0; i < count; i++)
+		{
+			MdMemoryDescriptor64 descriptor = { 0 };
+			if (!Get(rva + 16 + i * sizeof(descriptor), &descriptor))
+				return std::unexpected("DumpTarget truncated memory64 list");
+			if (m_file.At(offset, descriptor.size))
+				m_ranges.push_back({ descriptor.start, descriptor.size, offset });
+			offset += descriptor.size;
+		}
+	}
+	if (streams.contains(MemoryListStream))
+	{
+		uint32_t count = 0;
+		uint64_t rva = streams[MemoryListStream].rva;
+		if (!Get(rva, &count))
+			return std::unexpected("DumpTarget truncated memory list");
+		for (uint32_t i = 0; i < count; i++)
+		{
+			MdMemoryDescriptor descriptor = { 0 };
+			if (!Get(rva + 4 + (uint64_t)i * sizeof(descriptor), &descriptor))
+				return std::unexpected("DumpTarget truncated memory list");
+			if (m_file.At(descriptor.memory.rva, descriptor.memory.size))
+				m_ranges.push_back({ descriptor.start, descriptor.memory.size, descriptor.memory.rva });
+		}
+	}
+
+	// Without the memory info list all we know is which ranges were saved
+	if (streams.contains(MemoryInfoListStream))
+	{
+		MdMemoryInfoList list = { 0 };
+		uint64_t rva = streams[MemoryInfoListStream].rva;
+		if (!Get(rva, &list) || list.entrysize < sizeof(MdMemoryInfo))
+			return std::unexpected("DumpTarget truncated memory info list");
+		for (uint64_t i = 0; i < list.count; i++)
+		{
+			MdMemoryInfo info = { 0 };
+			if (!Get(rva + list.headersize + i * list.entrysize, &info))
+				return std::unexpected("DumpTarget truncated memory info list");
+			if (info.state & MemCommit)
+				m_regions.push_back({ info.base, info.allocationbase, info.size, info.protect, info.state, info.type });
+		}
+	}
+	else
+	{
+		for (auto& range : m_ranges)
+			m_regions.push_back({ range.address, range.address, range.size, PageReadWrite, MemCommit, MemPrivate });
+	}
+
+	if (streams.contains(ModuleListStream))
+	{
+		uint32_t count = 0;
+		uint64_t rva = streams[ModuleListStream].rva;
+		if (!Get(rva, &count))
+			return std::unexpected("DumpTarget truncated module list");
+		for (uint32_t i = 0; i < count; i++)
+		{
+			MdModule module = { 0 };
+			uint32_t namelen = 0;
+			if (!Get(rva + 4 + (uint64_t)i * sizeof(module), &module) || !Get(module.namerva, &namelen))
+				return std::unexpected("DumpTarget truncated module list");
+
+			// MINIDUMP_STRING is UTF-16, module paths are near enough always ASCII
+			std::string name;
+			const uint8_t* wide = m_file.At(module.namerva + 4, namelen);
+			for (uint32_t j = 0; wide && j + 1 < namelen; j += 2)
+			{
+				uint16_t c = (uint16_t)(wide[j] | wide[j + 1] << 8);
+				name.push_back(c < 0x80 ? (char)c : '?');
+			}
+			m_modules.push_back({ module.base, module.size, name });
+		}
+	}
+
+	// Every thread's registers, the faulting thread (or the first one if the dump has no exception)
+	// goes first. Its context from the exception stream is the one at the fault, the thread list has
+	// it somewhere inside exception dispatch.
+	MdException exception = { 0 };
+	bool faulted = streams.contains(ExceptionStream) && Get(streams[ExceptionStream].rva, &exception);
+	if (faulted)
+		m_threads.push_back({ exception.threadid, MinidumpContext(exception.context.rva, exception.context.size) });
+	if (streams.contains(ThreadListStream))
+	{
+		uint32_t count = 0;
+		uint64_t rva = streams[ThreadListStream].rva;
+		if (!Get(rva, &count))
+			return std::unexpected("DumpTarget truncated thread list");
+		for (uint32_t i = 0; i < count; i++)
+		{
+			MdThread thread = { 0 };
+			if (!Get(rva + 4 + (uint64_t)i * sizeof(thread), &thread))
+				return std::unexpected("DumpTarget truncated thread list");
+			if (!faulted || thread.id != exception.threadid)
+				m_threads.push_back({ thread.id, MinidumpContext(thread.context.rva, thread.context.size) });
+		}
+	}
+	m_context = m_threads.empty() ? MinidumpContext(0, 0) : m_threads[0].context;
+	return true;
+}
+
+gdbw::DE::RegisterContext gdbw::DumpTarget::MinidumpContext(uint32_t rva, uint32_t size) const
+{
+	DE::RegisterContext context = { m_is64 ? DE::RegisterSet::GP64 : DE::RegisterSet::GP32, 0, nullptr, { 0 } };
+	context.count = DE::GetRegisterSetNames(context.set, &context.names);
+	uint32_t width = m_is64 ? 8 : 4;
+	for (size_t i = 0; i < context.count && size != 0; i++)
+	{
+		uint32_t offset = m_is64 ? Amd64ContextOffsets[i] : X86ContextOffsets[i];
+		const uint8_t* value = offset + width <= size ? m_file.At((uint64_t)rva + offset, width) : nullptr;
+		if (value) memcpy(&context.values[i], value, width);
+	}
+	return context;
+}
+
+std::expected<bool, std::string> gdbw::DumpTarget::LoadCore(void)
+{
+	ElfHeader header = { 0 };
+	if (!Get(0, &header) || header.ident[4] != 2 /* ELFCLASS64 */ || header.ident[5] != 1 /* little endian */)
+		return std::unexpected("DumpTarget only 64bit little endian core files are supported");
+	if (header.type != ElfCore || header.machine != ElfMachineX86_64)
+		return std::unexpected("DumpTarget ELF file isn't an x86-64 core file");
+	m_is64 = true;
+
+	m_context = { DE::RegisterSet::GP64, 0, nullptr, { 0 } };
+	m_context.count = DE::GetRegisterSetNames(m_context.set, &m_context.names);
+
+	struct FileMapping { uint64_t start, end; std::string name; };
+	std::vector<FileMapping> mappings;
+
+	for (uint16_t i = 0; i < header.phnum; i++)
+	{
+		ElfProgramHeader segment = { 0 };
+		if (!Get(header.phoff + (uint64_t)i * header.phentsize, &segment))
+			return std::unexpected("DumpTarget truncated program headers");
+
+		if (segment.type == ElfLoad)
+		{
+			// PF_X 1, PF_W 2, PF_R 4
+			bool x = segment.flags & 1, w = segment.flags & 2, r = segment.flags & 4;
+			uint32_t protections = x ? (w ? PageExecuteReadWrite : PageExecuteRead) : (w ? PageReadWrite : (r ? PageReadOnly : 0x01 /* PAGE_NOACCESS */));
+			m_regions.push_back({ segment.vaddr, segment.vaddr, segment.memsz, protections, MemCommit, MemPrivate });
+			// filesz is 0 for segments the kernel left out of the dump (e.g. unmodified file mappings)
+			if (segment.filesz != 0 && m_file.At(segment.offset, segment.filesz))
+				m_ranges.push_back({ segment.vaddr, std::min(segment.filesz, segment.memsz), segment.offset });
+		}
+		else if (segment.type == ElfNote)
+		{
+			uint64_t offset = segment.offset;
+			uint64_t end = segment.offset + segment.filesz;
+			ElfNoteHeader note = { 0 };
+			while (offset + sizeof(note) <= end && Get(offset, &note))
+			{
+				uint64_t desc = offset + sizeof(note) + ((note.namesz + 3) & ~3ull);
+				offset = desc + ((note.descsz + 3) & ~3ull);
+
+				// One NT_PRSTATUS per thread, the first is the thread that crashed
+				if (note.type == NotePrStatus)
+				{
+					uint32_t pid = 0;
+					const uint8_t* regs = m_file.At(desc + PrStatusRegsOffset, 27 * sizeof(uint64_t));
+					if (!regs || !Get(desc + PrStatusPidOffset, &pid)) continue;
+					Thread thread = { pid, m_context };
+					for (size_t j = 0; j < thread.context.count; j++)
+						memcpy(&thread.context.values[j], regs + CoreRegIndices[j] * sizeof(uint64_t), sizeof(uint64_t));
+					m_threads.push_back(thread);
+				}
+				// NT_FILE: count, page size, {start, end, file offset}[count], then the names
+				else if (note.type == NoteFile)
+				{
+					uint64_t count = 0;
+					if (!Get(desc, &count) || note.descsz < 16 || count > (note.descsz - 16) / 24)
+						continue;
+					const char* names = (const char*)m_file.At(desc + 16 + count * 24, note.descsz - 16 - count * 24);
+					const char* namesend = names ? names + (note.descsz - 16 - count * 24) : nullptr;
+					for (uint64_t j = 0; j < count && names && names < namesend; j++)
+					{
+						uint64_t range[2] = { 0 };
+						Get(desc + 16 + j * 24, &range);
+						size_t len = strnlen(names, namesend - names);
+						mappings.push_back({ range[0], range[1], std::string(names, len) });
+						names += len + 1;
+					}
+				}
+			}
+		}
+	}
+
+	// Group file mappings into modules, a file with any executable mapping is an image
+	std::map<std::string, std::pair<uint64_t, uint64_t>> files; // name -> [start, end)
+	for (auto& mapping : mappings)
+	{
+		auto [it, inserted] = files.try_emplace(mapping.name, mapping.start, mapping.end);
+		it->second.first = std::min(it->second.first, mapping.start);
+		it->second.second = std::max(it->second.second, mapping.end);
+	}
+	std::sort(m_regions.begin(), m_regions.end(), [](const TargetRegion& a, const TargetRegion& b) { return a.baseaddress < b.baseaddress; });
+	for (auto& [name, extent] : files)
+	{
+		bool executable = false;
+		for (auto& region : m_regions)
+		{
+			if (region.baseaddress >= extent.first && region.baseaddress < extent.second)
+				executable |= region.protections == PageExecuteRead || region.protections == PageExecuteReadWrite;
+		}
+		for (auto& region : m_regions)
+		{
+			if (region.baseaddress < extent.first || region.baseaddress >= extent.second)
+				continue;
+			region.allocationbase = extent.first;
+			region.type = executable ? MemImage : MemMapped;
+		}
+		if (executable)
+			m_modules.push_back({ extent.first, extent.second - extent.first, name });
+	}
+	if (!m_threads.empty())
+		m_context = m_threads[0].context;
+	return true;
+}
+
+std::expected<uint32_t, std::string> gdbw::DumpTarget::ReadMemory(uint64_t address, uint32_t len, void* out)
+{
+	uint8_t* dst = (uint8_t*)out;
+	uint32_t done = 0;
+	while (done < len)
+	{
+		uint64_t current = address + done;
+		ptrdiff_t i = Find(current);
+		if (i < 0)
+		{
+			if (done == 0)
+				return std::unexpected(std::format("DumpTarget.ReadMemory memory at {:#x} not in dump", current));
+			break; // short read, same as a live target would give us
+		}
+
+		const Range& range = m_ranges[i];
+		uint64_t offset = current - range.address;
+		uint32_t chunk = (uint32_t)std::min<uint64_t>(range.size - offset, len - done);
+		memcpy(dst + done, m_file.Data() + range.offset + offset, chunk);
+		done += chunk;
+	}
+	return done;
+}
+
+std::expected<uint32_t, std::string> gdbw::DumpTarget::WriteMemory(uint64_t address, uint32_t len, const void* in)
+{
+	return std::unexpected("DumpTarget.WriteMemory dumps are read only");
+}
+
+std::expected<std::vector<gdbw::TargetRegion>, std::string> gdbw::DumpTarget::GetRegions(void)
+{
+	return m_regions;
+}
+
+std::expected<gdbw::DE::RegisterContext, std::string> gdbw::DumpTarget::GetRegisters(DE::RegisterSet set)
+{
+	if (set != m_context.set)
+		return std::unexpected("DumpTarget.GetRegisters register set not in dump");
+	return m_context;
+}
+
+std::expected<std::vector<gdbw::TargetModule>, std::string> gdbw::DumpTarget::GetModules(void)
+{
+	return m_modules;
+}
+
+std::vector<uint32_t> gdbw::DumpTarget::GetThreads(void)
+{
+	std::vector<uint32_t> ids;
+	ids.reserve(m_threads.size());
+	for (auto& thread : m_threads)
+		ids.push_back(thread.id);
+	return ids;
+}
+
+std::expected<bool, std::string> gdbw::DumpTarget::SetThread(uint32_t id)
+{
+	auto it = std::find_if(m_threads.begin(), m_threads.end(), [id](const Thread& thread) { return thread.id == id; });
+	if (it == m_threads.end())
+		return std::unexpected(std::format("DumpTarget.SetThread no thread {} in dump", id));
+	m_context = it->context;
+	return true;
+}
+
+const uint8_t* gdbw::DumpTarget::View(uint64_t address, uint32_t len)
+{
+	// Only reads that fall inside a single saved range, anything else takes the copying path
+	ptrdiff_t i = Find(address);
+	if (i < 0 || len > m_ranges[i].size - (address - m_ranges[i].address))
+		return nullptr;
+	return m_file.Data() + m_ranges[i].offset + (address - m_ranges[i].address);
+}
+
+ptrdiff_t gdbw::DumpTarget::Find(uint64_t address) const
+{
+	auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+		[](uint64_t addr, const Range& range) { return addr < range.address; });
+	if (it == m_ranges.begin())
+		return -1;
+	--it;
+	if (address - it->address >= it->size)
+		return -1;
+	return it - m_ranges.begin();
+}
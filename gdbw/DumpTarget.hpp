@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include "MappedFile.hpp"
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Post-mortem target for a Windows minidump or an x86-64 ELF core file.
+	// The file is memory mapped and memory is served straight out of the mapping, regions,
+	// modules & every saved thread's registers come from the dump's streams/notes. The faulting
+	// thread is current to begin with.
+	class DumpTarget : public Target
+	{
+	public:
+		DumpTarget() = default;
+		~DumpTarget() = default;
+
+		// Open a dump, the format is detected from its magic
+		std::expected<bool, std::string> Open(const std::string& path);
+
+		std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override;
+		std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override;
+		std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) override;
+		std::expected<DE::RegisterContext, std::string> GetRegisters(DE::RegisterSet set) override;
+		std::expected<std::vector<TargetModule>, std::string> GetModules(void) override;
+		inline bool Is64Bit(void) override { return m_is64; }
+		const uint8_t* View(uint64_t address, uint32_t len) override;
+		std::vector<uint32_t> GetThreads(void) override;
+		std::expected<bool, std::string> SetThread(uint32_t id) override;
+	private:
+		// Memory saved in the dump
+		struct Range
+		{
+			uint64_t address;
+			uint64_t size;
+			uint64_t offset; // file offset
+		};
+
+		// Registers of a saved thread
+		struct Thread
+		{
+			uint32_t id;
+			DE::RegisterContext context;
+		};
+
+		std::expected<bool, std::string> LoadMinidump(void);
+		// Decode a minidump CONTEXT
+		DE::RegisterContext MinidumpContext(uint32_t rva, uint32_t size) const;
+		std::expected<bool, std::string> LoadCore(void);
+		// Read a plain struct out of the file
+		template <typename T>
+		inline bool Get(uint64_t offset, T* out) const
+		{
+			const uint8_t* data = m_file.At(offset, sizeof(T));
+			if (data) memcpy(out, data, sizeof(T));
+			return data != nullptr;
+		}
+		// Index of the range containing `address`, or -1
+		ptrdiff_t Find(uint64_t address) const;
+
+		MappedFile m_file;
+		bool m_is64 = true;
+		std::vector<Range> m_ranges; // sorted by address
+		std::vector<TargetRegion> m_regions;
+		std::vector<TargetModule> m_modules;
+		std::vector<Thread> m_threads; // current thread first
+		DE::RegisterContext m_context = { DE::RegisterSet::COUNT, 0, nullptr, { 0 } }; // current thread's
+	};
+}
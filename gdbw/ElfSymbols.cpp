@@ -0,0 +1,140 @@
+#ifdef __linux__
+#include "ElfSymbols.hpp"
+#include <algorithm>
+#include <cstring>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+std::expected<bool, std::string> gdbw::ElfSymbols::Load(const std::string& path, uint64_t base)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return std::unexpected(std::format("ElfSymbols.Load failed to open {}", path));
+	struct stat st = { 0 };
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Elf64_Ehdr))
+	{
+		close(fd);
+		return std::unexpected(std::format("ElfSymbols.Load {} is too small", path));
+	}
+
+	// Only the section & symbol tables are touched, map rather than read the whole image
+	size_t filesize = st.st_size;
+	const uint8_t* image = (const uint8_t*)mmap(nullptr, filesize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (image == MAP_FAILED)
+		return std::unexpected(std::format("ElfSymbols.Load failed to map {}", path));
+
+	auto fail = [&](const char* reason) -> std::expected<bool, std::string> {
+		munmap((void*)image, filesize);
+		return std::unexpected(std::format("ElfSymbols.Load {}: {}", path, reason));
+	};
+
+	const Elf64_Ehdr* ehdr = (const Elf64_Ehdr*)image;
+	if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_ident[EI_CLASS] != ELFCLASS64)
+		return fail("not a 64bit ELF");
+	if (ehdr->e_shoff == 0 || ehdr->e_shentsize != sizeof(Elf64_Shdr)
+		|| ehdr->e_shoff + (uint64_t)ehdr->e_shnum * sizeof(Elf64_Shdr) > filesize)
+		return fail("bad section table");
+	if (ehdr->e_phoff + (uint64_t)ehdr->e_phnum * sizeof(Elf64_Phdr) > filesize)
+		return fail("bad program header table");
+
+	// Shared objects & PIEs are linked at 0, the load bias is wherever the first segment landed
+	uint64_t bias = 0;
+	if (ehdr->e_type == ET_DYN)
+	{
+		const Elf64_Phdr* phdrs = (const Elf64_Phdr*)(image + ehdr->e_phoff);
+		uint64_t lowest = UINT64_MAX;
+		for (size_t i = 0; i < ehdr->e_phnum; i++)
+			if (phdrs[i].p_type == PT_LOAD)
+				lowest = std::min(lowest, phdrs[i].p_vaddr & ~(uint64_t)0xFFF);
+		if (lowest != UINT64_MAX)
+			bias = base - lowest;
+	}
+
+	const Elf64_Shdr* shdrs = (const Elf64_Shdr*)(image + ehdr->e_shoff);
+	const Elf64_Shdr* symtab = nullptr;
+	for (size_t i = 0; i < ehdr->e_shnum; i++)
+	{
+		if (shdrs[i].sh_type == SHT_SYMTAB)
+			symtab = &shdrs[i];
+		else if (shdrs[i].sh_type == SHT_DYNSYM && symtab == nullptr)
+			symtab = &shdrs[i];
+	}
+	if (symtab == nullptr)
+		return fail("no symbol table");
+	if (symtab->sh_link >= ehdr->e_shnum
+		|| symtab->sh_offset + symtab->sh_size > filesize)
+		return fail("bad symbol table");
+
+	const Elf64_Shdr* strtab = &shdrs[symtab->sh_link];
+	if (strtab->sh_offset + strtab->sh_size > filesize)
+		return fail("bad string table");
+	const char* strings = (const char*)(image + strtab->sh_offset);
+
+	struct Entry
+	{
+		uint64_t address;
+		uint32_t size;
+		const char* name;
+	};
+	std::vector<Entry> entries;
+	const Elf64_Sym* syms = (const Elf64_Sym*)(image + symtab->sh_offset);
+	size_t count = symtab->sh_size / sizeof(Elf64_Sym);
+	entries.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Elf64_Sym& sym = syms[i];
+		int type = ELF64_ST_TYPE(sym.st_info);
+		if ((type != STT_FUNC && type != STT_OBJECT) || sym.st_shndx == SHN_UNDEF
+			|| sym.st_value == 0 || sym.st_name >= strtab->sh_size)
+			continue;
+		const char* name = strings + sym.st_name;
+		if (*name == 0 || memchr(name, 0, strtab->sh_size - sym.st_name) == nullptr)
+			continue;
+		entries.push_back({ sym.st_value + bias, (uint32_t)sym.st_size, name });
+	}
+
+	// Symbols starting inside an earlier one (aliases, local labels) are only reachable by name
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.address < b.address; });
+	m_ranges.clear();
+	m_ranges.reserve(entries.size());
+	m_names.Clear();
+	m_byname.clear();
+	m_base = base;
+	for (auto& entry : entries)
+	{
+		m_byname.try_emplace(entry.name, entry.address);
+		if (!m_ranges.empty() && entry.address < m_ranges.back().end)
+			continue;
+		uint64_t end = entry.address + std::max<uint64_t>(entry.size, 1);
+		m_ranges.push_back({ entry.address, end, entry.size, m_names.Intern(entry.name) });
+	}
+
+	munmap((void*)image, filesize);
+	return true;
+}
+
+std::optional<gdbw::Symbol> gdbw::ElfSymbols::Lookup(uint64_t address) const
+{
+	auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+		[](uint64_t value, const Range& range) { return value < range.start; });
+	if (it == m_ranges.begin())
+		return std::nullopt;
+	--it;
+	if (address >= it->end)
+		return std::nullopt;
+	return Symbol(it->start, address - it->start, 0, m_base, m_names.Get(it->name), it->size);
+}
+
+std::optional<uint64_t> gdbw::ElfSymbols::FromName(const std::string& name) const
+{
+	auto it = m_byname.find(name);
+	if (it == m_byname.end())
+		return std::nullopt;
+	return it->second;
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+#ifdef __linux__
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "StringPool.hpp"
+#include "SymbolCache.hpp"
+
+namespace gdbw
+{
+	// Symbols of a single ELF image, read from .symtab (or .dynsym if the image is stripped)
+	class ElfSymbols
+	{
+	public:
+		ElfSymbols() = default;
+		~ElfSymbols() = default;
+
+		// Load symbols from the ELF at `path`, mapped at `base` in the target
+		std::expected<bool, std::string> Load(const std::string& path, uint64_t base);
+		// Symbol containing `address`
+		std::optional<Symbol> Lookup(uint64_t address) const;
+		// Address of the symbol called `name`
+		std::optional<uint64_t> FromName(const std::string& name) const;
+
+		inline size_t Size(void) const { return m_ranges.size(); }
+	private:
+		struct Range
+		{
+			uint64_t start;
+			uint64_t end;  // exclusive, start + 1 for unsized symbols
+			uint32_t size;
+			uint32_t name; // StringPool id
+		};
+
+		// Not a SymbolCache, an image's table is loaded once and must never be flushed (see SymbolCache::MaxNames)
+		std::vector<Range> m_ranges; // sorted by start, non-overlapping
+		StringPool m_names;
+		std::unordered_map<std::string, uint64_t> m_byname;
+		uint64_t m_base = 0;
+	};
+}
+#endif
@@ -0,0 +1,594 @@
+#ifdef _WIN32
+// Must come before anything that pulls in Windows.h
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include "GdbRemoteTarget.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+#else
+using socket_t = int;
+static constexpr socket_t INVALID_SOCKET = -1;
+static inline int closesocket(socket_t s) { return close(s); }
+#endif
+
+// Windows values, regions are reported the same way regardless of backend
+static constexpr uint32_t PageReadOnly = 0x02;
+static constexpr uint32_t PageReadWrite = 0x04;
+static constexpr uint32_t MemCommit = 0x1000;
+static constexpr uint32_t MemPrivate = 0x20000;
+
+// `g` packet offsets (in registers) of GP64Registers / GP32Registers, gdb orders them differently
+static constexpr size_t GP64GdbIndices[] = { 0, 1, 2, 3, 4, 5, 16, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+static constexpr size_t GP32GdbIndices[] = { 0, 3, 1, 2, 6, 7, 8, 4, 5 };
+
+static int HexValue(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+// Decode hex into `out`, returns the number of bytes decoded. Unavailable bytes ("xx") decode as 0.
+static size_t HexDecode(std::string_view hex, uint8_t* out, size_t max)
+{
+	size_t n = 0;
+	for (; n < max && n * 2 + 1 < hex.size(); n++)
+	{
+		int hi = HexValue(hex[n * 2]), lo = HexValue(hex[n * 2 + 1]);
+		out[n] = (hi < 0 || lo < 0) ? 0 : (uint8_t)(hi << 4 | lo);
+	}
+	return n;
+}
+
+static std::string HexEncode(const uint8_t* data, size_t len)
+{
+	static constexpr char digits[] = "0123456789abcdef";
+	std::string hex(len * 2, '0');
+	for (size_t i = 0; i < len; i++)
+	{
+		hex[i * 2] = digits[data[i] >> 4];
+		hex[i * 2 + 1] = digits[data[i] & 0xF];
+	}
+	return hex;
+}
+
+// Value of `name="..."` within an xml element
+static std::string XmlAttribute(std::string_view element, std::string_view name)
+{
+	std::string key = std::string(name) + "=\"";
+	size_t start = element.find(key);
+	if (start == std::string_view::npos)
+		return "";
+	start += key.size();
+	size_t end = element.find('"', start);
+	if (end == std::string_view::npos)
+		return "";
+	return std::string(element.substr(start, end - start));
+}
+
+static uint64_t ParseNumber(const std::string& str)
+{
+	return strtoull(str.c_str(), nullptr, 0);
+}
+
+gdbw::GdbRemoteTarget::~GdbRemoteTarget()
+{
+	if ((socket_t)m_socket != INVALID_SOCKET)
+		closesocket((socket_t)m_socket);
+}
+
+std::expected<bool, std::string> gdbw::GdbRemoteTarget::Connect(const std::string& host, uint16_t port)
+{
+#ifdef _WIN32
+	WSADATA wsadata = { 0 };
+	if (WSAStartup(MAKEWORD(2, 2), &wsadata) != 0)
+		return std::unexpected("GdbRemoteTarget.Connect WSAStartup failed");
+#endif
+	addrinfo hints = { 0 };
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* results = nullptr;
+	if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0)
+		return std::unexpected(std::format("GdbRemoteTarget.Connect failed to resolve {}", host));
+
+	socket_t s = INVALID_SOCKET;
+	for (addrinfo* ai = results; ai != nullptr; ai = ai->ai_next)
+	{
+		s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (s == INVALID_SOCKET)
+			continue;
+		if (connect(s, ai->ai_addr, (int)ai->ai_addrlen) == 0)
+			break;
+		closesocket(s);
+		s = INVALID_SOCKET;
+	}
+	freeaddrinfo(results);
+	if (s == INVALID_SOCKET)
+		return std::unexpected(std::format("GdbRemoteTarget.Connect failed to connect to {}:{}", host, port));
+
+	// Packets are small & latency bound
+	int nodelay = 1;
+	setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+	m_socket = (uint64_t)s;
+
+	auto supported = Request("qSupported:swbreak+;hwbreak+;xmlRegisters=i386");
+	if (!supported) return std::unexpected(supported.error());
+
+	bool noack = false;
+	bool xferfeatures = false;
+	std::string_view features = *supported;
+	while (!features.empty())
+	{
+		size_t end = features.find(';');
+		std::string_view feature = features.substr(0, end);
+		features = end == std::string_view::npos ? std::string_view() : features.substr(end + 1);
+
+		if (feature.starts_with("PacketSize="))
+			m_packetsize = std::max<size_t>(strtoull(std::string(feature.substr(11)).c_str(), nullptr, 16), 64);
+		else if (feature == "QStartNoAckMode+")
+			noack = true;
+		else if (feature == "qXfer:memory-map:read+")
+			m_xfermemorymap = true;
+		else if (feature == "qXfer:libraries:read+")
+			m_xferlibraries = true;
+		else if (feature == "qXfer:libraries-svr4:read+")
+			m_xferlibrariessvr4 = true;
+		else if (feature == "qXfer:features:read+")
+			xferfeatures = true;
+	}
+
+	if (noack)
+	{
+		auto reply = Request("QStartNoAckMode");
+		if (reply && *reply == "OK")
+			m_noack = true;
+	}
+
+	// Stubs without a target description are assumed to be 64bit
+	if (xferfeatures)
+	{
+		auto description = ReadXfer("features", "target.xml");
+		if (description && description->find("<architecture>i386</architecture>") != std::string::npos)
+			m_is64 = false;
+	}
+
+	// Stop reason also tells us the target is alive
+	auto stop = Request("?");
+	if (!stop) return std::unexpected(stop.error());
+	if (stop->empty() || stop->front() == 'W' || stop->front() == 'X')
+		return std::unexpected("GdbRemoteTarget.Connect target is not running");
+	return true;
+}
+
+void gdbw::GdbRemoteTarget::Interrupt(void)
+{
+	// Raw ^C, not a packet
+	char c = 0x03;
+	send((socket_t)m_socket, &c, 1, 0);
+}
+
+std::expected<uint32_t, std::string> gdbw::GdbRemoteTarget::ReadMemory(uint64_t address, uint32_t len, void* out)
+{
+	// Replies are hex encoded, leave room for framing
+	uint32_t chunk = (uint32_t)std::max<size_t>((m_packetsize - 16) / 2, 1);
+	std::vector<std::string> requests;
+	for (uint32_t offset = 0; offset < len; offset += chunk)
+		requests.push_back(std::format("m{:x},{:x}", address + offset, std::min(chunk, len - offset)));
+
+	auto replies = RequestBatch(requests);
+	if (!replies) return std::unexpected(replies.error());
+
+	uint8_t* dst = (uint8_t*)out;
+	uint32_t done = 0;
+	for (auto& reply : *replies)
+	{
+		if (reply.empty() || reply[0] == 'E')
+			break;
+		uint32_t expected = std::min(chunk, len - done);
+		size_t n = HexDecode(reply, dst + done, expected);
+		done += (uint32_t)n;
+		if (n != expected)
+			break; // short read, everything after it is unreadable too
+	}
+	if (done == 0)
+		return std::unexpected(std::format("GdbRemoteTarget.ReadMemory failed to read memory at {:#x}", address));
+	return done;
+}
+
+std::expected<uint32_t, std::string> gdbw::GdbRemoteTarget::WriteMemory(uint64_t address, uint32_t len, const void* in)
+{
+	const uint8_t* src = (const uint8_t*)in;
+	uint32_t chunk = (uint32_t)std::max<size_t>((m_packetsize - 48) / 2, 1);
+	std::vector<std::string> requests;
+	for (uint32_t offset = 0; offset < len; offset += chunk)
+	{
+		uint32_t n = std::min(chunk, len - offset);
+		requests.push_back(std::format("M{:x},{:x}:", address + offset, n) + HexEncode(src + offset, n));
+	}
+
+	auto replies = RequestBatch(requests);
+	if (!replies) return std::unexpected(replies.error());
+
+	uint32_t done = 0;
+	for (auto& reply : *replies)
+	{
+		if (reply != "OK")
+			break;
+		done += std::min(chunk, len - done);
+	}
+	if (done == 0)
+		return std::unexpected(std::format("GdbRemoteTarget.WriteMemory failed to write memory at {:#x}", address));
+	return done;
+}
+
+std::expected<std::vector<gdbw::TargetRegion>, std::string> gdbw::GdbRemoteTarget::GetRegions(void)
+{
+	if (m_regionsvalid)
+		return m_regions;
+	if (!m_xfermemorymap)
+		return std::unexpected("GdbRemoteTarget.GetRegions stub doesn't provide a memory map");
+
+	auto map = ReadXfer("memory-map", "");
+	if (!map) return std::unexpected(map.error());
+
+	// <memory type="ram|rom|flash" start="0x..." length="0x..."/>
+	m_regions.clear();
+	size_t pos = 0;
+	while ((pos = map->find("<memory ", pos)) != std::string::npos)
+	{
+		size_t end = map->find('>', pos);
+		std::string_view element = std::string_view(*map).substr(pos, end - pos);
+		pos = end;
+
+		uint64_t start = ParseNumber(XmlAttribute(element, "start"));
+		uint64_t length = ParseNumber(XmlAttribute(element, "length"));
+		uint32_t protections = XmlAttribute(element, "type") == "ram" ? PageReadWrite : PageReadOnly;
+		if (length != 0)
+			m_regions.push_back({ start, start, length, protections, MemCommit, MemPrivate });
+	}
+	std::sort(m_regions.begin(), m_regions.end(),
+		[](const TargetRegion& a, const TargetRegion& b) { return a.baseaddress < b.baseaddress; });
+	m_regionsvalid = true;
+	return m_regions;
+}
+
+std::expected<gdbw::DE::RegisterContext, std::string> gdbw::GdbRemoteTarget::GetRegisters(DE::RegisterSet set)
+{
+	if (m_registers.empty())
+	{
+		auto reply = Request("g");
+		if (!reply) return std::unexpected(reply.error());
+		if (reply->empty() || (*reply)[0] == 'E')
+			return std::unexpected("GdbRemoteTarget.GetRegisters stub failed to read registers");
+		m_registers.resize(reply->size() / 2);
+		HexDecode(*reply, m_registers.data(), m_registers.size());
+	}
+
+	DE::RegisterContext context = { set, 0, nullptr, { 0 } };
+	context.count = DE::GetRegisterSetNames(set, &context.names);
+	const size_t* indices = set == DE::RegisterSet::GP64 ? GP64GdbIndices : GP32GdbIndices;
+	size_t width = set == DE::RegisterSet::GP64 ? 8 : 4;
+	if (context.count == 0 || (set == DE::RegisterSet::GP64) != m_is64)
+		return std::unexpected("GdbRemoteTarget.GetRegisters register set doesn't match target");
+
+	for (size_t i = 0; i < context.count; i++)
+	{
+		size_t offset = indices[i] * width;
+		if (offset + width > m_registers.size())
+			return std::unexpected("GdbRemoteTarget.GetRegisters register packet too short");
+		uint64_t value = 0;
+		memcpy(&value, m_registers.data() + offset, width); // target is little endian
+		context.values[i] = value;
+	}
+	return context;
+}
+
+std::expected<std::vector<gdbw::TargetModule>, std::string> gdbw::GdbRemoteTarget::GetModules(void)
+{
+	if (m_modulesvalid)
+		return m_modules;
+
+	m_modules.clear();
+	if (m_xferlibrariessvr4)
+	{
+		// <library name="..." lm="0x..." l_addr="0x..." l_ld="0x..."/>
+		auto list = ReadXfer("libraries-svr4", "");
+		if (!list) return std::unexpected(list.error());
+		size_t pos = 0;
+		while ((pos = list->find("<library ", pos)) != std::string::npos)
+		{
+			size_t end = list->find('>', pos);
+			std::string_view element = std::string_view(*list).substr(pos, end - pos);
+			pos = end;
+			m_modules.push_back({ ParseNumber(XmlAttribute(element, "l_addr")), 0, XmlAttribute(element, "name") });
+		}
+	}
+	else if (m_xferlibraries)
+	{
+		// <library name="..."><segment address="0x..."/></library>
+		auto list = ReadXfer("libraries", "");
+		if (!list) return std::unexpected(list.error());
+		size_t pos = 0;
+		while ((pos = list->find("<library ", pos)) != std::string::npos)
+		{
+			size_t end = list->find("</library>", pos);
+			std::string_view element = std::string_view(*list).substr(pos, end - pos);
+			pos = end;
+			size_t segment = element.find("<segment ");
+			uint64_t base = segment == std::string_view::npos ? 0 : ParseNumber(XmlAttribute(element.substr(segment), "address"));
+			m_modules.push_back({ base, 0, XmlAttribute(element, "name") });
+		}
+	}
+	m_modulesvalid = true;
+	return m_modules;
+}
+
+std::expected<int, std::string> gdbw::GdbRemoteTarget::Continue(void)
+{
+	InvalidateStop();
+	auto sent = Send("c");
+	if (!sent) return std::unexpected(sent.error());
+	return WaitForStop();
+}
+
+std::expected<int, std::string> gdbw::GdbRemoteTarget::StepInto(void)
+{
+	InvalidateStop();
+	auto sent = Send("s");
+	if (!sent) return std::unexpected(sent.error());
+	return WaitForStop();
+}
+
+std::expected<int, std::string> gdbw::GdbRemoteTarget::RunTo(uint64_t address)
+{
+	if (FindBreakpoint(address))
+		return Continue();
+
+	auto reply = Request(std::format("Z0,{:x},1", address));
+	if (!reply) return std::unexpected(reply.error());
+	if (*reply != "OK")
+		return std::unexpected(std::format("GdbRemoteTarget.RunTo stub refused breakpoint at {:#x}", address));
+
+	auto stop = Continue();
+	if (!stop || *stop < 0)
+		return stop;
+	reply = Request(std::format("z0,{:x},1", address));
+	if (!reply) return std::unexpected(reply.error());
+	return stop;
+}
+
+std::expected<uint32_t, std::string> gdbw::GdbRemoteTarget::SetBreakpoint(uint64_t address)
+{
+	if (auto existing = FindBreakpoint(address))
+		return *existing;
+
+	auto reply = Request(std::format("Z0,{:x},1", address));
+	if (!reply) return std::unexpected(reply.error());
+	if (*reply != "OK")
+		return std::unexpected(std::format("GdbRemoteTarget.SetBreakpoint stub refused breakpoint at {:#x}", address));
+
+	uint32_t id = m_nextbreakpoint++;
+	m_breakpoints[id] = address;
+	return id;
+}
+
+std::optional<uint32_t> gdbw::GdbRemoteTarget::FindBreakpoint(uint64_t address)
+{
+	for (auto& [id, bp] : m_breakpoints)
+		if (bp == address)
+			return id;
+	return std::nullopt;
+}
+
+std::expected<bool, std::string> gdbw::GdbRemoteTarget::ClearBreakpoint(uint32_t id)
+{
+	auto it = m_breakpoints.find(id);
+	if (it == m_breakpoints.end())
+		return std::unexpected("Invalid breakpoint id");
+
+	auto reply = Request(std::format("z0,{:x},1", it->second));
+	if (!reply) return std::unexpected(reply.error());
+	if (*reply != "OK")
+		return std::unexpected("GdbRemoteTarget.ClearBreakpoint stub failed to remove breakpoint");
+	m_breakpoints.erase(it);
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::GdbRemoteTarget::Send(std::string_view payload)
+{
+	uint8_t checksum = 0;
+	for (char c : payload)
+		checksum += (uint8_t)c;
+	std::string packet = std::format("${}#{:02x}", payload, checksum);
+
+	// Without no-ack mode the stub acks every packet, Receive resends it on a NAK
+	auto sent = SendRaw(packet);
+	if (!sent) return sent;
+	if (!m_noack)
+	{
+		m_unacked = std::move(packet);
+		m_resends = 0;
+	}
+	m_packetssent++;
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::GdbRemoteTarget::SendRaw(std::string_view data)
+{
+	size_t sent = 0;
+	while (sent < data.size())
+	{
+		int n = send((socket_t)m_socket, data.data() + sent, (int)(data.size() - sent), 0);
+		if (n <= 0)
+			return std::unexpected("GdbRemoteTarget connection lost");
+		sent += n;
+	}
+	return true;
+}
+
+std::expected<std::string, std::string> gdbw::GdbRemoteTarget::Receive(void)
+{
+	while (true)
+	{
+		// Acks come before the reply, a NAK means the stub got a corrupted packet & wants it again
+		size_t start = m_received.find('$');
+		for (size_t i = 0; i < std::min(start, m_received.size()); i++)
+		{
+			if (m_received[i] == '+')
+				m_unacked.clear();
+			else if (m_received[i] == '-' && !m_unacked.empty())
+			{
+				if (++m_resends > MaxResends)
+					return std::unexpected("GdbRemoteTarget stub keeps rejecting a packet");
+				auto resent = SendRaw(m_unacked);
+				if (!resent) return std::unexpected(resent.error());
+			}
+		}
+		if (start == std::string::npos)
+			m_received.clear();
+		else if (start != 0)
+		{
+			m_received.erase(0, start);
+			start = 0;
+		}
+
+		// Need a whole "$payload#xx" in the buffer
+		size_t end = start == std::string::npos ? std::string::npos : m_received.find('#', start);
+		if (end != std::string::npos && end + 2 < m_received.size())
+		{
+			std::string_view raw = std::string_view(m_received).substr(start + 1, end - start - 1);
+			uint8_t checksum = 0;
+			for (char c : raw)
+				checksum += (uint8_t)c;
+			int sent = HexValue(m_received[end + 1]) << 4 | HexValue(m_received[end + 2]);
+
+			// Undo escaping & run length encoding
+			std::string payload;
+			payload.reserve(raw.size());
+			for (size_t i = 0; i < raw.size(); i++)
+			{
+				if (raw[i] == '}' && i + 1 < raw.size())
+					payload.push_back(raw[++i] ^ 0x20);
+				else if (raw[i] == '*' && i + 1 < raw.size() && !payload.empty())
+					payload.append((size_t)(uint8_t)raw[++i] - 29, payload.back());
+				else
+					payload.push_back(raw[i]);
+			}
+			m_received.erase(0, end + 3);
+
+			if (!m_noack)
+			{
+				// Ask for a resend on corruption
+				char ack = sent == checksum ? '+' : '-';
+				send((socket_t)m_socket, &ack, 1, 0);
+				if (sent != checksum)
+					continue;
+			}
+			return payload;
+		}
+
+		char buffer[0x4000];
+		int n = recv((socket_t)m_socket, buffer, sizeof(buffer), 0);
+		if (n <= 0)
+			return std::unexpected("GdbRemoteTarget connection lost");
+		m_received.append(buffer, n);
+	}
+}
+
+std::expected<std::string, std::string> gdbw::GdbRemoteTarget::Request(std::string_view payload)
+{
+	auto sent = Send(payload);
+	if (!sent) return std::unexpected(sent.error());
+	return Receive();
+}
+
+std::expected<std::vector<std::string>, std::string> gdbw::GdbRemoteTarget::RequestBatch(const std::vector<std::string>& payloads)
+{
+	// Stubs answer in order, so keep a window of requests on the wire instead of
+	// waiting a round trip for each one
+	std::vector<std::string> replies;
+	replies.reserve(payloads.size());
+	// With acks on, a NAK'd packet must be resent before the stub sees the next one
+	size_t window = m_noack ? MaxInFlight : 1;
+	size_t next = 0;
+	while (replies.size() < payloads.size())
+	{
+		while (next < payloads.size() && next - replies.size() < window)
+		{
+			auto sent = Send(payloads[next++]);
+			if (!sent) return std::unexpected(sent.error());
+		}
+		auto reply = Receive();
+		if (!reply) return std::unexpected(reply.error());
+		replies.push_back(std::move(*reply));
+	}
+	return replies;
+}
+
+std::expected<std::string, std::string> gdbw::GdbRemoteTarget::ReadXfer(const std::string& object, const std::string& annex)
+{
+	std::string data;
+	size_t chunk = m_packetsize - 16;
+	while (true)
+	{
+		auto reply = Request(std::format("qXfer:{}:read:{}:{:x},{:x}", object, annex, data.size(), chunk));
+		if (!reply) return std::unexpected(reply.error());
+		if (reply->empty() || (*reply)[0] == 'E')
+			return std::unexpected(std::format("GdbRemoteTarget failed to read {}", object));
+
+		data.append(*reply, 1);
+		if ((*reply)[0] == 'l')
+			return data;
+	}
+}
+
+std::expected<int, std::string> gdbw::GdbRemoteTarget::WaitForStop(void)
+{
+	while (true)
+	{
+		auto reply = Receive();
+		if (!reply) return std::unexpected(reply.error());
+		if (reply->empty())
+			return std::unexpected("GdbRemoteTarget stub doesn't support resuming");
+
+		switch ((*reply)[0])
+		{
+		case 'O':
+		{
+			// Console output from the stub (hex encoded)
+			std::string output(reply->size() / 2, '\0');
+			HexDecode(std::string_view(*reply).substr(1), (uint8_t*)output.data(), output.size());
+			fputs(output.c_str(), stdout);
+			break;
+		}
+		case 'S':
+		case 'T':
+			return (int)strtoul(reply->substr(1, 2).c_str(), nullptr, 16);
+		case 'W':
+		case 'X':
+			return -1;
+		default:
+			return std::unexpected(std::format("GdbRemoteTarget unexpected stop reply {}", *reply));
+		}
+	}
+}
+
+void gdbw::GdbRemoteTarget::InvalidateStop(void)
+{
+	m_registers.clear();
+	m_regionsvalid = false;
+	m_modulesvalid = false;
+}
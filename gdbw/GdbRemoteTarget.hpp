@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Target driving a gdbserver compatible stub (gdbserver, QEMU's gdbstub, ...) over the GDB
+	// Remote Serial Protocol. Acks are turned off when the stub allows it and independent
+	// requests (e.g. the `m` packets of a large read) are pipelined, so a read costs one round trip.
+	// Registers, the memory map & the library list are fetched once per stop.
+	class GdbRemoteTarget : public Target
+	{
+	public:
+		static constexpr size_t DefaultPacketSize = 0x1000;
+		// Requests sent before waiting for their replies, only once acks are off
+		static constexpr size_t MaxInFlight = 32;
+		// Times a packet is resent after the stub NAKs it before giving up
+		static constexpr size_t MaxResends = 8;
+
+		GdbRemoteTarget() = default;
+		~GdbRemoteTarget();
+
+		// Connect to a stub listening on host:port and negotiate features
+		std::expected<bool, std::string> Connect(const std::string& host, uint16_t port);
+
+		std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override;
+		std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override;
+		std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) override;
+		std::expected<DE::RegisterContext, std::string> GetRegisters(DE::RegisterSet set) override;
+		std::expected<std::vector<TargetModule>, std::string> GetModules(void) override;
+		inline bool Is64Bit(void) override { return m_is64; }
+
+		std::expected<int, std::string> Continue(void) override;
+		std::expected<int, std::string> StepInto(void) override;
+		std::expected<int, std::string> RunTo(uint64_t address) override;
+		std::expected<uint32_t, std::string> SetBreakpoint(uint64_t address) override;
+		std::optional<uint32_t> FindBreakpoint(uint64_t address) override;
+		std::expected<bool, std::string> ClearBreakpoint(uint32_t id) override;
+		void Interrupt(void) override;
+
+		// Packets sent since connecting, useful for checking how well requests coalesce
+		inline uint64_t PacketsSent(void) const { return m_packetssent; }
+	private:
+		// Frame & send a packet without waiting for the reply
+		std::expected<bool, std::string> Send(std::string_view payload);
+		// Send raw bytes
+		std::expected<bool, std::string> SendRaw(std::string_view data);
+		// Receive the next packet, returns its decoded payload
+		std::expected<std::string, std::string> Receive(void);
+		// Send a packet and wait for its reply
+		std::expected<std::string, std::string> Request(std::string_view payload);
+		// Send every packet (up to MaxInFlight at a time), replies are returned in order
+		std::expected<std::vector<std::string>, std::string> RequestBatch(const std::vector<std::string>& payloads);
+		// Read a whole qXfer object
+		std::expected<std::string, std::string> ReadXfer(const std::string& object, const std::string& annex);
+		// Wait for a stop reply, returns the signal or -1 if the target exited
+		std::expected<int, std::string> WaitForStop(void);
+		// Everything cached about the current stop is stale once the target runs
+		void InvalidateStop(void);
+
+		uint64_t m_socket = ~0ull;
+		bool m_noack = false;
+		size_t m_packetsize = DefaultPacketSize;
+		bool m_xfermemorymap = false;
+		bool m_xferlibraries = false;
+		bool m_xferlibrariessvr4 = false;
+		bool m_is64 = true;
+		uint64_t m_packetssent = 0;
+		std::string m_received; // bytes received but not consumed yet
+		// Until no-ack mode is on, the last packet sent is kept until the stub acks it
+		std::string m_unacked;
+		size_t m_resends = 0;
+
+		// Per stop caches
+		std::vector<uint8_t> m_registers; // raw `g` reply
+		std::vector<TargetRegion> m_regions;
+		bool m_regionsvalid = false;
+		std::vector<TargetModule> m_modules;
+		bool m_modulesvalid = false;
+
+		uint32_t m_nextbreakpoint = 0;
+		std::map<uint32_t, uint64_t> m_breakpoints;
+	};
+}
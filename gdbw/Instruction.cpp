@@ -1,41 +1,52 @@
 #include "Instruction.hpp"
 
-gdbw::Instruction::Instruction(cs_insn* instruction)
+void gdbw::InstructionBatch::Add(const cs_insn* insn)
 {
-	m_address = instruction->address;
-	memcpy(m_mnemonic, instruction->mnemonic, sizeof(m_mnemonic));
-	memcpy(m_opstr, instruction->op_str, sizeof(m_opstr));
-	memcpy(m_bytes, instruction->bytes, sizeof(m_bytes));
-	m_size = instruction->size;
+	Add(insn->address, insn->mnemonic, insn->op_str, insn->bytes, (uint8_t)insn->size);
 }
 
-gdbw::Instruction::~Instruction()
+void gdbw::InstructionBatch::Add(uint64_t address, const char* mnemonic, const char* opstr, const uint8_t* bytes, uint8_t size)
 {
+	Instruction instruction = { 0 };
+	instruction.address = address;
+	instruction.mnemonic = m_strings.Intern(mnemonic);
+	instruction.opstr = m_strings.Intern(opstr);
+	instruction.size = std::min<uint8_t>(size, sizeof(instruction.bytes));
+	memcpy(instruction.bytes, bytes, instruction.size);
+	m_instructions.push_back(instruction);
 }
 
-void gdbw::Instruction::CreateInstructionsTable(lua_State* L, std::vector<Instruction*> insns)
+void gdbw::InstructionBatch::Clear(void)
+{
+	m_instructions.clear();
+	m_strings.Clear();
+}
+
+void gdbw::InstructionBatch::CreateInstructionsTable(lua_State* L, const InstructionBatch& insns)
 {
 	// create parent table
-	lua_createtable(L, insns.size(), 0);
+	lua_createtable(L, insns.Size(), 0);
 
-	for (size_t i = 0; i < insns.size(); i++)
+	for (size_t i = 0; i < insns.Size(); i++)
 	{
+		const Instruction& insn = insns[i];
+
 		// child table (Instruction)
 		lua_createtable(L, 0, 5);
 
-		lua_pushinteger(L, insns[i]->m_address);
+		lua_pushinteger(L, insn.address);
 		lua_setfield(L, -2, "address");
 
-		lua_pushlstring(L, (const char*)insns[i]->m_bytes, sizeof(insns[i]->m_bytes));
+		lua_pushlstring(L, (const char*)insn.bytes, insn.size);
 		lua_setfield(L, -2, "bytes");
 
-		lua_pushstring(L, insns[i]->m_mnemonic);
+		lua_pushstring(L, insns.Mnemonic(insn));
 		lua_setfield(L, -2, "mnemonic");
 
-		lua_pushstring(L, insns[i]->m_opstr);
+		lua_pushstring(L, insns.OpStr(insn));
 		lua_setfield(L, -2, "opstr");
 
-		lua_pushinteger(L, insns[i]->m_size);
+		lua_pushinteger(L, insn.size);
 		lua_setfield(L, -2, "size");
 
 		// Child index
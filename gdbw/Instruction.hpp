@@ -2,22 +2,47 @@
 #include <vector>
 #include "thirdparty/capstone/capstone/capstone.h"
 #include "LuaManager.hpp"
+#include "StringPool.hpp"
 
 namespace gdbw
 {
-	class Instruction
+	// A single decoded instruction. Mnemonic and operand strings live in the owning
+	// InstructionBatch's string pool.
+	struct Instruction
+	{
+		uint64_t address;
+		uint32_t mnemonic; // StringPool id
+		uint32_t opstr;    // StringPool id
+		uint8_t bytes[16]; // x86 instructions are at most 15 bytes
+		uint8_t size;
+	};
+
+	// Contiguous batch of decoded instructions + the strings they reference
+	class InstructionBatch
 	{
 	public:
-		Instruction(cs_insn* instruction);
-		~Instruction();
-		// Convert a vector of Instructions to a lua table and push it to the stack
+		InstructionBatch() = default;
+		~InstructionBatch() = default;
+
+		// Reserve space for `count` instructions up front (a single allocation)
+		inline void Reserve(size_t count) { m_instructions.reserve(count); }
+		// Copy a capstone instruction into the batch
+		void Add(const cs_insn* insn);
+		// Add an already decoded instruction (e.g. from the instruction cache)
+		void Add(uint64_t address, const char* mnemonic, const char* opstr, const uint8_t* bytes, uint8_t size);
+		// Drop all instructions & strings, keeping allocations for reuse
+		void Clear(void);
+
+		inline size_t Size(void) const { return m_instructions.size(); }
+		inline const Instruction& operator[](size_t i) const { return m_instructions[i]; }
+		inline const char* Mnemonic(const Instruction& insn) const { return m_strings.Get(insn.mnemonic); }
+		inline const char* OpStr(const Instruction& insn) const { return m_strings.Get(insn.opstr); }
+
+		// Convert the batch to a lua table and push it to the stack
 		// used to return instruction(s) as a binding return value
-		static void CreateInstructionsTable(lua_State* L, std::vector<Instruction*> insns);
+		static void CreateInstructionsTable(lua_State* L, const InstructionBatch& insns);
 	private:
-		uint64_t m_address;
-		char m_mnemonic[32]; // capstone size
-		char m_opstr[160];   // capstone size
-		uint8_t m_bytes[24]; // capstone size
-		uint64_t m_size; // technically only need uint8 but lua uses longlong
+		std::vector<Instruction> m_instructions;
+		StringPool m_strings;
 	};
-}
\ No newline at end of file
+}
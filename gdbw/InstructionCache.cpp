@@ -0,0 +1,52 @@
+#include "InstructionCache.hpp"
+
+const gdbw::InstructionCache::Entry* gdbw::InstructionCache::Lookup(uint64_t address, const uint8_t* code, size_t len)
+{
+	auto it = m_entries.find(address);
+	if (it == m_entries.end()
+		|| it->second.size > len
+		|| memcmp(it->second.bytes, code, it->second.size) != 0)
+	{
+		m_misses++;
+		return nullptr;
+	}
+
+	m_hits++;
+	return &it->second;
+}
+
+void gdbw::InstructionCache::Store(const cs_insn* insn)
+{
+	if (insn->size > sizeof(Entry::bytes))
+		return;
+
+	if (m_entries.size() >= MaxEntries)
+		Flush();
+
+	Entry entry = { 0 };
+	entry.mnemonic = m_strings.Intern(insn->mnemonic);
+	entry.opstr = m_strings.Intern(insn->op_str);
+	entry.size = (uint8_t)insn->size;
+	memcpy(entry.bytes, insn->bytes, insn->size);
+	m_entries[insn->address] = entry;
+}
+
+void gdbw::InstructionCache::Invalidate(uint64_t address, uint64_t len)
+{
+	// An instruction starting up to 15 bytes before `address` may still overlap it
+	uint64_t start = address > sizeof(Entry::bytes) ? address - sizeof(Entry::bytes) : 0;
+	auto it = m_entries.lower_bound(start);
+	while (it != m_entries.end() && it->first < address + len)
+	{
+		if (it->first + it->second.size > address)
+			it = m_entries.erase(it);
+		else
+			++it;
+	}
+}
+
+void gdbw::InstructionCache::Flush(void)
+{
+	m_entries.clear();
+	m_strings.Clear();
+}
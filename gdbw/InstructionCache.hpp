@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include "thirdparty/capstone/capstone/capstone.h"
+#include "StringPool.hpp"
+
+namespace gdbw
+{
+	// Decoded instruction cache indexed by address. An entry is only reused while the
+	// bytes currently in memory at that address match the bytes it was decoded from,
+	// so self-modifying code or patched bytes are simply re-decoded.
+	class InstructionCache
+	{
+	public:
+		// Upper bound on cached instructions, the cache is flushed once exceeded
+		static constexpr size_t MaxEntries = 0x40000;
+
+		struct Entry
+		{
+			uint32_t mnemonic; // StringPool id
+			uint32_t opstr;    // StringPool id
+			uint8_t bytes[16];
+			uint8_t size;
+		};
+
+		InstructionCache() = default;
+		~InstructionCache() = default;
+
+		// Look up a decoded instruction at `address`, `code` points at up to `len` bytes
+		// currently in memory at that address. Returns nullptr on a miss.
+		const Entry* Lookup(uint64_t address, const uint8_t* code, size_t len);
+		// Store a freshly decoded instruction
+		void Store(const cs_insn* insn);
+		// Drop any instruction overlapping [address, address+len)
+		void Invalidate(uint64_t address, uint64_t len);
+		// Drop everything (e.g. module unload, processor mode change)
+		void Flush(void);
+
+		inline const char* Mnemonic(const Entry* entry) const { return m_strings.Get(entry->mnemonic); }
+		inline const char* OpStr(const Entry* entry) const { return m_strings.Get(entry->opstr); }
+		inline uint64_t Hits(void) const { return m_hits; }
+		inline uint64_t Misses(void) const { return m_misses; }
+		inline size_t Size(void) const { return m_entries.size(); }
+	private:
+		std::map<uint64_t, Entry> m_entries;
+		StringPool m_strings;
+		uint64_t m_hits = 0;
+		uint64_t m_misses = 0;
+	};
+}
@@ -0,0 +1,757 @@
+#ifdef __linux__
+#include "LinuxTarget.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sys/ptrace.h>
+#include <sys/uio.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Windows values, regions are reported the same way regardless of backend
+static constexpr uint32_t PageNoAccess = 0x01;
+static constexpr uint32_t PageReadOnly = 0x02;
+static constexpr uint32_t PageReadWrite = 0x04;
+static constexpr uint32_t PageExecute = 0x10;
+static constexpr uint32_t PageExecuteRead = 0x20;
+static constexpr uint32_t PageExecuteReadWrite = 0x40;
+static constexpr uint32_t MemCommit = 0x1000;
+static constexpr uint32_t MemPrivate = 0x20000;
+static constexpr uint32_t MemMapped = 0x40000;
+static constexpr uint32_t MemImage = 0x1000000;
+
+static uint32_t PermsToProtections(const char* perms)
+{
+	bool r = perms[0] == 'r', w = perms[1] == 'w', x = perms[2] == 'x';
+	if (x) return w ? PageExecuteReadWrite : (r ? PageExecuteRead : PageExecute);
+	if (w) return PageReadWrite;
+	return r ? PageReadOnly : PageNoAccess;
+}
+
+// Signals the debugger caused (breakpoints, steps & stopping threads) aren't delivered to the target, nor is
+// SIGINT: like in gdb it's the user breaking in
+static bool PassSignal(int signal)
+{
+	return signal != SIGTRAP && signal != SIGSTOP && signal != SIGINT;
+}
+
+static bool IsCloneEvent(int status)
+{
+	return status >> 8 == (SIGTRAP | (PTRACE_EVENT_CLONE << 8));
+}
+
+gdbw::LinuxTarget::~LinuxTarget()
+{
+	if (m_pid != 0)
+	{
+		if (m_launched)
+		{
+			kill(m_pid, SIGKILL);
+			// The leader is only reported once every other thread has been reaped
+			for (auto& [tid, thread] : m_threads)
+				if (tid != m_pid)
+					waitpid(tid, nullptr, __WALL);
+			waitpid(m_pid, nullptr, __WALL);
+		}
+		else
+			Detach();
+	}
+	if (m_memfd >= 0)
+		close(m_memfd);
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::Attach(pid_t pid)
+{
+	if (ptrace(PTRACE_ATTACH, pid, nullptr, nullptr) != 0)
+		return std::unexpected(std::format("LinuxTarget.Attach ptrace failed errno={}", errno));
+	m_pid = pid;
+	InvalidateStop();
+
+	// Threads started while attaching show up in the next listing, done once a pass finds no new ones.
+	// Threads started after that are traced through PTRACE_O_TRACECLONE.
+	std::vector<pid_t> tids = { pid };
+	while (!tids.empty())
+	{
+		for (pid_t tid : tids)
+		{
+			// Others may have exited in the meantime
+			if (tid != pid && ptrace(PTRACE_ATTACH, tid, nullptr, nullptr) != 0)
+				continue;
+			int status = 0;
+			if (waitpid(tid, &status, __WALL) < 0 || !WIFSTOPPED(status))
+			{
+				if (tid == pid)
+					return std::unexpected("LinuxTarget.Attach process exited");
+				continue;
+			}
+
+			// Another signal can be reported before the attach's SIGSTOP
+			Thread& thread = m_threads[tid];
+			if (WSTOPSIG(status) != SIGSTOP)
+			{
+				thread.pendingsignal = PassSignal(WSTOPSIG(status)) ? WSTOPSIG(status) : 0;
+				thread.stopqueued = true;
+			}
+			ptrace(PTRACE_SETOPTIONS, tid, nullptr, (void*)PTRACE_O_TRACECLONE);
+		}
+
+		tids.clear();
+		std::error_code ec;
+		for (auto& entry : std::filesystem::directory_iterator(std::format("/proc/{}/task", pid), ec))
+		{
+			pid_t tid = (pid_t)strtol(entry.path().filename().c_str(), nullptr, 10);
+			if (tid > 0 && !m_threads.contains(tid))
+				tids.push_back(tid);
+		}
+	}
+	m_current = pid;
+
+	m_memfd = open(std::format("/proc/{}/mem", pid).c_str(), O_RDWR | O_CLOEXEC);
+	if (m_memfd < 0)
+		return std::unexpected(std::format("LinuxTarget.Attach failed to open /proc/{}/mem errno={}", pid, errno));
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::Launch(const std::vector<std::string>& argv)
+{
+	if (argv.empty())
+		return std::unexpected("LinuxTarget.Launch no command line");
+
+	std::vector<char*> args;
+	for (auto& arg : argv)
+		args.push_back((char*)arg.c_str());
+	args.push_back(nullptr);
+
+	pid_t pid = fork();
+	if (pid < 0)
+		return std::unexpected(std::format("LinuxTarget.Launch fork failed errno={}", errno));
+	if (pid == 0)
+	{
+		// Child stops with SIGTRAP once exec succeeds
+		ptrace(PTRACE_TRACEME, 0, nullptr, nullptr);
+		execvp(args[0], args.data());
+		_exit(127);
+	}
+	m_pid = pid;
+	InvalidateStop();
+	m_launched = true;
+	m_threads[pid] = {};
+	m_current = pid;
+
+	auto stop = WaitForStop(false);
+	if (!stop) return std::unexpected(stop.error());
+	if (*stop < 0)
+		return std::unexpected(std::format("LinuxTarget.Launch failed to start {}", argv[0]));
+	ptrace(PTRACE_SETOPTIONS, m_pid, nullptr, (void*)(PTRACE_O_EXITKILL | PTRACE_O_TRACECLONE));
+
+	m_memfd = open(std::format("/proc/{}/mem", pid).c_str(), O_RDWR | O_CLOEXEC);
+	if (m_memfd < 0)
+		return std::unexpected(std::format("LinuxTarget.Launch failed to open /proc/{}/mem errno={}", pid, errno));
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::Detach(void)
+{
+	for (auto& [id, bp] : m_breakpoints)
+		WriteRaw(bp.address, 1, &bp.original);
+	m_breakpoints.clear();
+
+	// Every thread is stopped between stops, which is the only time they can be detached
+	bool stopqueued = false;
+	for (auto& [tid, thread] : m_threads)
+	{
+		if (ptrace(PTRACE_DETACH, tid, nullptr, (void*)(intptr_t)thread.pendingsignal) != 0 && tid == m_pid)
+			return std::unexpected(std::format("LinuxTarget.Detach ptrace failed errno={}", errno));
+		stopqueued |= thread.stopqueued;
+	}
+	// A SIGSTOP we sent & never saw would leave the process stopped
+	if (stopqueued)
+		kill(m_pid, SIGCONT);
+
+	m_threads.clear();
+	m_current = 0;
+	m_pid = 0;
+	InvalidateStop();
+	return true;
+}
+
+std::expected<int, std::string> gdbw::LinuxTarget::Continue(void)
+{
+	auto stepped = StepOverBreakpoint();
+	if (!stepped) return stepped;
+	// The step stopped for something else (e.g. a signal arrived or the process exited), report that
+	if (*stepped != 0 && *stepped != SIGTRAP)
+		return stepped;
+
+	auto resumed = ResumeThreads();
+	if (!resumed) return std::unexpected(resumed.error());
+	auto stop = WaitForStop(true);
+	if (!stop) return stop;
+
+	if (*stop == SIGTRAP)
+	{
+		auto rewound = RewindBreakpoint(m_current);
+		if (!rewound) return std::unexpected(rewound.error());
+	}
+	return stop;
+}
+
+std::expected<int, std::string> gdbw::LinuxTarget::StepInto(void)
+{
+	// Stepping off a breakpoint already executes exactly one instruction
+	auto stepped = StepOverBreakpoint();
+	if (!stepped) return stepped;
+	if (*stepped != 0)
+		return stepped;
+
+	auto resumed = Resume(m_current, m_threads[m_current], PTRACE_SINGLESTEP);
+	if (!resumed) return std::unexpected(resumed.error());
+	return WaitForStop(false);
+}
+
+std::expected<int, std::string> gdbw::LinuxTarget::RunTo(uint64_t address)
+{
+	if (FindBreakpoint(address))
+		return Continue();
+
+	auto id = SetBreakpoint(address);
+	if (!id) return std::unexpected(id.error());
+	auto stop = Continue();
+	// Breakpoints go away with the process
+	if (m_pid != 0)
+	{
+		auto cleared = ClearBreakpoint(*id);
+		if (!cleared) return std::unexpected(cleared.error());
+	}
+	return stop;
+}
+
+std::expected<uint32_t, std::string> gdbw::LinuxTarget::SetBreakpoint(uint64_t address)
+{
+	if (auto existing = FindBreakpoint(address))
+		return *existing;
+
+	Breakpoint bp = { address, 0 };
+	auto read = ReadRaw(address, 1, &bp.original);
+	if (!read) return std::unexpected(read.error());
+
+	uint8_t int3 = 0xCC;
+	auto written = WriteRaw(address, 1, &int3);
+	if (!written) return std::unexpected(written.error());
+
+	uint32_t id = m_nextbreakpoint++;
+	m_breakpoints[id] = bp;
+	return id;
+}
+
+std::optional<uint32_t> gdbw::LinuxTarget::FindBreakpoint(uint64_t address)
+{
+	for (auto& [id, bp] : m_breakpoints)
+		if (bp.address == address)
+			return id;
+	return std::nullopt;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::ClearBreakpoint(uint32_t id)
+{
+	auto it = m_breakpoints.find(id);
+	if (it == m_breakpoints.end())
+		return std::unexpected("Invalid breakpoint id");
+
+	auto written = WriteRaw(it->second.address, 1, &it->second.original);
+	if (!written) return std::unexpected(written.error());
+	m_breakpoints.erase(it);
+	return true;
+}
+
+void gdbw::LinuxTarget::Interrupt(void)
+{
+	// Runs in a signal handler, kill is async signal safe
+	if (m_pid != 0 && !m_launched)
+		kill(m_pid, SIGSTOP);
+}
+
+std::vector<uint32_t> gdbw::LinuxTarget::GetThreads(void)
+{
+	std::vector<uint32_t> threads;
+	if (m_current != 0)
+		threads.push_back(m_current);
+	for (auto& [tid, thread] : m_threads)
+		if (tid != m_current)
+			threads.push_back(tid);
+	return threads;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::SetThread(uint32_t id)
+{
+	if (!m_threads.contains((pid_t)id))
+		return std::unexpected(std::format("LinuxTarget.SetThread no thread {} in process", id));
+	m_current = (pid_t)id;
+	return true;
+}
+
+std::expected<gdbw::Symbol, std::string> gdbw::LinuxTarget::SymbolFromAddress(uint64_t address)
+{
+	auto maps = ReadMaps();
+	if (!maps) return std::unexpected(maps.error());
+
+	const Mapping* containing = nullptr;
+	for (auto& map : **maps)
+	{
+		if (address >= map.region.baseaddress && address - map.region.baseaddress < map.region.size)
+		{
+			containing = &map;
+			break;
+		}
+	}
+	if (containing == nullptr || containing->region.type != MemImage)
+		return std::unexpected(std::format("No module contains {:#x}", address));
+
+	// First mapping of the file is the module base
+	const Mapping* module = nullptr;
+	for (auto& map : **maps)
+	{
+		if (map.path == containing->path && map.offset == 0)
+		{
+			module = &map;
+			break;
+		}
+	}
+	if (module == nullptr)
+		return std::unexpected(std::format("No module contains {:#x}", address));
+
+	auto& symbols = m_symbols[module->path];
+	if (!symbols)
+	{
+		symbols = std::make_unique<ElfSymbols>();
+		auto loaded = symbols->Load(module->path, module->region.baseaddress);
+		if (!loaded) return std::unexpected(loaded.error());
+	}
+
+	auto symbol = symbols->Lookup(address);
+	if (!symbol)
+		return std::unexpected(std::format("No symbol found for address {:#x}", address));
+	return *symbol;
+}
+
+std::expected<gdbw::Symbol, std::string> gdbw::LinuxTarget::SymbolFromName(const std::string& name)
+{
+	auto modules = GetModules();
+	if (!modules) return std::unexpected(modules.error());
+
+	for (auto& module : *modules)
+	{
+		auto& symbols = m_symbols[module.name];
+		if (!symbols)
+		{
+			symbols = std::make_unique<ElfSymbols>();
+			if (!symbols->Load(module.name, module.base))
+				continue;
+		}
+		auto address = symbols->FromName(name);
+		if (!address)
+			continue;
+		if (auto symbol = symbols->Lookup(*address))
+			return *symbol;
+	}
+	return std::unexpected(std::format("No symbol named {}", name));
+}
+
+std::expected<uint32_t, std::string> gdbw::LinuxTarget::ReadMemory(uint64_t address, uint32_t len, void* out)
+{
+	auto result = ReadRaw(address, len, out);
+	if (!result) return result;
+
+	// Hide our int3s
+	uint8_t* dst = (uint8_t*)out;
+	for (auto& [id, bp] : m_breakpoints)
+		if (bp.address >= address && bp.address - address < *result)
+			dst[bp.address - address] = bp.original;
+	return result;
+}
+
+std::expected<uint32_t, std::string> gdbw::LinuxTarget::WriteMemory(uint64_t address, uint32_t len, const void* in)
+{
+	// Writes over a breakpoint change the byte restored on removal, the int3 stays armed
+	std::vector<uint8_t> data((const uint8_t*)in, (const uint8_t*)in + len);
+	for (auto& [id, bp] : m_breakpoints)
+	{
+		if (bp.address >= address && bp.address - address < len)
+		{
+			bp.original = data[bp.address - address];
+			data[bp.address - address] = 0xCC;
+		}
+	}
+	return WriteRaw(address, len, data.data());
+}
+
+std::expected<std::vector<gdbw::TargetRegion>, std::string> gdbw::LinuxTarget::GetRegions(void)
+{
+	auto maps = ReadMaps();
+	if (!maps) return std::unexpected(maps.error());
+
+	std::vector<TargetRegion> regions;
+	regions.reserve((*maps)->size());
+	for (auto& map : **maps)
+		regions.push_back(map.region);
+	return regions;
+}
+
+std::expected<gdbw::DE::RegisterContext, std::string> gdbw::LinuxTarget::GetRegisters(DE::RegisterSet set)
+{
+#ifdef __x86_64__
+	if (set != DE::RegisterSet::GP64)
+		return std::unexpected("LinuxTarget.GetRegisters only 64bit registers are supported");
+
+	user_regs_struct regs = { 0 };
+	if (ptrace(PTRACE_GETREGS, m_current, nullptr, &regs) != 0)
+		return std::unexpected(std::format("LinuxTarget.GetRegisters ptrace failed errno={}", errno));
+
+	DE::RegisterContext context = { set, 0, nullptr, { 0 } };
+	context.count = DE::GetRegisterSetNames(set, &context.names);
+	// Same order as GP64Registers
+	const uint64_t values[] = {
+		regs.rax, regs.rbx, regs.rcx, regs.rdx, regs.rsi, regs.rdi, regs.rip, regs.rsp, regs.rbp,
+		regs.r8, regs.r9, regs.r10, regs.r11, regs.r12, regs.r13, regs.r14, regs.r15
+	};
+	static_assert(sizeof(values) / sizeof(values[0]) == sizeof(DE::GP64Registers) / sizeof(DE::GP64Registers[0]));
+	memcpy(context.values, values, sizeof(values));
+	return context;
+#else
+	return std::unexpected("LinuxTarget.GetRegisters only x86-64 is supported");
+#endif
+}
+
+std::expected<std::vector<gdbw::TargetModule>, std::string> gdbw::LinuxTarget::GetModules(void)
+{
+	auto maps = ReadMaps();
+	if (!maps) return std::unexpected(maps.error());
+
+	// A module is every mapping of an image file, from its first to its last
+	std::vector<TargetModule> modules;
+	for (auto& map : **maps)
+	{
+		if (map.region.type != MemImage)
+			continue;
+		uint64_t end = map.region.baseaddress + map.region.size;
+		if (!modules.empty() && modules.back().name == map.path)
+			modules.back().size = end - modules.back().base;
+		else
+			modules.push_back({ map.region.baseaddress, map.region.size, map.path });
+	}
+	return modules;
+}
+
+std::expected<int, std::string> gdbw::LinuxTarget::WaitForStop(bool all)
+{
+	while (true)
+	{
+		int status = 0;
+		pid_t tid = waitpid(all ? -1 : m_current, &status, __WALL);
+		if (tid < 0)
+		{
+			// Interrupted by our SIGINT handler, the target is stopped separately
+			if (errno == EINTR)
+				continue;
+			return std::unexpected(std::format("LinuxTarget waitpid failed errno={}", errno));
+		}
+
+		if (WIFEXITED(status) || WIFSIGNALED(status))
+		{
+			m_threads.erase(tid);
+			if (tid == m_pid)
+			{
+				// Nothing is left to restore
+				m_pid = 0;
+				m_current = 0;
+				m_threads.clear();
+				m_breakpoints.clear();
+				InvalidateStop();
+				return -1;
+			}
+			InvalidateStop();
+			// The stepped thread exited, let the rest of the process run to its next stop
+			if (!all && tid == m_current)
+			{
+				all = true;
+				auto resumed = ResumeThreads();
+				if (!resumed) return std::unexpected(resumed.error());
+			}
+			continue;
+		}
+		if (!WIFSTOPPED(status))
+			continue;
+
+		// While stepping, stops that aren't the step's keep it going
+		int request = all ? PTRACE_CONT : PTRACE_SINGLESTEP;
+		auto it = m_threads.find(tid);
+		if (it == m_threads.end())
+		{
+			// A new thread's initial SIGSTOP can be reported before its parent's clone event
+			Thread& created = m_threads[tid];
+			if (all)
+			{
+				auto resumed = Resume(tid, created, PTRACE_CONT);
+				if (!resumed) return std::unexpected(resumed.error());
+			}
+			continue;
+		}
+		Thread& thread = it->second;
+		thread.running = false;
+
+		if (IsCloneEvent(status))
+		{
+			unsigned long newtid = 0;
+			ptrace(PTRACE_GETEVENTMSG, tid, nullptr, &newtid);
+			InvalidateStop();
+			if (!m_threads.contains((pid_t)newtid))
+			{
+				// Traced from the start, its initial SIGSTOP is still to come
+				waitpid((pid_t)newtid, nullptr, __WALL);
+				m_threads[(pid_t)newtid] = {};
+			}
+			// Only the stepped thread runs while stepping
+			Thread& created = m_threads[(pid_t)newtid];
+			if (all && !created.running)
+			{
+				auto resumed = Resume((pid_t)newtid, created, PTRACE_CONT);
+				if (!resumed) return std::unexpected(resumed.error());
+			}
+			auto resumed = Resume(tid, thread, request);
+			if (!resumed) return std::unexpected(resumed.error());
+			continue;
+		}
+
+		int signal = WSTOPSIG(status);
+		if (status >> 16 != 0 || (signal == SIGSTOP && thread.stopqueued))
+		{
+			// Other ptrace events aren't asked for, a queued SIGSTOP was already dealt with by StopThreads
+			if (status >> 16 == 0)
+				thread.stopqueued = false;
+			auto resumed = Resume(tid, thread, request);
+			if (!resumed) return std::unexpected(resumed.error());
+			continue;
+		}
+
+		// Signals the target would have received are delivered when it's next resumed
+		thread.pendingsignal = PassSignal(signal) ? signal : 0;
+		m_current = tid;
+		if (all)
+			StopThreads();
+		return signal;
+	}
+}
+
+void gdbw::LinuxTarget::StopThreads(void)
+{
+	std::vector<pid_t> stopping;
+	for (auto& [tid, thread] : m_threads)
+	{
+		if (!thread.running || tgkill(m_pid, tid, SIGSTOP) != 0)
+			continue;
+		thread.stopqueued = true;
+		stopping.push_back(tid);
+	}
+
+	for (pid_t tid : stopping)
+	{
+		while (m_threads[tid].running)
+		{
+			int status = 0;
+			if (waitpid(tid, &status, __WALL) < 0 && errno == EINTR)
+				continue;
+			if (!WIFSTOPPED(status))
+			{
+				m_threads.erase(tid);
+				break;
+			}
+
+			Thread& thread = m_threads[tid];
+			thread.running = false;
+			int signal = WSTOPSIG(status);
+			if (IsCloneEvent(status))
+			{
+				// The new thread stays stopped with the rest
+				unsigned long newtid = 0;
+				ptrace(PTRACE_GETEVENTMSG, tid, nullptr, &newtid);
+				InvalidateStop();
+				if (!m_threads.contains((pid_t)newtid))
+				{
+					waitpid((pid_t)newtid, nullptr, __WALL);
+					m_threads[(pid_t)newtid] = {};
+				}
+			}
+			else if (status >> 16 != 0)
+				continue;
+			else if (signal == SIGSTOP && thread.stopqueued)
+				thread.stopqueued = false;
+			else if (signal == SIGTRAP)
+				// Hit a breakpoint at the same time as the current thread, it's hit again on resume
+				RewindBreakpoint(tid);
+			else
+				thread.pendingsignal = PassSignal(signal) ? signal : 0;
+		}
+	}
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::ResumeThreads(void)
+{
+	for (auto& [tid, thread] : m_threads)
+	{
+		if (thread.running)
+			continue;
+		auto resumed = Resume(tid, thread, PTRACE_CONT);
+		if (!resumed) return resumed;
+	}
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::Resume(pid_t tid, Thread& thread, int request)
+{
+	// ESRCH is a thread killed while stopped (e.g. another thread exited the process), waitpid still reports its exit
+	if (ptrace((__ptrace_request)request, tid, nullptr, (void*)(intptr_t)thread.pendingsignal) != 0 && errno != ESRCH)
+		return std::unexpected(std::format("LinuxTarget ptrace({}) failed errno={}", request == PTRACE_CONT ? "CONT" : "SINGLESTEP", errno));
+	InvalidateStop();
+	thread.pendingsignal = 0;
+	thread.running = true;
+	return true;
+}
+
+std::expected<const std::vector<gdbw::LinuxTarget::Mapping>*, std::string> gdbw::LinuxTarget::ReadMaps(void)
+{
+	if (m_mapsvalid)
+		return &m_maps;
+
+	std::ifstream in(std::format("/proc/{}/maps", m_pid));
+	if (!in)
+		return std::unexpected(std::format("LinuxTarget failed to open /proc/{}/maps", m_pid));
+
+	std::vector<Mapping> maps;
+	std::string line;
+	while (std::getline(in, line))
+	{
+		unsigned long long start = 0, end = 0, offset = 0;
+		char perms[5] = { 0 };
+		int pathstart = 0;
+		if (sscanf(line.c_str(), "%llx-%llx %4s %llx %*s %*s %n", &start, &end, perms, &offset, &pathstart) < 4)
+			continue;
+
+		Mapping map = {};
+		map.region = { start, start, end - start, PermsToProtections(perms), MemCommit, MemPrivate };
+		map.offset = offset;
+		if (pathstart > 0 && (size_t)pathstart < line.size())
+			map.path = line.substr(pathstart);
+
+		// Consecutive mappings of the same file make up one allocation
+		if (!map.path.empty() && map.path[0] == '/')
+		{
+			map.region.type = MemMapped;
+			if (!maps.empty() && maps.back().path == map.path && maps.back().region.baseaddress + maps.back().region.size == start)
+				map.region.allocationbase = maps.back().region.allocationbase;
+		}
+		maps.push_back(std::move(map));
+	}
+
+	// Files with any executable mapping are images
+	for (size_t i = 0; i < maps.size(); i++)
+	{
+		if (maps[i].region.type != MemMapped || (maps[i].region.protections & 0xF0) == 0)
+			continue;
+		for (auto& map : maps)
+			if (map.path == maps[i].path)
+				map.region.type = MemImage;
+	}
+	m_maps = std::move(maps);
+	m_mapsvalid = true;
+	return &m_maps;
+}
+
+std::expected<uint32_t, std::string> gdbw::LinuxTarget::ReadRaw(uint64_t address, uint32_t len, void* out)
+{
+	uint8_t* dst = (uint8_t*)out;
+	uint32_t done = 0;
+	while (done < len)
+	{
+		// One syscall for the whole range, stops short at the first page the target can't read
+		iovec local = { dst + done, len - done };
+		iovec remote = { (void*)(address + done), len - done };
+		ssize_t n = process_vm_readv(m_pid, &local, 1, &remote, 1, 0);
+		// /proc/pid/mem ignores page protections (e.g. PROT_NONE guard pages)
+		if (n <= 0)
+			n = pread(m_memfd, dst + done, len - done, address + done);
+		if (n <= 0)
+			break;
+		done += (uint32_t)n;
+	}
+	if (done == 0)
+		return std::unexpected(std::format("LinuxTarget.ReadMemory failed to read memory at {:#x}", address));
+	return done;
+}
+
+std::expected<uint32_t, std::string> gdbw::LinuxTarget::WriteRaw(uint64_t address, uint32_t len, const void* in)
+{
+	// /proc/pid/mem writes through read-only mappings, so breakpoints can be set in .text
+	ssize_t n = pwrite(m_memfd, in, len, address);
+	if (n <= 0)
+		return std::unexpected(std::format("LinuxTarget.WriteMemory failed to write memory at {:#x}", address));
+	return (uint32_t)n;
+}
+
+std::expected<bool, std::string> gdbw::LinuxTarget::RewindBreakpoint(pid_t tid)
+{
+#ifdef __x86_64__
+	user_regs_struct regs = { 0 };
+	if (ptrace(PTRACE_GETREGS, tid, nullptr, &regs) != 0)
+		return std::unexpected(std::format("LinuxTarget ptrace(GETREGS) failed errno={}", errno));
+
+	for (auto& [id, bp] : m_breakpoints)
+	{
+		if (bp.address != regs.rip - 1)
+			continue;
+		regs.rip--;
+		if (ptrace(PTRACE_SETREGS, tid, nullptr, &regs) != 0)
+			return std::unexpected(std::format("LinuxTarget ptrace(SETREGS) failed errno={}", errno));
+		return true;
+	}
+#endif
+	return false;
+}
+
+std::expected<int, std::string> gdbw::LinuxTarget::StepOverBreakpoint(void)
+{
+#ifdef __x86_64__
+	user_regs_struct regs = { 0 };
+	if (ptrace(PTRACE_GETREGS, m_current, nullptr, &regs) != 0)
+		return std::unexpected(std::format("LinuxTarget ptrace(GETREGS) failed errno={}", errno));
+
+	for (auto& [id, bp] : m_breakpoints)
+	{
+		if (bp.address != regs.rip)
+			continue;
+
+		// Put the original instruction back for one step, then re-arm. The step delivers the thread's pending
+		// signal, so a handler runs first & the breakpoint is hit again once it returns.
+		uint64_t address = bp.address;
+		auto written = WriteRaw(address, 1, &bp.original);
+		if (!written) return std::unexpected(written.error());
+		auto resumed = Resume(m_current, m_threads[m_current], PTRACE_SINGLESTEP);
+		if (!resumed) return std::unexpected(resumed.error());
+		auto stop = WaitForStop(false);
+		if (!stop || *stop < 0)
+			return stop;
+
+		uint8_t int3 = 0xCC;
+		written = WriteRaw(address, 1, &int3);
+		if (!written) return std::unexpected(written.error());
+		return stop;
+	}
+#endif
+	return 0;
+}
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+#ifdef __linux__
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "ElfSymbols.hpp"
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Target for a native Linux (x86-64) process, driven with ptrace.
+	// Memory is read in bulk with process_vm_readv (falling back to /proc/pid/mem for pages the
+	// target can't read itself), regions & modules come from /proc/pid/maps.
+	// Every thread is traced (new ones through PTRACE_O_TRACECLONE), all of them run while the
+	// process runs and all are stopped again as soon as one of them stops.
+	class LinuxTarget : public Target
+	{
+	public:
+		LinuxTarget() = default;
+		~LinuxTarget();
+
+		// Attach to a running process (all of its threads) and wait for it to stop
+		std::expected<bool, std::string> Attach(pid_t pid);
+		// Start a new process stopped at its first instruction
+		std::expected<bool, std::string> Launch(const std::vector<std::string>& argv);
+		// Remove breakpoints and let the process run freely
+		std::expected<bool, std::string> Detach(void);
+
+		// Continue until the next signal or breakpoint. Returns the stop signal, or -1 if the process exited.
+		std::expected<int, std::string> Continue(void) override;
+		// Execute a single instruction on the current thread, the others stay stopped
+		std::expected<int, std::string> StepInto(void) override;
+		std::expected<int, std::string> RunTo(uint64_t address) override;
+		// Add a software breakpoint, returns its id
+		std::expected<uint32_t, std::string> SetBreakpoint(uint64_t address) override;
+		std::optional<uint32_t> FindBreakpoint(uint64_t address) override;
+		std::expected<bool, std::string> ClearBreakpoint(uint32_t id) override;
+		// Stop a running attached process. A launched one shares our process group, so the terminal's
+		// SIGINT already reached it.
+		void Interrupt(void) override;
+
+		// Resolve an address from the ELF symbols of the module containing it
+		std::expected<Symbol, std::string> SymbolFromAddress(uint64_t address) override;
+		// Resolve a symbol name across all modules
+		std::expected<Symbol, std::string> SymbolFromName(const std::string& name) override;
+
+		std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override;
+		std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override;
+		std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) override;
+		std::expected<DE::RegisterContext, std::string> GetRegisters(DE::RegisterSet set) override;
+		std::expected<std::vector<TargetModule>, std::string> GetModules(void) override;
+		inline bool Is64Bit(void) override { return true; }
+		// Thread ids, the current thread (the one that stopped, or the one picked with SetThread) first
+		std::vector<uint32_t> GetThreads(void) override;
+		// Make registers & stepping act on thread `id`
+		std::expected<bool, std::string> SetThread(uint32_t id) override;
+
+		inline pid_t Pid(void) const { return m_pid; }
+	private:
+		struct Breakpoint
+		{
+			uint64_t address;
+			uint8_t original;
+		};
+
+		struct Thread
+		{
+			bool running = false;
+			// A SIGSTOP we sent is still to be reported, it's swallowed when it is
+			bool stopqueued = false;
+			// Signal the thread stopped with, delivered when it's next resumed
+			int pendingsignal = 0;
+		};
+
+		struct Mapping
+		{
+			TargetRegion region;
+			uint64_t offset;
+			std::string path; // empty for anonymous mappings
+		};
+
+		// Wait for a stop of any thread (`all`, every other thread is then stopped too) or only of the current
+		// one (single stepping). Returns the stop signal, or -1 if the process exited.
+		std::expected<int, std::string> WaitForStop(bool all);
+		// Stop every running thread, stops other than our SIGSTOP are kept for when the thread resumes
+		void StopThreads(void);
+		// Resume every stopped thread with its pending signal
+		std::expected<bool, std::string> ResumeThreads(void);
+		// Resume a single thread with `request` (PTRACE_CONT or PTRACE_SINGLESTEP) & its pending signal
+		std::expected<bool, std::string> Resume(pid_t tid, Thread& thread, int request);
+		// Parse /proc/pid/maps, kept until InvalidateStop so batch lookups (e.g. AddressesToSymbols) parse it once
+		std::expected<const std::vector<Mapping>*, std::string> ReadMaps(void);
+		// Drop per stop caches, called whenever a thread resumes, starts or exits
+		inline void InvalidateStop(void) { m_mapsvalid = false; }
+		// Raw memory access, breakpoint bytes are not hidden
+		std::expected<uint32_t, std::string> ReadRaw(uint64_t address, uint32_t len, void* out);
+		std::expected<uint32_t, std::string> WriteRaw(uint64_t address, uint32_t len, const void* in);
+		// If `tid` stopped on one of our int3s, rewind its instruction pointer onto the breakpoint
+		std::expected<bool, std::string> RewindBreakpoint(pid_t tid);
+		// Step the current thread off the breakpoint at its instruction pointer (if any) so it can be re-armed.
+		// Returns the step's stop signal, 0 if not on a breakpoint or -1 if the process exited.
+		std::expected<int, std::string> StepOverBreakpoint(void);
+
+		pid_t m_pid = 0;
+		bool m_launched = false;
+		int m_memfd = -1;
+		std::map<pid_t, Thread> m_threads;
+		pid_t m_current = 0;
+		uint32_t m_nextbreakpoint = 0;
+		std::map<uint32_t, Breakpoint> m_breakpoints;
+		// Per stop caches
+		std::vector<Mapping> m_maps;
+		bool m_mapsvalid = false;
+		// Symbols per module path, loaded on first lookup
+		std::map<std::string, std::unique_ptr<ElfSymbols>> m_symbols;
+	};
+}
+#endif
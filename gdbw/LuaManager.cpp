@@ -57,7 +57,13 @@ bool gdbw::LuaManager::Prompt()
     if (plugin != m_plugins.end())
         RunCommand(m_plugins[command]["name"], args);
     else if (command == "quit" || command == "q")
+    {
+#ifdef _WIN32
         ExitProcess(0); // TODO: change to something like g_dbg->Stop();
+#else
+        exit(0);
+#endif
+    }
     else
         printf("Unknown command\n");
 
@@ -70,11 +76,42 @@ void gdbw::LuaManager::RegisterGlobalFunction(LUA_FUNCTION func, const char* nam
     lua_setglobal(m_luastate, name);
 }
 
+std::expected<int, std::string> gdbw::LuaManager::LoadScript(const std::string& path)
+{
+    if (luaL_loadfile(m_luastate, path.c_str()))
+    {
+        const char* message = lua_tostring(m_luastate, -1);
+        std::string error = message ? message : "error object is not a string";
+        lua_pop(m_luastate, 1);
+        return std::unexpected(error);
+    }
+    return luaL_ref(m_luastate, LUA_REGISTRYINDEX);
+}
+
+std::expected<bool, std::string> gdbw::LuaManager::RunScript(int script, const std::string& arg)
+{
+    lua_rawgeti(m_luastate, LUA_REGISTRYINDEX, script);
+    lua_pushstring(m_luastate, arg.c_str());
+    if (lua_pcall(m_luastate, 1, 0, 0))
+    {
+        const char* message = lua_tostring(m_luastate, -1);
+        std::string error = message ? message : "error object is not a string";
+        lua_pop(m_luastate, 1);
+        return std::unexpected(error);
+    }
+    return true;
+}
+
 std::expected<bool, std::string> gdbw::LuaManager::LoadPlugins()
 {
     // Figure out plugin directory
+#ifdef _WIN32
     wchar_t path[FILENAME_MAX] = { 0 };
     GetModuleFileNameW(nullptr, path, FILENAME_MAX);
+#else
+    std::error_code ec;
+    auto path = std::filesystem::read_symlink("/proc/self/exe", ec);
+#endif
     auto plugin_dir = std::filesystem::path(path).parent_path().append("plugins");
 
     if (!std::filesystem::is_directory(plugin_dir))
@@ -3,12 +3,21 @@
 #include <cstring>
 #include <expected>
 #include <filesystem>
+#include <format>
 #include <iostream>
 #include <map>
+#include <string>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include "thirdparty/lua/include/lua.hpp"
 
+#ifdef _WIN32
 typedef int(__stdcall* LUA_FUNCTION)(lua_State* L);
+#else
+typedef int(*LUA_FUNCTION)(lua_State* L);
+#endif
 
 namespace gdbw
 {
@@ -25,6 +34,10 @@ namespace gdbw
 		bool Prompt();
 		// Register a C[++] function as a globally available function in the lua state 
 		void RegisterGlobalFunction(LUA_FUNCTION func, const char* name);
+		// Compile a script once, returns a reference to pass to RunScript
+		std::expected<int, std::string> LoadScript(const std::string& path);
+		// Run a loaded script, `arg` is passed as its first vararg (local input = ...)
+		std::expected<bool, std::string> RunScript(int script, const std::string& arg);
 	private:
 		// Load all plugins for the debugger
 		std::expected<bool, std::string> LoadPlugins();
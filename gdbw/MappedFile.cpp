@@ -0,0 +1,85 @@
+#include "MappedFile.hpp"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+gdbw::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+std::expected<bool, std::string> gdbw::MappedFile::Open(const std::string& path)
+{
+	Close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return std::unexpected(std::format("MappedFile.Open failed to open {} ({:#x})", path, GetLastError()));
+	m_file = file;
+
+	LARGE_INTEGER size = { 0 };
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return std::unexpected(std::format("MappedFile.Open {} is empty", path));
+	}
+
+	m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping == NULL)
+	{
+		Close();
+		return std::unexpected(std::format("MappedFile.Open failed to map {} ({:#x})", path, GetLastError()));
+	}
+
+	m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data == nullptr)
+	{
+		Close();
+		return std::unexpected(std::format("MappedFile.Open failed to map {} ({:#x})", path, GetLastError()));
+	}
+	m_size = (size_t)size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return std::unexpected(std::format("MappedFile.Open failed to open {}", path));
+
+	struct stat st = { 0 };
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return std::unexpected(std::format("MappedFile.Open {} is empty", path));
+	}
+
+	void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return std::unexpected(std::format("MappedFile.Open failed to map {}", path));
+	m_data = (const uint8_t*)data;
+	m_size = st.st_size;
+#endif
+	return true;
+}
+
+void gdbw::MappedFile::Close(void)
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file)
+		CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = nullptr;
+#else
+	if (m_data)
+		munmap((void*)m_data, m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+
+namespace gdbw
+{
+	// Read-only memory mapping of a whole file
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		std::expected<bool, std::string> Open(const std::string& path);
+		void Close(void);
+
+		inline const uint8_t* Data(void) const { return m_data; }
+		inline size_t Size(void) const { return m_size; }
+		// Pointer to [offset, offset+len) or nullptr if that runs past the end of the file
+		inline const uint8_t* At(uint64_t offset, uint64_t len) const
+		{
+			return (offset <= m_size && len <= m_size - offset) ? m_data + offset : nullptr;
+		}
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+}
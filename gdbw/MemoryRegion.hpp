@@ -1,25 +1,27 @@
 #pragma once
-#include <Windows.h>
-#include <expected>
-#include <print>
-#include "LuaManager.hpp"
+#include <cstdint>
+#include <vector>
+#include "Target.hpp"
 
 class MemoryRegion
 {
 public:
-	MemoryRegion(PMEMORY_BASIC_INFORMATION64 mbi);
+	MemoryRegion(const gdbw::TargetRegion& region);
 	~MemoryRegion();
 
-	static void CreateMemoryRegionTable(lua_State* L, std::vector<MemoryRegion*> regions);
-
-	inline ULONG64 BaseAddress(void) const { return m_baseaddress; }
-	inline DWORD Protections(void) const { return m_protections; }
-	inline DWORD State(void) const { return m_state; }
-	inline ULONG64 Size(void) const { return m_size; }
+	inline uint64_t BaseAddress(void) const { return m_baseaddress; }
+	inline uint64_t AllocationBase(void) const { return m_allocationbase; }
+	inline uint32_t Protections(void) const { return m_protections; }
+	inline uint32_t State(void) const { return m_state; }
+	inline uint32_t Type(void) const { return m_type; }
+	inline uint64_t Size(void) const { return m_size; }
+	// Returns true if address lies within this region
+	inline bool Contains(uint64_t address) const { return address >= m_baseaddress && address - m_baseaddress < m_size; }
 private:
-	ULONG64 m_baseaddress = 0;
-	DWORD m_protections = 0;
-	DWORD m_state = 0;
-	ULONG64 m_size = 0;
+	uint64_t m_baseaddress = 0;
+	uint64_t m_allocationbase = 0;
+	uint32_t m_protections = 0;
+	uint32_t m_state = 0;
+	uint32_t m_type = 0;
+	uint64_t m_size = 0;
 };
-
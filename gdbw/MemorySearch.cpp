@@ -0,0 +1,186 @@
+#include "MemorySearch.hpp"
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GDBW_SSE2 1
+#endif
+
+gdbw::BytePattern::BytePattern(std::vector<uint8_t> bytes, std::vector<uint8_t> mask)
+{
+	m_bytes = std::move(bytes);
+	m_mask = std::move(mask);
+	m_wildcards = std::find(m_mask.begin(), m_mask.end(), 0) != m_mask.end();
+	m_first = std::find(m_mask.begin(), m_mask.end(), 0xFF) - m_mask.begin();
+	m_last = m_mask.rend() - std::find(m_mask.rbegin(), m_mask.rend(), 0xFF) - 1;
+}
+
+std::expected<gdbw::BytePattern, std::string> gdbw::BytePattern::FromHex(std::string_view hex)
+{
+	std::vector<uint8_t> bytes;
+	std::vector<uint8_t> mask;
+	bool fixed = false;
+	for (size_t i = 0; i < hex.size();)
+	{
+		if (isspace((unsigned char)hex[i]))
+		{
+			i++;
+			continue;
+		}
+		if (hex[i] == '?')
+		{
+			i += (i + 1 < hex.size() && hex[i + 1] == '?') ? 2 : 1;
+			bytes.push_back(0);
+			mask.push_back(0);
+			continue;
+		}
+		if (i + 1 >= hex.size() || !isxdigit((unsigned char)hex[i]) || !isxdigit((unsigned char)hex[i + 1]))
+			return std::unexpected(std::format("BytePattern.FromHex invalid byte at offset {} of '{}'", i, hex));
+		bytes.push_back((uint8_t)std::stoul(std::string(hex.substr(i, 2)), nullptr, 16));
+		mask.push_back(0xFF);
+		fixed = true;
+		i += 2;
+	}
+	// Nothing to anchor the prefilter on, and every address would match anyway
+	if (!fixed)
+		return std::unexpected("BytePattern.FromHex pattern needs at least one non-wildcard byte");
+	return BytePattern(std::move(bytes), std::move(mask));
+}
+
+gdbw::BytePattern gdbw::BytePattern::FromBytes(const void* data, size_t len)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	return BytePattern(std::vector<uint8_t>(bytes, bytes + len), std::vector<uint8_t>(len, 0xFF));
+}
+
+std::expected<gdbw::BytePattern, std::string> gdbw::BytePattern::FromWide(std::string_view str)
+{
+	std::vector<uint8_t> bytes;
+	bytes.reserve(str.size() * 2);
+	auto unit = [&](uint32_t value) {
+		bytes.push_back((uint8_t)value);
+		bytes.push_back((uint8_t)(value >> 8));
+	};
+
+	for (size_t i = 0; i < str.size();)
+	{
+		uint8_t lead = (uint8_t)str[i];
+		// Sequence length & the smallest code point it may encode (shorter forms are overlong)
+		size_t length = lead < 0x80 ? 1 : (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 0;
+		static constexpr uint32_t Minimum[] = { 0, 0, 0x80, 0x800, 0x10000 };
+		if (length == 0 || i + length > str.size())
+			return std::unexpected(std::format("BytePattern.FromWide invalid UTF-8 at offset {}", i));
+
+		uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+		for (size_t j = 1; j < length; j++)
+		{
+			uint8_t next = (uint8_t)str[i + j];
+			if ((next & 0xC0) != 0x80)
+				return std::unexpected(std::format("BytePattern.FromWide invalid UTF-8 at offset {}", i));
+			codepoint = (codepoint << 6) | (next & 0x3F);
+		}
+		if (codepoint < Minimum[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+			return std::unexpected(std::format("BytePattern.FromWide invalid UTF-8 at offset {}", i));
+		i += length;
+
+		if (codepoint < 0x10000)
+			unit(codepoint);
+		else
+		{
+			codepoint -= 0x10000;
+			unit(0xD800 | (codepoint >> 10));
+			unit(0xDC00 | (codepoint & 0x3FF));
+		}
+	}
+	return BytePattern(bytes, std::vector<uint8_t>(bytes.size(), 0xFF));
+}
+
+bool gdbw::BytePattern::Matches(const uint8_t* data) const
+{
+	if (!m_wildcards)
+		return memcmp(data, m_bytes.data(), m_bytes.size()) == 0;
+	for (size_t i = 0; i < m_bytes.size(); i++)
+	{
+		if ((data[i] & m_mask[i]) != m_bytes[i])
+			return false;
+	}
+	return true;
+}
+
+bool gdbw::BytePattern::Scan(const uint8_t* data, size_t len, uint64_t base, uint32_t alignment, size_t limit, std::vector<uint64_t>& out) const
+{
+	if (m_bytes.empty() || len < m_bytes.size())
+		return true;
+
+	// Number of offsets a match can start at
+	size_t count = len - m_bytes.size() + 1;
+	auto candidate = [&](size_t offset) -> bool {
+		if ((base + offset) % alignment != 0 || !Matches(data + offset))
+			return true;
+		out.push_back(base + offset);
+		return limit == 0 || out.size() < limit;
+	};
+
+	size_t i = 0;
+#ifdef GDBW_SSE2
+	// Compare the first & last fixed byte of 16 candidates at once, only offsets where both match
+	// are compared in full. Loads stay inside the buffer: i + 15 + m_last <= count - 1 + m_last < len.
+	const __m128i first = _mm_set1_epi8((char)m_bytes[m_first]);
+	const __m128i last = _mm_set1_epi8((char)m_bytes[m_last]);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(data + i + m_first));
+		__m128i b = _mm_loadu_si128((const __m128i*)(data + i + m_last));
+		uint32_t hits = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+		while (hits != 0)
+		{
+			if (!candidate(i + std::countr_zero(hits)))
+				return false;
+			hits &= hits - 1;
+		}
+	}
+#endif
+	// Remainder (or everything, without SSE2), memchr for the first fixed byte is vectorized by the CRT
+	while (i < count)
+	{
+		const uint8_t* next = (const uint8_t*)memchr(data + i + m_first, m_bytes[m_first], count - i);
+		if (!next)
+			break;
+		i = next - data - m_first;
+		if (!candidate(i))
+			return false;
+		i++;
+	}
+	return true;
+}
+
+std::vector<uint64_t> gdbw::MemorySearch::Search(Target& target, const std::vector<SearchRange>& ranges,
+	const BytePattern& pattern, uint32_t alignment, size_t limit, ScanScheduler::Stats* stats)
+{
+	if (pattern.Size() == 0)
+		return {};
+	alignment = std::max<uint32_t>(alignment, 1);
+
+	// Workers collect their own matches, merged & sorted once the scan is done
+	ScanScheduler scheduler;
+	std::vector<std::vector<uint64_t>> results(scheduler.Workers());
+	std::atomic<size_t> found = 0;
+	auto result = scheduler.Run(target, ranges, pattern.Size() - 1, [&](const ScanChunk& chunk, size_t worker) {
+		auto& matches = results[worker];
+		size_t before = matches.size();
+		pattern.Scan(chunk.data, chunk.size, chunk.address, alignment, limit, matches);
+		found += matches.size() - before;
+		return limit == 0 || found < limit;
+	});
+	if (stats)
+		*stats = result;
+
+	// Chunks are handed out in address order, so when the scan stopped early every chunk before the
+	// one that hit the limit was still scanned and the first `limit` matches are exact
+	std::vector<uint64_t> matches;
+	matches.reserve(found);
+	for (auto& worker : results)
+		matches.insert(matches.end(), worker.begin(), worker.end());
+	std::sort(matches.begin(), matches.end());
+	if (limit != 0 && matches.size() > limit)
+		matches.resize(limit);
+	return matches;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ScanScheduler.hpp"
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Byte pattern with optional wildcard bytes
+	class BytePattern
+	{
+	public:
+		// Hex bytes with ?? wildcards, whitespace is optional (e.g. "48 8b ?? 05" or "488b??05")
+		static std::expected<BytePattern, std::string> FromHex(std::string_view hex);
+		// Exact bytes, e.g. a string or a little endian integer
+		static BytePattern FromBytes(const void* data, size_t len);
+		// UTF-8 string encoded as UTF-16LE (surrogate pairs past U+FFFF), fails on invalid UTF-8
+		static std::expected<BytePattern, std::string> FromWide(std::string_view str);
+
+		inline size_t Size(void) const { return m_bytes.size(); }
+		// Find matches in [data, data+len), appends `base + offset` of every match aligned to `alignment`.
+		// Stops once `out` holds `limit` matches (0 for no limit), returns false if it did.
+		bool Scan(const uint8_t* data, size_t len, uint64_t base, uint32_t alignment, size_t limit, std::vector<uint64_t>& out) const;
+	private:
+		BytePattern(std::vector<uint8_t> bytes, std::vector<uint8_t> mask);
+		bool Matches(const uint8_t* data) const;
+
+		std::vector<uint8_t> m_bytes;
+		std::vector<uint8_t> m_mask; // 0xFF for fixed bytes, 0 for wildcards
+		bool m_wildcards = false;
+		// First & last fixed byte, candidates are filtered on both before comparing the whole pattern
+		size_t m_first = 0;
+		size_t m_last = 0;
+	};
+
+	// Runs a BytePattern over target memory on every core, see ScanScheduler
+	class MemorySearch
+	{
+	public:
+		// Search every range for `pattern`, returns the addresses of matches in ascending order.
+		// Unreadable ranges are skipped.
+		static std::vector<uint64_t> Search(Target& target, const std::vector<SearchRange>& ranges,
+			const BytePattern& pattern, uint32_t alignment = 1, size_t limit = 0, ScanScheduler::Stats* stats = nullptr);
+	};
+}
@@ -0,0 +1,111 @@
+#include "PageCache.hpp"
+
+gdbw::PageCache::PageCache(ReadFunction backend)
+{
+	m_backend = backend;
+}
+
+gdbw::PageCache::~PageCache()
+{
+	Flush();
+}
+
+std::expected<uint32_t, std::string> gdbw::PageCache::Read(uint64_t address, uint32_t len, void* out)
+{
+	// Large bulk reads (e.g. scanning) would just evict everything useful, pass them straight through
+	if (len > MaxCachedRead)
+		return m_backend(address, len, out);
+
+	// Reads spanning several pages fetch everything missing in one go, backends with a high
+	// per request cost (e.g. a remote stub) then pay one round trip instead of one per page
+	if (len > 0)
+		FetchPages(address & ~(PageSize - 1), (address + len - 1) & ~(PageSize - 1));
+
+	uint8_t* dst = (uint8_t*)out;
+	uint32_t done = 0;
+	while (done < len)
+	{
+		uint64_t current = address + done;
+		uint64_t pagebase = current & ~(PageSize - 1);
+		uint64_t offset = current - pagebase;
+		uint32_t chunk = (uint32_t)std::min<uint64_t>(PageSize - offset, len - done);
+
+		const Page* page = GetPage(pagebase);
+		if (!page->readable)
+		{
+			if (done == 0)
+				return std::unexpected(std::format("PageCache.Read failed to read memory at {:#x}", current));
+			break; // short read, same as the backend would give us
+		}
+
+		memcpy(dst + done, page->data + offset, chunk);
+		done += chunk;
+	}
+	return done;
+}
+
+void gdbw::PageCache::Invalidate(uint64_t address, uint64_t len)
+{
+	if (len == 0) return;
+	uint64_t first = address & ~(PageSize - 1);
+	uint64_t last = (address + len - 1) & ~(PageSize - 1);
+	for (uint64_t pagebase = first; pagebase <= last; pagebase += PageSize)
+	{
+		m_pages.erase(pagebase);
+		if (pagebase == last) break; // don't wrap at the top of the address space
+	}
+}
+
+void gdbw::PageCache::Flush(void)
+{
+	m_pages.clear();
+}
+
+const gdbw::PageCache::Page* gdbw::PageCache::GetPage(uint64_t pagebase)
+{
+	auto it = m_pages.find(pagebase);
+	if (it != m_pages.end())
+	{
+		m_hits++;
+		return it->second.get();
+	}
+
+	m_misses++;
+	auto page = std::make_unique<Page>();
+	auto result = m_backend(pagebase, (uint32_t)PageSize, page->data);
+	page->readable = result && *result == PageSize;
+
+	const Page* cached = page.get();
+	m_pages[pagebase] = std::move(page);
+	return cached;
+}
+
+void gdbw::PageCache::FetchPages(uint64_t first, uint64_t last)
+{
+	// Trim pages that are already cached off both ends
+	while (first < last && m_pages.contains(first))
+		first += PageSize;
+	while (last > first && m_pages.contains(last))
+		last -= PageSize;
+	if (first >= last)
+		return; // nothing missing or a single page, GetPage handles that
+
+	uint64_t len = last + PageSize - first;
+	auto buffer = std::make_unique<uint8_t[]>(len);
+	auto result = m_backend(first, (uint32_t)len, buffer.get());
+	if (!result)
+		return; // leave it to GetPage, which will find the unreadable page(s)
+
+	// Only keep whole pages, anything after a short read is fetched (and marked) page by page
+	uint64_t fetched = *result & ~(PageSize - 1);
+	for (uint64_t offset = 0; offset < fetched; offset += PageSize)
+	{
+		if (m_pages.contains(first + offset))
+			continue;
+		m_misses++;
+		auto page = std::make_unique<Page>();
+		page->readable = true;
+		memcpy(page->data, buffer.get() + offset, PageSize);
+		m_pages[first + offset] = std::move(page);
+	}
+}
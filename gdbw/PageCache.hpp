@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace gdbw
+{
+	// Page granular read cache that sits in front of a (slow) memory backend.
+	// Pages are fetched once and kept until the owner flushes the cache, which the
+	// engine does whenever the target is resumed or memory is written.
+	class PageCache
+	{
+	public:
+		static constexpr uint64_t PageSize = 0x1000;
+		// Reads larger than this bypass the cache entirely
+		static constexpr uint32_t MaxCachedRead = 64 * PageSize;
+
+		// Backend read function. Reads up to `len` bytes at `address` into `out`,
+		// returns the number of bytes actually read.
+		using ReadFunction = std::function<std::expected<uint32_t, std::string>(uint64_t address, uint32_t len, void* out)>;
+
+		PageCache(ReadFunction backend);
+		~PageCache();
+
+		// Read `len` bytes at `address` into `out`. Returns the number of bytes read,
+		// which may be short if the read runs into an unreadable page.
+		std::expected<uint32_t, std::string> Read(uint64_t address, uint32_t len, void* out);
+		// Drop every cached page overlapping [address, address+len)
+		void Invalidate(uint64_t address, uint64_t len);
+		// Drop every cached page
+		void Flush(void);
+
+		inline uint64_t Hits(void) const { return m_hits; }
+		inline uint64_t Misses(void) const { return m_misses; }
+		inline size_t CachedPages(void) const { return m_pages.size(); }
+	private:
+		struct Page
+		{
+			// false when the backend failed to read the page, so repeated reads of
+			// unmapped memory during a single stop don't hit the backend either
+			bool readable = false;
+			uint8_t data[PageSize];
+		};
+
+		// Get a page from the cache, fetching it from the backend on a miss
+		const Page* GetPage(uint64_t pagebase);
+		// Fetch the missing pages in [first, last] with a single backend read
+		void FetchPages(uint64_t first, uint64_t last);
+
+		ReadFunction m_backend;
+		std::unordered_map<uint64_t, std::unique_ptr<Page>> m_pages;
+		uint64_t m_hits = 0;
+		uint64_t m_misses = 0;
+	};
+}
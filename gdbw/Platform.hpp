@@ -0,0 +1,43 @@
+#pragma once
+// Win32 & DbgEng names used by the engine's portable interface (integer types, breakpoint flags, region
+// protections). On Windows they come from the SDK, elsewhere there's no DbgEng session and only the values
+// the engine hands to bindings & other targets are defined here.
+#ifdef _WIN32
+#include <windows.h>
+#include <DbgEng.h>
+#else
+#include <cstdint>
+
+typedef uint32_t ULONG;
+typedef uint64_t ULONG64;
+typedef uint32_t DWORD;
+typedef uint64_t DWORD64;
+typedef ULONG* PULONG;
+typedef void* PVOID;
+typedef char* PSTR;
+typedef const char* PCSTR;
+
+// Opaque, breakpoints are never backed by DbgEng off Windows
+struct IDebugBreakpoint;
+typedef IDebugBreakpoint* PDEBUG_BREAKPOINT;
+
+#define DEBUG_STATUS_NO_CHANGE 0
+#define DEBUG_STATUS_GO 1
+
+#define DEBUG_BREAKPOINT_ENABLED 0x00000004
+#define DEBUG_BREAKPOINT_ONE_SHOT 0x00000010
+
+#define DEBUG_BREAK_READ 0x00000001
+#define DEBUG_BREAK_WRITE 0x00000002
+#define DEBUG_BREAK_EXECUTE 0x00000004
+
+#define DEBUG_INTERRUPT_ACTIVE 0
+
+// Target regions use the Windows protection values on every backend (see TargetRegion)
+#define PAGE_NOACCESS 0x01
+#define PAGE_READWRITE 0x04
+#define PAGE_WRITECOPY 0x08
+#define PAGE_EXECUTE_READWRITE 0x40
+#define PAGE_EXECUTE_WRITECOPY 0x80
+#define PAGE_GUARD 0x100
+#endif
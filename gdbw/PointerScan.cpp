@@ -0,0 +1,147 @@
+#include "PointerScan.hpp"
+
+gdbw::PointerIndex gdbw::PointerIndex::Build(Target& target, const RegionMap& regions, const std::vector<SearchRange>& ranges,
+	bool is64bit, ScanScheduler::Stats* stats)
+{
+	PointerIndex index;
+	const auto& all = regions.Regions();
+	if (all.empty())
+		return index;
+
+	// Most values aren't pointers, reject them on the bounds of the map before any lookup
+	uint64_t lowest = all.front().BaseAddress();
+	uint64_t highest = all.back().BaseAddress() + all.back().Size();
+	size_t width = is64bit ? 8 : 4;
+
+	ScanScheduler scheduler;
+	std::vector<std::vector<Entry>> results(scheduler.Workers());
+	auto result = scheduler.Run(target, ranges, 0, [&](const ScanChunk& chunk, size_t worker) {
+		auto& entries = results[worker];
+		// Neighbouring pointers usually point into the same region, try that before searching
+		const MemoryRegion* last = nullptr;
+		size_t skip = (width - chunk.address % width) % width;
+		for (size_t offset = skip; offset + width <= chunk.size; offset += width)
+		{
+			uint64_t value = 0;
+			memcpy(&value, chunk.data + offset, width);
+			if (value < lowest || value >= highest)
+				continue;
+			if (!last || !last->Contains(value))
+			{
+				ptrdiff_t region = regions.Find(value);
+				if (region < 0)
+					continue;
+				last = &all[region];
+			}
+			entries.push_back({ value, chunk.address + offset });
+		}
+		return true;
+	});
+	if (stats)
+		*stats = result;
+
+	// One run per worker, sorted in parallel and then merged pairwise in parallel
+	std::vector<size_t> bounds = { 0 };
+	size_t total = 0;
+	for (auto& entries : results)
+		total += entries.size();
+	index.m_entries.reserve(total);
+	for (auto& entries : results)
+	{
+		if (entries.empty())
+			continue;
+		index.m_entries.insert(index.m_entries.end(), entries.begin(), entries.end());
+		bounds.push_back(index.m_entries.size());
+		std::vector<Entry>().swap(entries);
+	}
+
+	auto begin = index.m_entries.begin();
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i + 1 < bounds.size(); i++)
+		threads.emplace_back([&, i] { std::sort(begin + bounds[i], begin + bounds[i + 1]); });
+	for (auto& thread : threads)
+		thread.join();
+
+	while (bounds.size() > 2)
+	{
+		threads.clear();
+		std::vector<size_t> merged = { 0 };
+		for (size_t i = 0; i + 1 < bounds.size(); i += 2)
+		{
+			if (i + 2 < bounds.size())
+			{
+				threads.emplace_back([&, i] { std::inplace_merge(begin + bounds[i], begin + bounds[i + 1], begin + bounds[i + 2]); });
+				merged.push_back(bounds[i + 2]);
+			}
+			else
+				merged.push_back(bounds[i + 1]); // odd run out, merged next round
+		}
+		for (auto& thread : threads)
+			thread.join();
+		bounds = std::move(merged);
+	}
+	return index;
+}
+
+std::vector<gdbw::PointerPath> gdbw::PointerScan::Find(const PointerIndex& index, const RegionMap& regions, uint64_t target, const Options& options)
+{
+	std::vector<PointerPath> paths;
+	std::vector<Node> nodes = { { target, 0, 0 } };
+	std::unordered_set<uint64_t> visited = { target };
+	size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	// Every level holds the addresses `depth` dereferences away from the target
+	size_t begin = 0;
+	for (size_t depth = 1; depth <= options.depth && begin < nodes.size(); depth++)
+	{
+		// Expand the level in parallel, each worker takes a contiguous block of nodes so
+		// concatenating their candidates keeps node order and the result is deterministic
+		size_t end = nodes.size();
+		size_t count = end - begin;
+		size_t workers = std::min(threads, (count + 255) / 256);
+		std::vector<std::vector<Candidate>> found(workers);
+		auto expand = [&](size_t worker) {
+			size_t first = begin + count * worker / workers;
+			size_t last = begin + count * (worker + 1) / workers;
+			for (size_t n = first; n < last; n++)
+			{
+				uint64_t address = nodes[n].address;
+				uint64_t low = address >= options.offset ? address - options.offset : 0;
+				auto [entry, stop] = index.Between(low, address);
+				for (; entry != stop; entry++)
+					found[worker].push_back({ entry->location, (uint32_t)n, (uint32_t)(address - entry->value) });
+			}
+		};
+		std::vector<std::thread> pool;
+		for (size_t worker = 1; worker < workers; worker++)
+			pool.emplace_back(expand, worker);
+		expand(0);
+		for (auto& thread : pool)
+			thread.join();
+
+		for (auto& candidates : found)
+		{
+			for (auto& candidate : candidates)
+			{
+				// A pointer stored in an image is static, that's the end of this path
+				ptrdiff_t region = regions.Find(candidate.location);
+				if (region >= 0 && regions.Kind(region) == RegionKind::IMAGE)
+				{
+					PointerPath path = { candidate.location, { candidate.offset } };
+					for (uint32_t n = candidate.parent; n != 0; n = nodes[n].parent)
+						path.offsets.push_back(nodes[n].offset);
+					paths.push_back(std::move(path));
+					if (options.limit != 0 && paths.size() >= options.limit)
+						return paths;
+					continue;
+				}
+				// Addresses reached on an earlier level already have a path at least as short
+				if (depth == options.depth || nodes.size() >= options.nodes || !visited.insert(candidate.location).second)
+					continue;
+				nodes.push_back({ candidate.location, candidate.parent, candidate.offset });
+			}
+		}
+		begin = end;
+	}
+	return paths;
+}
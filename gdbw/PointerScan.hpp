@@ -0,0 +1,78 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "RegionMap.hpp"
+#include "ScanScheduler.hpp"
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Reverse pointer index, every aligned pointer sized value in the scanned memory that points
+	// into a committed region, sorted by value. Flat arrays keep it at 16 bytes per pointer.
+	class PointerIndex
+	{
+	public:
+		struct Entry
+		{
+			uint64_t value;    // pointer
+			uint64_t location; // address the pointer is stored at
+			inline bool operator<(const Entry& other) const { return value < other.value || (value == other.value && location < other.location); }
+		};
+
+		// Index every pointer stored in `ranges` (sorted by address) whose value lies in a region of `regions`
+		static PointerIndex Build(Target& target, const RegionMap& regions, const std::vector<SearchRange>& ranges,
+			bool is64bit, ScanScheduler::Stats* stats = nullptr);
+
+		// Entries with a value in [low, high], in ascending value order
+		inline std::pair<const Entry*, const Entry*> Between(uint64_t low, uint64_t high) const
+		{
+			auto first = std::lower_bound(m_entries.begin(), m_entries.end(), low, [](const Entry& entry, uint64_t value) { return entry.value < value; });
+			auto last = std::upper_bound(first, m_entries.end(), high, [](uint64_t value, const Entry& entry) { return value < entry.value; });
+			return { m_entries.data() + (first - m_entries.begin()), m_entries.data() + (last - m_entries.begin()) };
+		}
+		inline size_t Size(void) const { return m_entries.size(); }
+	private:
+		std::vector<Entry> m_entries;
+	};
+
+	// Chain of pointers from a static address to a target, i.e. target == [[[base] + offsets[0]] + offsets[1]] ...
+	struct PointerPath
+	{
+		uint64_t base;                 // location in an image region
+		std::vector<uint32_t> offsets; // added after each dereference, the last one lands on the target
+	};
+
+	// Finds pointer paths leading from image backed (static) memory to an address by walking the
+	// reverse pointer index breadth first, so the shortest paths are found first.
+	class PointerScan
+	{
+	public:
+		struct Options
+		{
+			size_t depth = 4;           // maximum number of dereferences
+			uint32_t offset = 0x1000;   // maximum offset added after a dereference
+			size_t limit = 256;         // stop after this many paths (0 for no limit)
+			size_t nodes = 1 << 22;     // bound on the addresses visited
+		};
+
+		static std::vector<PointerPath> Find(const PointerIndex& index, const RegionMap& regions, uint64_t target, const Options& options);
+	private:
+		struct Node
+		{
+			uint64_t address;
+			uint32_t parent; // index of the node this one points (near) to
+			uint32_t offset; // offset from the pointer stored here to the parent
+		};
+		// Location found while expanding a level, `parent` indexes the node it leads to
+		struct Candidate
+		{
+			uint64_t location;
+			uint32_t parent;
+			uint32_t offset;
+		};
+	};
+}
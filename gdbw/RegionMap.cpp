@@ -0,0 +1,74 @@
+#include "RegionMap.hpp"
+
+// Windows values, regions are reported the same way regardless of backend
+static constexpr uint32_t MemMapped = 0x40000;
+static constexpr uint32_t MemImage = 0x1000000;
+
+void gdbw::RegionMap::Clear(void)
+{
+	m_regions.clear();
+	m_info.clear();
+	m_names.Clear();
+}
+
+void gdbw::RegionMap::Add(const MemoryRegion& region)
+{
+	// Id 0 is always the empty name
+	if (m_names.Count() == 0)
+		m_names.Intern("");
+
+	RegionKind kind = RegionKind::PRIVATE;
+	if (region.Type() == MemImage)
+		kind = RegionKind::IMAGE;
+	else if (region.Type() == MemMapped)
+		kind = RegionKind::MAPPED;
+
+	m_regions.push_back(region);
+	m_info.push_back({ kind, 0 });
+}
+
+template <typename F>
+void gdbw::RegionMap::ForAllocation(uint64_t allocationbase, F fn)
+{
+	// Regions of one allocation are contiguous and start at the allocation base
+	ptrdiff_t i = Find(allocationbase);
+	if (i < 0) return;
+	for (size_t j = i; j < m_regions.size() && m_regions[j].AllocationBase() == allocationbase; j++)
+		fn(m_info[j]);
+}
+
+void gdbw::RegionMap::SetKind(uint64_t allocationbase, RegionKind kind)
+{
+	ForAllocation(allocationbase, [kind](Info& info) { info.kind = kind; });
+}
+
+void gdbw::RegionMap::SetModule(uint64_t allocationbase, std::string_view name)
+{
+	uint32_t id = m_names.Intern(name);
+	ForAllocation(allocationbase, [id](Info& info) { info.module = id; });
+}
+
+ptrdiff_t gdbw::RegionMap::Find(uint64_t address) const
+{
+	// First region starting after address, the one before it is the only candidate
+	auto it = std::upper_bound(m_regions.begin(), m_regions.end(), address,
+		[](uint64_t addr, const MemoryRegion& region) { return addr < region.BaseAddress(); });
+	if (it == m_regions.begin())
+		return -1;
+	--it;
+	if (!it->Contains(address))
+		return -1;
+	return it - m_regions.begin();
+}
+
+const char* gdbw::RegionMap::KindName(RegionKind kind)
+{
+	switch (kind)
+	{
+	case RegionKind::MAPPED: return "mapped";
+	case RegionKind::IMAGE: return "image";
+	case RegionKind::STACK: return "stack";
+	case RegionKind::HEAP: return "heap";
+	default: return "private";
+	}
+}
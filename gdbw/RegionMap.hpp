@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "MemoryRegion.hpp"
+#include "StringPool.hpp"
+
+namespace gdbw
+{
+	// What a region is used for, worked out once when the map is built
+	enum class RegionKind : uint8_t
+	{
+		PRIVATE = 0,
+		MAPPED,
+		IMAGE,
+		STACK,
+		HEAP
+	};
+
+	// Sorted map of committed memory regions plus what each one is used for.
+	// Regions never overlap so any address can be resolved with a binary search.
+	class RegionMap
+	{
+	public:
+		RegionMap() = default;
+		~RegionMap() = default;
+
+		// Drop every region
+		void Clear(void);
+		// Append a region, regions must be added in ascending address order
+		void Add(const MemoryRegion& region);
+		// Classify every region belonging to the allocation at `allocationbase`
+		void SetKind(uint64_t allocationbase, RegionKind kind);
+		// Name every region belonging to the allocation at `allocationbase` (i.e. a module)
+		void SetModule(uint64_t allocationbase, std::string_view name);
+		// Index of the region containing `address`, or -1
+		ptrdiff_t Find(uint64_t address) const;
+
+		static const char* KindName(RegionKind kind);
+
+		inline const std::vector<MemoryRegion>& Regions(void) const { return m_regions; }
+		inline RegionKind Kind(size_t index) const { return m_info[index].kind; }
+		// Module name, empty if the region isn't part of an image
+		inline const char* Module(size_t index) const { return m_names.Get(m_info[index].module); }
+	private:
+		struct Info
+		{
+			RegionKind kind;
+			uint32_t module; // StringPool id, 0 is ""
+		};
+
+		// Apply `fn` to the info of every region belonging to the allocation at `allocationbase`
+		template <typename F>
+		void ForAllocation(uint64_t allocationbase, F fn);
+
+		std::vector<MemoryRegion> m_regions; // sorted by base address, non-overlapping
+		std::vector<Info> m_info;            // parallel to m_regions
+		StringPool m_names;
+	};
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gdbw::DE
+{
+	// Fixed register layouts that can be fetched in a single engine round trip
+	enum class RegisterSet
+	{
+		GP32 = 0,
+		GP64,
+		COUNT
+	};
+
+	// Largest register set, sizes RegisterContext::values
+	static constexpr size_t MaxRegisters = 17;
+
+	static constexpr const char* GP32Registers[] = {
+		"eax","ebx","ecx","edx","esi","edi","eip","esp","ebp"
+	};
+
+	static constexpr const char* GP64Registers[] = {
+		"rax","rbx","rcx","rdx","rsi","rdi","rip","rsp","rbp",
+		"r8","r9","r10","r11","r12","r13","r14","r15"
+	};
+
+	// Get the register names making up a set, returns the number of registers
+	inline size_t GetRegisterSetNames(RegisterSet set, const char* const** names)
+	{
+		switch (set)
+		{
+		case RegisterSet::GP32:
+			*names = GP32Registers;
+			return sizeof(GP32Registers) / sizeof(GP32Registers[0]);
+		case RegisterSet::GP64:
+			*names = GP64Registers;
+			return sizeof(GP64Registers) / sizeof(GP64Registers[0]);
+		default:
+			*names = nullptr;
+			return 0;
+		}
+	}
+
+	// Flat register values for a set, values[i] belongs to names[i]
+	struct RegisterContext
+	{
+		RegisterSet set;
+		size_t count;
+		const char* const* names;
+		uint64_t values[MaxRegisters];
+	};
+
+	// Single register in a full context fetch. Scalar registers (flags, segments, debug, mxcsr...)
+	// use `value`, vector and x87 registers are returned as raw little endian bytes.
+	struct FullContextValue
+	{
+		const char* name;
+		bool isvector;
+		uint64_t value;
+		uint8_t size;      // bytes used in `bytes` for vector registers
+		uint8_t bytes[32]; // large enough for a ymm register
+	};
+
+	// Register making up part of a full context, may be composed of several engine registers
+	// (e.g. ymm0 = xmm0 + ymm0h)
+	struct FullContextRegister
+	{
+		std::string name;
+		bool isvector;
+		std::vector<size_t> parts; // indexes into FullContextLayout::indices
+	};
+
+	// Engine register layout for a processor type, resolved once
+	struct FullContextLayout
+	{
+		std::vector<FullContextRegister> registers;
+		std::vector<unsigned long> indices; // engine register indices, fetched in one call
+	};
+}
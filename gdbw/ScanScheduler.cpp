@@ -0,0 +1,133 @@
+#include "ScanScheduler.hpp"
+
+std::atomic<bool> gdbw::ScanScheduler::s_cancel = false;
+std::atomic<int> gdbw::ScanScheduler::s_running = 0;
+thread_local size_t gdbw::ScanScheduler::s_defaultworkers = 0;
+
+gdbw::ScanScheduler::ScanScheduler(size_t workers, size_t buffers)
+{
+	m_workers = workers != 0 ? workers : DefaultWorkers();
+	m_slots = buffers != 0 ? buffers : m_workers * 2;
+	m_buffers.resize(m_slots);
+}
+
+size_t gdbw::ScanScheduler::DefaultWorkers(void)
+{
+	return s_defaultworkers != 0 ? s_defaultworkers : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+gdbw::ScanScheduler::Stats gdbw::ScanScheduler::Run(Target& target, const std::vector<SearchRange>& ranges, size_t overlap, const Job& job)
+{
+	Stats stats;
+	auto start = std::chrono::steady_clock::now();
+	if (s_running++ == 0)
+		s_cancel = false;
+
+	m_queue.clear();
+	m_free.clear();
+	for (size_t i = 0; i < m_slots; i++)
+		m_free.push_back(i);
+	m_done = false;
+	m_stopped = false;
+
+	std::vector<std::thread> workers;
+	workers.reserve(m_workers);
+	for (size_t i = 0; i < m_workers; i++)
+		workers.emplace_back(&ScanScheduler::Worker, this, i, std::cref(job));
+
+	for (size_t r = 0; r < ranges.size(); r++)
+	{
+		const SearchRange& range = ranges[r];
+		for (uint64_t offset = 0; offset < range.size; offset += ChunkSize)
+		{
+			// Wait for a free slot, this is what bounds the memory held by a scan
+			size_t slot = 0;
+			{
+				std::unique_lock lock(m_lock);
+				m_freed.wait(lock, [&] { return !m_free.empty() || m_stopped || s_cancel; });
+				if (m_stopped || s_cancel)
+					goto FINISHED;
+				slot = m_free.back();
+				m_free.pop_back();
+			}
+
+			uint64_t address = range.address + offset;
+			size_t len = (size_t)std::min<uint64_t>(ChunkSize + overlap, range.size - offset);
+			ScanChunk chunk = { r, address, target.View(address, (uint32_t)len), len, offset + ChunkSize >= range.size };
+			if (!chunk.data)
+			{
+				auto& buffer = m_buffers[slot];
+				buffer.resize(len);
+				auto result = target.ReadMemory(address, (uint32_t)len, buffer.data());
+				chunk.data = buffer.data();
+				chunk.size = result ? *result : 0;
+				// Rest of the range is most likely unreadable too
+				chunk.last = chunk.last || chunk.size < len;
+			}
+
+			std::lock_guard lock(m_lock);
+			if (chunk.size == 0)
+				m_free.push_back(slot);
+			else
+			{
+				m_queue.push_back({ chunk, slot });
+				stats.bytes += std::min<uint64_t>(chunk.size, ChunkSize);
+				m_queued.notify_one();
+			}
+			if (chunk.last)
+				break;
+		}
+	}
+
+FINISHED:
+	{
+		std::lock_guard lock(m_lock);
+		m_done = true;
+		m_queued.notify_all();
+	}
+	for (auto& worker : workers)
+		worker.join();
+
+	stats.cancelled = s_cancel;
+	s_running--;
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+void gdbw::ScanScheduler::Worker(size_t worker, const Job& job)
+{
+	while (true)
+	{
+		Item item;
+		{
+			std::unique_lock lock(m_lock);
+			m_queued.wait(lock, [&] { return !m_queue.empty() || m_done; });
+			if (m_queue.empty())
+				return;
+			item = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		bool keepgoing = !s_cancel && job(item.chunk, worker);
+
+		std::lock_guard lock(m_lock);
+		m_free.push_back(item.slot);
+		if (!keepgoing && !m_stopped)
+		{
+			// Everything queued is after this chunk, drop it
+			m_stopped = true;
+			for (auto& queued : m_queue)
+				m_free.push_back(queued.slot);
+			m_queue.clear();
+		}
+		m_freed.notify_one();
+	}
+}
+
+bool gdbw::ScanScheduler::Cancel(void)
+{
+	if (s_running == 0)
+		return false;
+	s_cancel = true;
+	return true;
+}
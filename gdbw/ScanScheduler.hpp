@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Memory range to scan, usually a committed region
+	struct SearchRange
+	{
+		uint64_t address;
+		uint64_t size;
+	};
+
+	// Part of a range handed to a scan job
+	struct ScanChunk
+	{
+		size_t range;     // index into the scanned ranges
+		uint64_t address;
+		const uint8_t* data;
+		size_t size;      // bytes at data, includes the overlap with the next chunk
+		bool last;        // last chunk of its range
+	};
+
+	// Splits ranges into chunks and runs a job over each on worker threads. Target memory is
+	// read on the calling thread (DbgEng may only be used from the thread that created it) into
+	// a bounded set of buffers, so reading the next chunks overlaps with matching the previous.
+	// Targets that can View() their memory are handed to the workers without copying.
+	class ScanScheduler
+	{
+	public:
+		// Bytes per chunk, not counting the overlap
+		static constexpr uint32_t ChunkSize = 4 * 1024 * 1024;
+
+		// Runs on a worker thread, `worker` (< Workers()) indexes per worker state. Return false to stop the scan,
+		// chunks still queued are dropped but every chunk before this one has been or will be completed.
+		using Job = std::function<bool(const ScanChunk& chunk, size_t worker)>;
+
+		struct Stats
+		{
+			uint64_t bytes = 0;
+			double seconds = 0;
+			bool cancelled = false;
+			inline double BytesPerSecond(void) const { return seconds > 0 ? bytes / seconds : 0; }
+		};
+
+		// 0 workers uses DefaultWorkers(), 0 buffers two per worker
+		ScanScheduler(size_t workers = 0, size_t buffers = 0);
+
+		// Scan `ranges` (sorted by address), chunks repeat the first `overlap` bytes of the next chunk
+		// so matches spanning a chunk boundary are seen. Unreadable parts of a range are skipped.
+		Stats Run(Target& target, const std::vector<SearchRange>& ranges, size_t overlap, const Job& job);
+
+		inline size_t Workers(void) const { return m_workers; }
+
+		// Cancel every running scan, safe to call from any thread (e.g. the Ctrl+C handler).
+		// Returns false if no scan was running.
+		static bool Cancel(void);
+		// Workers of schedulers created on the calling thread without a count, one per core unless
+		// set (e.g. batch workers already run one per core and scan with a single worker each)
+		static size_t DefaultWorkers(void);
+		static inline void SetDefaultWorkers(size_t workers) { s_defaultworkers = workers; }
+	private:
+		struct Item
+		{
+			ScanChunk chunk;
+			size_t slot;
+		};
+
+		void Worker(size_t worker, const Job& job);
+
+		size_t m_workers;
+		size_t m_slots;
+		std::vector<std::vector<uint8_t>> m_buffers; // one per slot, only used when copying
+
+		std::mutex m_lock;
+		std::condition_variable m_queued; // item queued or scan finished
+		std::condition_variable m_freed;  // slot released
+		std::deque<Item> m_queue;
+		std::vector<size_t> m_free;
+		bool m_done = false;
+		bool m_stopped = false;
+
+		static std::atomic<bool> s_cancel;
+		static std::atomic<int> s_running;
+		static thread_local size_t s_defaultworkers; // 0 is one per core
+	};
+}
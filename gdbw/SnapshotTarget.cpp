@@ -0,0 +1,259 @@
+#include "SnapshotTarget.hpp"
+
+template <typename T>
+static bool ReadValue(std::ifstream& in, T* value)
+{
+	return (bool)in.read((char*)value, sizeof(T));
+}
+
+template <typename T>
+static void WriteValue(std::ofstream& out, T value)
+{
+	out.write((const char*)&value, sizeof(T));
+}
+
+std::expected<bool, std::string> gdbw::SnapshotTarget::Load(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in)
+		return std::unexpected(std::format("SnapshotTarget.Load failed to open {}", path));
+
+	// Sizes & counts come from the file, none may claim more than is left of it
+	uint64_t filesize = (uint64_t)in.tellg();
+	in.seekg(0);
+	auto remaining = [&]() -> uint64_t { return filesize - (uint64_t)in.tellg(); };
+
+	char magic[sizeof(Magic)] = { 0 };
+	uint32_t version = 0;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, Magic, sizeof(Magic)) != 0
+		|| !ReadValue(in, &version) || version != Version)
+		return std::unexpected(std::format("SnapshotTarget.Load {} is not a version {} snapshot", path, Version));
+
+	uint32_t set = 0;
+	uint32_t count = 0;
+	if (!ReadValue(in, &m_bitness) || !ReadValue(in, &set) || !ReadValue(in, &count)
+		|| set >= (uint32_t)DE::RegisterSet::COUNT)
+		return std::unexpected("SnapshotTarget.Load truncated header");
+
+	m_context = { (DE::RegisterSet)set, 0, nullptr, { 0 } };
+	m_context.count = DE::GetRegisterSetNames(m_context.set, &m_context.names);
+	if (count != m_context.count)
+		return std::unexpected("SnapshotTarget.Load register count doesn't match register set");
+	if (!in.read((char*)m_context.values, count * sizeof(uint64_t)))
+		return std::unexpected("SnapshotTarget.Load truncated registers");
+
+	uint32_t regions = 0;
+	if (!ReadValue(in, &regions))
+		return std::unexpected("SnapshotTarget.Load truncated region list");
+	if ((uint64_t)regions * RegionHeaderSize > remaining())
+		return std::unexpected("SnapshotTarget.Load truncated region list");
+	m_regions.clear();
+	m_regions.reserve(regions);
+	for (uint32_t i = 0; i < regions; i++)
+	{
+		Region region = {};
+		uint8_t hasdata = 0;
+		if (!ReadValue(in, &region.info.baseaddress) || !ReadValue(in, &region.info.allocationbase)
+			|| !ReadValue(in, &region.info.size) || !ReadValue(in, &region.info.protections)
+			|| !ReadValue(in, &region.info.state) || !ReadValue(in, &region.info.type)
+			|| !ReadValue(in, &hasdata))
+			return std::unexpected("SnapshotTarget.Load truncated region");
+
+		if (hasdata)
+		{
+			if (region.info.size > remaining())
+				return std::unexpected(std::format("SnapshotTarget.Load truncated region data at {:#x}", region.info.baseaddress));
+			region.data.resize(region.info.size);
+			if (!in.read((char*)region.data.data(), region.info.size))
+				return std::unexpected(std::format("SnapshotTarget.Load truncated region data at {:#x}", region.info.baseaddress));
+		}
+		m_regions.push_back(std::move(region));
+	}
+	std::sort(m_regions.begin(), m_regions.end(),
+		[](const Region& a, const Region& b) { return a.info.baseaddress < b.info.baseaddress; });
+
+	uint32_t modules = 0;
+	if (!ReadValue(in, &modules))
+		return std::unexpected("SnapshotTarget.Load truncated module list");
+	if ((uint64_t)modules * ModuleHeaderSize > remaining())
+		return std::unexpected("SnapshotTarget.Load truncated module list");
+	m_modules.clear();
+	m_modules.reserve(modules);
+	for (uint32_t i = 0; i < modules; i++)
+	{
+		TargetModule module = {};
+		uint32_t len = 0;
+		if (!ReadValue(in, &module.base) || !ReadValue(in, &module.size) || !ReadValue(in, &len))
+			return std::unexpected("SnapshotTarget.Load truncated module");
+		if (len > remaining())
+			return std::unexpected("SnapshotTarget.Load truncated module name");
+		module.name.resize(len);
+		if (!in.read(module.name.data(), len))
+			return std::unexpected("SnapshotTarget.Load truncated module name");
+		m_modules.push_back(std::move(module));
+	}
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::SnapshotTarget::Save(Target& source, const std::string& path)
+{
+	uint32_t bitness = source.Is64Bit() ? 64 : 32;
+	auto context = source.GetRegisters(bitness == 64 ? DE::RegisterSet::GP64 : DE::RegisterSet::GP32);
+	if (!context) return std::unexpected(context.error());
+	auto regions = source.GetRegions();
+	if (!regions) return std::unexpected(regions.error());
+	auto modules = source.GetModules();
+	if (!modules) return std::unexpected(modules.error());
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return std::unexpected(std::format("SnapshotTarget.Save failed to open {}", path));
+
+	out.write(Magic, sizeof(Magic));
+	WriteValue(out, Version);
+	WriteValue(out, bitness);
+	WriteValue(out, (uint32_t)context->set);
+	WriteValue(out, (uint32_t)context->count);
+	out.write((const char*)context->values, context->count * sizeof(uint64_t));
+
+	WriteValue(out, (uint32_t)regions->size());
+	std::vector<uint8_t> chunk(SaveChunkSize);
+	bool rewound = false;
+	for (auto& region : *regions)
+	{
+		WriteValue(out, region.baseaddress);
+		WriteValue(out, region.allocationbase);
+		WriteValue(out, region.size);
+		WriteValue(out, region.protections);
+		WriteValue(out, region.state);
+		WriteValue(out, region.type);
+
+		// Streamed a chunk at a time. Only keep regions that read back in full, a partial region would
+		// replay as garbage, so one that stops reading part way is rewound & saved without data.
+		auto hasdata = out.tellp();
+		WriteValue(out, (uint8_t)1);
+		bool readable = region.size != 0;
+		for (uint64_t done = 0; readable && done < region.size;)
+		{
+			uint32_t len = (uint32_t)std::min<uint64_t>(chunk.size(), region.size - done);
+			auto result = source.ReadMemory(region.baseaddress + done, len, chunk.data());
+			readable = result && *result != 0;
+			if (readable)
+			{
+				out.write((const char*)chunk.data(), *result);
+				done += *result;
+			}
+		}
+		if (!readable)
+		{
+			out.seekp(hasdata);
+			WriteValue(out, (uint8_t)0);
+			rewound = true;
+		}
+	}
+
+	WriteValue(out, (uint32_t)modules->size());
+	for (auto& module : *modules)
+	{
+		WriteValue(out, module.base);
+		WriteValue(out, module.size);
+		WriteValue(out, (uint32_t)module.name.size());
+		out.write(module.name.data(), module.name.size());
+	}
+
+	if (!out)
+		return std::unexpected(std::format("SnapshotTarget.Save failed writing {}", path));
+
+	// Data of a rewound region may be left past the end
+	if (rewound)
+	{
+		auto end = (uint64_t)out.tellp();
+		out.close();
+		std::error_code ec;
+		std::filesystem::resize_file(path, end, ec);
+		if (ec)
+			return std::unexpected(std::format("SnapshotTarget.Save failed to truncate {}: {}", path, ec.message()));
+	}
+	return true;
+}
+
+std::expected<uint32_t, std::string> gdbw::SnapshotTarget::ReadMemory(uint64_t address, uint32_t len, void* out)
+{
+	uint8_t* dst = (uint8_t*)out;
+	uint32_t done = 0;
+	while (done < len)
+	{
+		uint64_t current = address + done;
+		ptrdiff_t i = Find(current);
+		if (i < 0 || m_regions[i].data.empty())
+		{
+			if (done == 0)
+				return std::unexpected(std::format("SnapshotTarget.ReadMemory failed to read memory at {:#x}", current));
+			break; // short read, same as a live target would give us
+		}
+
+		const Region& region = m_regions[i];
+		uint64_t offset = current - region.info.baseaddress;
+		uint32_t chunk = (uint32_t)std::min<uint64_t>(region.info.size - offset, len - done);
+		memcpy(dst + done, region.data.data() + offset, chunk);
+		done += chunk;
+	}
+	return done;
+}
+
+std::expected<uint32_t, std::string> gdbw::SnapshotTarget::WriteMemory(uint64_t address, uint32_t len, const void* in)
+{
+	const uint8_t* src = (const uint8_t*)in;
+	uint32_t done = 0;
+	while (done < len)
+	{
+		uint64_t current = address + done;
+		ptrdiff_t i = Find(current);
+		if (i < 0 || m_regions[i].data.empty())
+		{
+			if (done == 0)
+				return std::unexpected(std::format("SnapshotTarget.WriteMemory failed to write memory at {:#x}", current));
+			break;
+		}
+
+		Region& region = m_regions[i];
+		uint64_t offset = current - region.info.baseaddress;
+		uint32_t chunk = (uint32_t)std::min<uint64_t>(region.info.size - offset, len - done);
+		memcpy(region.data.data() + offset, src + done, chunk);
+		done += chunk;
+	}
+	return done;
+}
+
+std::expected<std::vector<gdbw::TargetRegion>, std::string> gdbw::SnapshotTarget::GetRegions(void)
+{
+	std::vector<TargetRegion> regions;
+	regions.reserve(m_regions.size());
+	for (auto& region : m_regions)
+		regions.push_back(region.info);
+	return regions;
+}
+
+std::expected<gdbw::DE::RegisterContext, std::string> gdbw::SnapshotTarget::GetRegisters(DE::RegisterSet set)
+{
+	if (set != m_context.set)
+		return std::unexpected("SnapshotTarget.GetRegisters register set not in snapshot");
+	return m_context;
+}
+
+std::expected<std::vector<gdbw::TargetModule>, std::string> gdbw::SnapshotTarget::GetModules(void)
+{
+	return m_modules;
+}
+
+ptrdiff_t gdbw::SnapshotTarget::Find(uint64_t address) const
+{
+	auto it = std::upper_bound(m_regions.begin(), m_regions.end(), address,
+		[](uint64_t addr, const Region& region) { return addr < region.info.baseaddress; });
+	if (it == m_regions.begin())
+		return -1;
+	--it;
+	if (address - it->info.baseaddress >= it->info.size)
+		return -1;
+	return it - m_regions.begin();
+}
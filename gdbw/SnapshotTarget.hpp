@@ -0,0 +1,59 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include "Target.hpp"
+
+namespace gdbw
+{
+	// Target replaying a process snapshot from disk. Memory writes only change the loaded copy.
+	//
+	// File layout (little endian):
+	//   "GDBWSNAP" u32 version u32 bitness
+	//   u32 set u32 count u64 values[count]
+	//   u32 regions { u64 base u64 allocationbase u64 size u32 prot u32 state u32 type u8 hasdata data[size] }
+	//   u32 modules { u64 base u64 size u32 len name[len] }
+	class SnapshotTarget : public Target
+	{
+	public:
+		static constexpr char Magic[8] = { 'G','D','B','W','S','N','A','P' };
+		static constexpr uint32_t Version = 1;
+
+		SnapshotTarget() = default;
+		~SnapshotTarget() = default;
+
+		// Load a snapshot from disk
+		std::expected<bool, std::string> Load(const std::string& path);
+		// Save the current state of `source` to disk. Regions that can't be read in full are saved without data.
+		static std::expected<bool, std::string> Save(Target& source, const std::string& path);
+
+		std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override;
+		std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override;
+		std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) override;
+		std::expected<DE::RegisterContext, std::string> GetRegisters(DE::RegisterSet set) override;
+		std::expected<std::vector<TargetModule>, std::string> GetModules(void) override;
+		inline bool Is64Bit(void) override { return m_bitness == 64; }
+	private:
+		// Smallest region & module entries, bounds the counts a file can claim
+		static constexpr uint64_t RegionHeaderSize = 3 * sizeof(uint64_t) + 3 * sizeof(uint32_t) + 1;
+		static constexpr uint64_t ModuleHeaderSize = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+		// Region data is read from the source this much at a time when saving
+		static constexpr uint32_t SaveChunkSize = 1 << 20;
+
+		struct Region
+		{
+			TargetRegion info;
+			std::vector<uint8_t> data; // empty if the region wasn't readable
+		};
+
+		// Index of the region containing `address`, or -1
+		ptrdiff_t Find(uint64_t address) const;
+
+		uint32_t m_bitness = 0;
+		DE::RegisterContext m_context = { DE::RegisterSet::COUNT, 0, nullptr, { 0 } };
+		std::vector<Region> m_regions; // sorted by base address
+		std::vector<TargetModule> m_modules;
+	};
+}
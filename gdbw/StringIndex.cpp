@@ -0,0 +1,234 @@
+#include "StringIndex.hpp"
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GDBW_SSE2 1
+#endif
+
+// Bit i of `printable` is set when data[i] is printable ascii (0x20-0x7E or tab), bit i of `zero` when it's 0
+static inline void BlockMasks(const uint8_t* data, uint64_t& printable, uint64_t& zero)
+{
+	printable = 0;
+	zero = 0;
+#ifdef GDBW_SSE2
+	// c + 0x60 maps 0x20-0x7E onto -128..-34, so one signed compare checks both bounds
+	const __m128i bias = _mm_set1_epi8(0x60);
+	const __m128i limit = _mm_set1_epi8(-33);
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i nul = _mm_setzero_si128();
+	for (int i = 0; i < 4; i++)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(data + i * 16));
+		__m128i p = _mm_or_si128(_mm_cmplt_epi8(_mm_add_epi8(v, bias), limit), _mm_cmpeq_epi8(v, tab));
+		printable |= (uint64_t)(uint16_t)_mm_movemask_epi8(p) << (i * 16);
+		zero |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nul)) << (i * 16);
+	}
+#else
+	for (int i = 0; i < 64; i++)
+	{
+		uint8_t c = data[i];
+		printable |= (uint64_t)((c >= 0x20 && c < 0x7F) || c == '\t') << i;
+		zero |= (uint64_t)(c == 0) << i;
+	}
+#endif
+}
+
+void gdbw::StringIndex::Extract(const uint8_t* data, size_t size, size_t body, uint64_t address, bool continued,
+	uint32_t minlength, uint8_t encodings, std::vector<Entry>& entries, std::string& text)
+{
+	minlength = std::max<uint32_t>(minlength, 1);
+
+	// Strings are runs of set bits in per 64 byte block masks, a run can carry over into the next block
+	auto scan = [&](StringEncoding encoding) {
+		size_t width = encoding == STRING_UTF16 ? 2 : 1;
+		size_t start = 0;
+		bool inrun = false;
+		bool owned = false;
+		auto finish = [&](size_t end) {
+			size_t length = (end - start) / width;
+			if (!owned || length < minlength)
+				return;
+			length = std::min<size_t>(length, MaxLength);
+			entries.push_back({ address + start, text.size(), (uint32_t)length, encoding });
+			for (size_t i = 0; i < length; i++)
+				text.push_back((char)data[start + i * width]);
+			text.push_back('\0');
+		};
+
+		for (size_t block = 0; block < size; block += 64)
+		{
+			uint64_t printable, zero;
+			if (block + 64 <= size)
+				BlockMasks(data + block, printable, zero);
+			else
+			{
+				uint8_t tail[64] = { 0 };
+				memcpy(tail, data + block, size - block);
+				BlockMasks(tail, printable, zero);
+				uint64_t valid = (1ull << (size - block)) - 1;
+				printable &= valid;
+				zero &= valid;
+			}
+
+			uint64_t mask = printable;
+			if (encoding == STRING_UTF16)
+			{
+				// Printable byte at an even offset followed by a 0, both bytes of the character set
+				mask = printable & (zero >> 1) & 0x5555555555555555ull;
+				mask |= mask << 1;
+			}
+
+			size_t bit = 0;
+			while (bit < 64)
+			{
+				if (inrun)
+				{
+					uint64_t rest = ~mask >> bit;
+					if (rest == 0)
+						break;
+					bit += std::countr_zero(rest);
+					finish(block + bit);
+					inrun = false;
+				}
+				else
+				{
+					uint64_t rest = mask >> bit;
+					if (rest == 0)
+						break;
+					bit += std::countr_zero(rest);
+					start = block + bit;
+					if (start > body)
+						return; // belongs to the next chunk
+					inrun = true;
+					owned = !continued || start != 0;
+				}
+			}
+		}
+		// Ran into the end of the data, only happens at the end of a range or past MaxLength
+		if (inrun)
+			finish(size);
+	};
+
+	if (encodings & STRING_ASCII)
+		scan(STRING_ASCII);
+	if (encodings & STRING_UTF16)
+		scan(STRING_UTF16);
+}
+
+void gdbw::StringIndex::Build(Target& target, const RegionMap& regions, const std::vector<SearchRange>& ranges,
+	uint64_t generation, uint32_t minlength, uint8_t encodings, ScanScheduler::Stats* stats)
+{
+	struct Found
+	{
+		std::vector<Entry> entries;
+		std::string text;
+	};
+
+	// A chunk owns the strings starting in it and sees MaxLength characters past its end, enough to
+	// finish them. The next chunk skips the string it starts in the middle of.
+	ScanScheduler scheduler;
+	std::vector<Found> results(scheduler.Workers());
+	auto result = scheduler.Run(target, ranges, MaxLength * 2, [&](const ScanChunk& chunk, size_t worker) {
+		size_t body = chunk.last ? chunk.size : std::min<size_t>(ScanScheduler::ChunkSize, chunk.size);
+		bool continued = chunk.address != ranges[chunk.range].address;
+		Extract(chunk.data, chunk.size, body, chunk.address, continued, minlength, encodings, results[worker].entries, results[worker].text);
+		return true;
+	});
+	if (stats)
+		*stats = result;
+
+	// Workers saw chunks in no particular order, sort the entries then lay the text out in the same order
+	std::string text;
+	size_t count = 0;
+	for (auto& found : results)
+		count += found.entries.size();
+	m_entries.clear();
+	m_entries.reserve(count);
+	for (auto& found : results)
+	{
+		for (auto& entry : found.entries)
+			m_entries.push_back({ entry.address, entry.text + text.size(), entry.length, entry.encoding });
+		text += found.text;
+		found = Found();
+	}
+	std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+		return a.address < b.address || (a.address == b.address && a.encoding < b.encoding);
+	});
+
+	m_text.clear();
+	m_text.reserve(text.size());
+	for (auto& entry : m_entries)
+	{
+		uint64_t offset = m_text.size();
+		m_text.append(text, entry.text, entry.length + 1);
+		entry.text = offset;
+	}
+
+	const auto& all = regions.Regions();
+	m_regionbounds.resize(all.size() + 1);
+	for (size_t i = 0; i < all.size(); i++)
+	{
+		m_regionbounds[i] = std::lower_bound(m_entries.begin(), m_entries.end(), all[i].BaseAddress(),
+			[](const Entry& entry, uint64_t address) { return entry.address < address; }) - m_entries.begin();
+	}
+	m_regionbounds[all.size()] = m_entries.size();
+
+	m_generation = generation;
+	m_minlength = minlength;
+	m_encodings = encodings;
+}
+
+std::vector<const gdbw::StringIndex::Entry*> gdbw::StringIndex::Query(uint64_t start, uint64_t end, std::string_view contains,
+	uint32_t minlength, uint8_t encodings, size_t limit, const std::function<bool(const Entry&)>& accept) const
+{
+	std::vector<const Entry*> matches;
+	auto first = std::lower_bound(m_entries.begin(), m_entries.end(), start, [](const Entry& entry, uint64_t address) { return entry.address < address; });
+	auto last = std::lower_bound(first, m_entries.end(), end, [](const Entry& entry, uint64_t address) { return entry.address < address; });
+	auto add = [&](const Entry& entry) {
+		if (entry.length < minlength || !(entry.encoding & encodings) || (accept && !accept(entry)))
+			return true;
+		matches.push_back(&entry);
+		return limit == 0 || matches.size() < limit;
+	};
+
+	if (contains.empty())
+	{
+		for (auto it = first; it != last; it++)
+			if (!add(*it))
+				break;
+		return matches;
+	}
+
+	// Text is laid out in entry order, search the blob of the range and map hits back to their entry.
+	// Strings are NUL separated so a hit never spans two of them.
+	if (first == last)
+		return matches;
+	std::string_view text(m_text.data() + first->text, (last - 1)->text + (last - 1)->length - first->text);
+	size_t pos = text.find(contains);
+	while (pos != std::string_view::npos)
+	{
+		uint64_t offset = first->text + pos;
+		auto it = std::upper_bound(first, last, offset, [](uint64_t offset, const Entry& entry) { return offset < entry.text; }) - 1;
+		if (!add(*it))
+			break;
+		// Next string
+		pos = text.find(contains, it->text + it->length + 1 - first->text);
+	}
+	return matches;
+}
+
+bool gdbw::StringIndex::Verify(const Entry& entry, const ReadFunction& read) const
+{
+	size_t width = entry.encoding == STRING_UTF16 ? 2 : 1;
+	uint8_t data[MaxLength * 2];
+	auto result = read(entry.address, (uint32_t)(entry.length * width), data);
+	if (!result || *result != entry.length * width)
+		return false;
+
+	std::string_view text = Text(entry);
+	for (size_t i = 0; i < entry.length; i++)
+	{
+		if (data[i * width] != (uint8_t)text[i] || (width == 2 && data[i * 2 + 1] != 0))
+			return false;
+	}
+	return true;
+}
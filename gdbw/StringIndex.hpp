@@ -0,0 +1,79 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RegionMap.hpp"
+#include "ScanScheduler.hpp"
+#include "Target.hpp"
+
+namespace gdbw
+{
+	enum StringEncoding : uint8_t
+	{
+		STRING_ASCII = 1,
+		STRING_UTF16 = 2 // UTF-16LE limited to printable ascii, 2 byte aligned
+	};
+
+	// Printable strings extracted from target memory, sorted by address. Text is kept in a single
+	// blob (NUL separated, UTF-16 narrowed) so substring queries are one pass over contiguous memory.
+	class StringIndex
+	{
+	public:
+		// Longer strings are cut off at this many characters
+		static constexpr uint32_t MaxLength = 1024;
+
+		struct Entry
+		{
+			uint64_t address;
+			uint64_t text;     // offset into the text blob
+			uint32_t length;   // characters
+			StringEncoding encoding;
+		};
+		using ReadFunction = std::function<std::expected<uint32_t, std::string>(uint64_t address, uint32_t len, void* out)>;
+
+		// Extract every string of at least `minlength` characters in `encodings` (StringEncoding flags)
+		// from `ranges`, replacing the current index. `generation` is recorded for Covers().
+		void Build(Target& target, const RegionMap& regions, const std::vector<SearchRange>& ranges,
+			uint64_t generation, uint32_t minlength, uint8_t encodings, ScanScheduler::Stats* stats = nullptr);
+		// True if the index was built for `generation` and holds every string a query for
+		// `minlength` & `encodings` can return
+		inline bool Covers(uint64_t generation, uint32_t minlength, uint8_t encodings) const
+		{
+			return m_generation == generation && m_minlength <= minlength && (m_encodings & encodings) == encodings;
+		}
+
+		// Entries in [start, end) matching the filters & `accept` (if given), in address order. Stops at `limit`
+		// entries (0 for no limit).
+		std::vector<const Entry*> Query(uint64_t start, uint64_t end, std::string_view contains,
+			uint32_t minlength, uint8_t encodings, size_t limit, const std::function<bool(const Entry&)>& accept = nullptr) const;
+		// True if memory still holds `entry`'s text. The index outlives steps (it's keyed on the region
+		// generation), so strings changed while the target ran are checked when they're returned.
+		bool Verify(const Entry& entry, const ReadFunction& read) const;
+		// Entries of region `index` of the map the index was built from
+		inline std::pair<const Entry*, const Entry*> Region(size_t index) const
+		{
+			if (index + 1 >= m_regionbounds.size())
+				return { nullptr, nullptr };
+			return { m_entries.data() + m_regionbounds[index], m_entries.data() + m_regionbounds[index + 1] };
+		}
+		inline std::string_view Text(const Entry& entry) const { return std::string_view(m_text.data() + entry.text, entry.length); }
+		inline size_t Size(void) const { return m_entries.size(); }
+
+		// Append the strings found in `data` to `entries` & `text`. Only strings starting in [0, body] are
+		// reported, except one running in from offset 0 when `continued` (the previous chunk owns it).
+		static void Extract(const uint8_t* data, size_t size, size_t body, uint64_t address, bool continued,
+			uint32_t minlength, uint8_t encodings, std::vector<Entry>& entries, std::string& text);
+	private:
+		std::vector<Entry> m_entries;
+		std::string m_text;
+		std::vector<size_t> m_regionbounds; // first entry of every region, plus the entry count
+		uint64_t m_generation = 0;
+		uint32_t m_minlength = 0;
+		uint8_t m_encodings = 0;
+	};
+}
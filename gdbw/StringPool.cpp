@@ -0,0 +1,76 @@
+#include "StringPool.hpp"
+#include <algorithm>
+
+uint32_t gdbw::StringPool::Intern(std::string_view str)
+{
+	if (m_slots.empty())
+		m_slots.assign(MinSlots, EmptySlot);
+
+	uint32_t hash = (uint32_t)std::hash<std::string_view>{}(str);
+	size_t mask = m_slots.size() - 1;
+	size_t slot = hash & mask;
+	for (; m_slots[slot] != EmptySlot; slot = (slot + 1) & mask)
+	{
+		uint32_t id = m_slots[slot];
+		if (m_hashes[id] == hash && m_strings[id] == str)
+			return id;
+	}
+
+	size_t needed = str.size() + 1; // NUL terminator
+	char* dst = nullptr;
+	if (needed > BlockSize)
+	{
+		// Oversized strings get a block of their own, the remaining space in the current block is still used
+		m_large.push_back(std::make_unique<char[]>(needed));
+		dst = m_large.back().get();
+	}
+	else
+	{
+		if (m_blockused + needed > BlockSize)
+		{
+			m_blocks.push_back(std::make_unique<char[]>(BlockSize));
+			m_blockused = 0;
+		}
+		dst = m_blocks.back().get() + m_blockused;
+		m_blockused += needed;
+	}
+
+	memcpy(dst, str.data(), str.size());
+	dst[str.size()] = '\0';
+
+	uint32_t id = (uint32_t)m_strings.size();
+	m_strings.emplace_back(dst, str.size());
+	m_hashes.push_back(hash);
+	m_slots[slot] = id;
+	if (m_strings.size() * 2 > m_slots.size())
+		Grow();
+	return id;
+}
+
+void gdbw::StringPool::Grow(void)
+{
+	m_slots.assign(m_slots.size() * 2, EmptySlot);
+	size_t mask = m_slots.size() - 1;
+	for (uint32_t id = 0; id < m_strings.size(); id++)
+	{
+		size_t slot = m_hashes[id] & mask;
+		while (m_slots[slot] != EmptySlot)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = id;
+	}
+}
+
+void gdbw::StringPool::Clear(void)
+{
+	std::fill(m_slots.begin(), m_slots.end(), EmptySlot);
+	m_strings.clear();
+	m_hashes.clear();
+	m_large.clear();
+	if (m_blocks.size() > 1)
+	{
+		auto last = std::move(m_blocks.back());
+		m_blocks.clear();
+		m_blocks.push_back(std::move(last));
+	}
+	m_blockused = m_blocks.empty() ? BlockSize : 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gdbw
+{
+	// Interned, NUL-terminated strings stored back to back in large blocks.
+	// Strings are never moved once interned, so returned pointers stay valid until Clear().
+	// Lookups go through an open addressing (linear probing) table of ids, kept at most half full.
+	class StringPool
+	{
+	public:
+		static constexpr size_t BlockSize = 0x10000;
+		static constexpr size_t MinSlots = 64;
+
+		StringPool() = default;
+		~StringPool() = default;
+		StringPool(StringPool&&) = default;
+		StringPool& operator=(StringPool&&) = default;
+
+		// Intern a string, returns an id that can be passed to Get/View
+		uint32_t Intern(std::string_view str);
+		// Drop every interned string (keeps the last block & the table around for reuse)
+		void Clear(void);
+
+		inline const char* Get(uint32_t id) const { return m_strings[id].data(); }
+		inline std::string_view View(uint32_t id) const { return m_strings[id]; }
+		inline size_t Count(void) const { return m_strings.size(); }
+	private:
+		static constexpr uint32_t EmptySlot = ~0u;
+
+		// Double the table & reinsert every id
+		void Grow(void);
+
+		std::vector<std::unique_ptr<char[]>> m_blocks; // BlockSize each
+		std::vector<std::unique_ptr<char[]>> m_large;  // strings longer than a block, one each
+		size_t m_blockused = BlockSize; // forces a block allocation on first intern
+		std::vector<std::string_view> m_strings;
+		std::vector<uint32_t> m_hashes; // per id, so probing & growing don't rehash strings
+		std::vector<uint32_t> m_slots;  // ids, EmptySlot if free, size is a power of two
+	};
+}
@@ -0,0 +1,94 @@
+#include "SymbolCache.hpp"
+#include <algorithm>
+
+ptrdiff_t gdbw::SymbolCache::Find(uint64_t address) const
+{
+	auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+		[](uint64_t value, const Range& range) { return value < range.start; });
+	if (it == m_ranges.begin())
+		return -1;
+	--it;
+	if (address >= it->end)
+		return -1;
+	return it - m_ranges.begin();
+}
+
+std::optional<gdbw::Symbol> gdbw::SymbolCache::Lookup(uint64_t address, bool* known_miss) const
+{
+	if (known_miss)
+		*known_miss = false;
+
+	auto idx = Find(address);
+	if (idx < 0)
+	{
+		if (known_miss && m_misses.contains(address))
+			*known_miss = true;
+		return std::nullopt;
+	}
+
+	const Range& range = m_ranges[idx];
+	return Symbol(range.symaddress, address - range.symaddress, range.flags, range.modbase, m_names.Get(range.name), range.size);
+}
+
+gdbw::Symbol gdbw::SymbolCache::Insert(uint64_t address, uint64_t symaddress, uint32_t size, uint32_t flags, uint64_t modbase, const char* name)
+{
+	if (m_deferflush == 0 && m_names.Count() >= MaxNames)
+		Flush();
+
+	Range range = { 0 };
+	range.symaddress = symaddress;
+	range.size = size;
+	range.flags = flags;
+	range.modbase = modbase;
+	range.name = m_names.Intern(name);
+
+	// Sized symbols cover their whole extent. Unsized ones (e.g. exports without a pdb) can only
+	// vouch for the address that was actually resolved.
+	if (size != 0 && address >= symaddress && address < symaddress + size)
+	{
+		range.start = symaddress;
+		range.end = symaddress + size;
+	}
+	else
+	{
+		range.start = address;
+		range.end = address + 1;
+	}
+
+	Symbol symbol(symaddress, address - symaddress, flags, modbase, m_names.Get(range.name), size);
+	if (Find(address) >= 0)
+		return symbol;
+
+	// Keep ranges non-overlapping, neighbours can't contain `address` so clamping to them
+	// always leaves it inside the new range
+	auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+		[](uint64_t value, const Range& r) { return value < r.start; });
+	if (it != m_ranges.begin())
+		range.start = std::max(range.start, (it - 1)->end);
+	if (it != m_ranges.end())
+		range.end = std::min(range.end, it->start);
+
+	m_ranges.insert(it, range);
+	m_misses.erase(address);
+	return symbol;
+}
+
+void gdbw::SymbolCache::InsertMiss(uint64_t address)
+{
+	if (m_misses.size() >= MaxMisses)
+		m_misses.clear();
+	m_misses.insert(address);
+}
+
+void gdbw::SymbolCache::Invalidate(uint64_t base, uint64_t size)
+{
+	std::erase_if(m_ranges, [&](const Range& range) { return range.start < base + size && range.end > base; });
+	std::erase_if(m_misses, [&](uint64_t address) { return address >= base && address < base + size; });
+}
+
+void gdbw::SymbolCache::Flush(void)
+{
+	m_ranges.clear();
+	m_misses.clear();
+	m_names.Clear();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+#include "StringPool.hpp"
+
+namespace gdbw
+{
+	// A resolved symbol. Name points into the owning SymbolCache's string pool and is only
+	// valid until the cache is next invalidated, copy it if it needs to outlive the lookup.
+	class Symbol
+	{
+	public:
+		Symbol() = default;
+		Symbol(uint64_t address, uint64_t displacement, uint32_t flags, uint64_t modbase, const char* name, uint32_t size)
+			: m_address(address), m_displacement(displacement), m_flags(flags), m_modbase(modbase), m_name(name), m_size(size) {}
+
+		inline uint64_t Address(void) const { return m_address; }
+		inline uint64_t Displacement(void) const { return m_displacement; }
+		inline uint32_t Flags(void) const { return m_flags; }
+		inline uint64_t ModBase(void) const { return m_modbase; }
+		inline const char* Name(void) const { return m_name; }
+		inline uint32_t Size(void) const { return m_size; }
+	private:
+		uint64_t m_address = 0;
+		uint64_t m_displacement = 0;
+		uint32_t m_flags = 0;
+		uint64_t m_modbase = 0;
+		const char* m_name = "";
+		uint32_t m_size = 0;
+	};
+
+	// Sorted interval cache of resolved symbol ranges. Once a sized symbol (e.g. a function)
+	// has been resolved, every address inside it is answered without going back to the resolver.
+	class SymbolCache
+	{
+	public:
+		// Known misses are forgotten once there are this many (e.g. a scan over unsymbolized memory)
+		static constexpr size_t MaxMisses = 0x10000;
+		// Names are never dropped from the pool on their own, the whole cache is flushed past this many
+		static constexpr size_t MaxNames = 0x40000;
+
+		// Holds off the MaxNames flush while alive, so every name returned during a batch of lookups
+		// stays valid until the batch's results have been used. The flush happens on the next Insert after.
+		class DeferFlush
+		{
+		public:
+			DeferFlush(SymbolCache& cache) : m_cache(cache) { m_cache.m_deferflush++; }
+			~DeferFlush() { m_cache.m_deferflush--; }
+			DeferFlush(const DeferFlush&) = delete;
+			DeferFlush& operator=(const DeferFlush&) = delete;
+		private:
+			SymbolCache& m_cache;
+		};
+
+		SymbolCache() = default;
+		~SymbolCache() = default;
+
+		// Look up an address. Returns std::nullopt if the address hasn't been resolved before,
+		// sets `known_miss` if it has been resolved before and has no symbol.
+		std::optional<Symbol> Lookup(uint64_t address, bool* known_miss = nullptr) const;
+		// Insert a symbol resolved for `address`, returns the cached copy. May flush the cache first
+		// (see MaxNames), invalidating previously returned names, unless a DeferFlush is alive.
+		Symbol Insert(uint64_t address, uint64_t symaddress, uint32_t size, uint32_t flags, uint64_t modbase, const char* name);
+		// Remember that `address` has no symbol
+		void InsertMiss(uint64_t address);
+		// Drop everything resolved within [base, base+size)
+		void Invalidate(uint64_t base, uint64_t size);
+		// Drop everything
+		void Flush(void);
+
+		inline size_t Size(void) const { return m_ranges.size(); }
+		inline size_t Misses(void) const { return m_misses.size(); }
+	private:
+		struct Range
+		{
+			uint64_t start;
+			uint64_t end;        // exclusive
+			uint64_t symaddress; // differs from start for unsized symbols (exports etc.)
+			uint64_t modbase;
+			uint32_t size;
+			uint32_t flags;
+			uint32_t name; // StringPool id
+		};
+
+		// Index of the range containing `address`, or -1
+		ptrdiff_t Find(uint64_t address) const;
+
+		std::vector<Range> m_ranges; // sorted by start, non-overlapping
+		std::unordered_set<uint64_t> m_misses;
+		StringPool m_names;
+		uint32_t m_deferflush = 0; // live DeferFlush guards
+	};
+}
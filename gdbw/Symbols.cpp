@@ -24,8 +24,15 @@ std::expected<bool, std::string> gdbw::SymbolManager::Init(HANDLE debuggee)
 	return true;
 }
 
-std::expected<gdbw::Symbol*, std::string> gdbw::SymbolManager::SymbolFromAddress(DWORD64 address)
+std::expected<gdbw::Symbol, std::string> gdbw::SymbolManager::SymbolFromAddress(DWORD64 address)
 {
+	bool known_miss = false;
+	auto cached = m_cache.Lookup(address, &known_miss);
+	if (cached)
+		return *cached;
+	if (known_miss)
+		return std::unexpected(std::format("No symbol found for address {:#x}", address));
+
 	DWORD64 displacement = 0;
 
 	char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME] = { 0 };
@@ -34,17 +41,48 @@ std::expected<gdbw::Symbol*, std::string> gdbw::SymbolManager::SymbolFromAddress
 	syminfo->MaxNameLen = MAX_SYM_NAME;
 
 	if (!SymFromAddr(m_hdebuggee, address, &displacement, syminfo))
-		return std::unexpected(std::format("SymFromAddr failed with code ({:#x})", GetLastError()));
+	{
+		DWORD error = GetLastError();
+		m_cache.InsertMiss(address);
+		return std::unexpected(std::format("SymFromAddr failed with code ({:#x})", error));
+	}
 
 	// often occurs, not sure why. So try and get it again via SymGetModuleBase
 	if (syminfo->ModBase == 0)
 		syminfo->ModBase = SymGetModuleBase64(m_hdebuggee, address);
 
-	Symbol* symbol = new Symbol(syminfo, displacement);
-	return symbol;
+	return m_cache.Insert(address, syminfo->Address, syminfo->Size, syminfo->Flags, syminfo->ModBase, syminfo->Name);
+}
+
+std::vector<std::optional<gdbw::Symbol>> gdbw::SymbolManager::SymbolsFromAddresses(const std::vector<DWORD64>& addresses)
+{
+	std::vector<std::optional<Symbol>> symbols(addresses.size());
+	std::optional<Symbol> last;
+	// Names in `symbols` & `last` point into the cache, none may be flushed before the caller is done
+	SymbolCache::DeferFlush defer(m_cache);
+
+	for (size_t i = 0; i < addresses.size(); i++)
+	{
+		DWORD64 address = addresses[i];
+
+		// Addresses are sorted, so runs inside the same function skip the lookup entirely
+		if (last && last->Size() != 0 && address >= last->Address() && address < last->Address() + last->Size())
+		{
+			symbols[i] = Symbol(last->Address(), address - last->Address(), last->Flags(), last->ModBase(), last->Name(), last->Size());
+			continue;
+		}
+
+		auto result = SymbolFromAddress(address);
+		if (result)
+		{
+			symbols[i] = *result;
+			last = *result;
+		}
+	}
+	return symbols;
 }
 
-std::expected<gdbw::Symbol*, std::string> gdbw::SymbolManager::SymbolFromName(PCSTR name)
+std::expected<gdbw::Symbol, std::string> gdbw::SymbolManager::SymbolFromName(PCSTR name)
 {
 	ULONG64 buffer[(sizeof(SYMBOL_INFO) + MAX_SYM_NAME + sizeof(ULONG64) - 1) / sizeof(ULONG64)];
 	PSYMBOL_INFO syminfo = (PSYMBOL_INFO)buffer;
@@ -64,20 +102,29 @@ std::expected<gdbw::Symbol*, std::string> gdbw::SymbolManager::SymbolFromName(PC
 
 std::expected<bool, std::string> gdbw::SymbolManager::RefreshModuleList(void)
 {
+	m_cache.Flush();
 	if (!SymRefreshModuleList(m_hdebuggee))
 		return std::unexpected(std::format("SymRefreshModuleList failed with code ({:#x})", GetLastError()));
 	return true;
 }
 
-gdbw::Symbol::Symbol(PSYMBOL_INFO syminfo, DWORD64 displacement)
+std::expected<std::vector<std::pair<DWORD64, ULONG>>, std::string> gdbw::SymbolManager::FunctionsInModule(DWORD64 base)
 {
-	m_displacement = displacement;
-	m_syminfo = (PSYMBOL_INFO)calloc(sizeof(SYMBOL_INFO) + MAX_SYM_NAME, 1);
-	memcpy(m_syminfo, syminfo, sizeof(SYMBOL_INFO) + MAX_SYM_NAME);
+	std::vector<std::pair<DWORD64, ULONG>> functions;
+	auto callback = [](PSYMBOL_INFO syminfo, ULONG size, PVOID context) -> BOOL {
+		if (syminfo->Tag == SymTagFunction)
+			((std::vector<std::pair<DWORD64, ULONG>>*)context)->emplace_back(syminfo->Address, syminfo->Size);
+		return TRUE;
+	};
+	if (!SymEnumSymbols(m_hdebuggee, base, "*", callback, &functions))
+		return std::unexpected(std::format("SymEnumSymbols failed with code ({:#x})", GetLastError()));
+	return functions;
 }
 
-gdbw::Symbol::~Symbol()
+void gdbw::SymbolManager::InvalidateCache(DWORD64 base, DWORD64 size)
 {
-	if (m_syminfo)
-		free(m_syminfo);
+	if (size == 0)
+		m_cache.Flush();
+	else
+		m_cache.Invalidate(base, size);
 }
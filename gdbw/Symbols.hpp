@@ -1,28 +1,15 @@
 #pragma once
 #include <expected>
 #include <print>
+#include <vector>
 #include <windows.h>
+// DbgHelp.h only declares SymTagEnum (SymTagFunction etc.) when cvconst.h isn't used
+#define _NO_CVCONST_H
 #include <DbgHelp.h>
+#include "SymbolCache.hpp"
 
 namespace gdbw
 {
-	class Symbol
-	{
-	public:
-		Symbol(PSYMBOL_INFO syminfo, DWORD64 displacement);
-		~Symbol();
-
-		inline DWORD64 Address(void) { return m_syminfo->Address; }
-		inline DWORD64 Displacement(void) { return m_displacement; }
-		inline ULONG Flags(void) { return m_syminfo->Flags; }
-		inline ULONG64 ModBase(void) { return m_syminfo->ModBase; }
-		inline CHAR* Name(void) { return m_syminfo->Name; }
-		inline ULONG Size(void) { return m_syminfo->Size; }
-	private:
-		PSYMBOL_INFO m_syminfo = nullptr;
-		DWORD64 m_displacement = 0;
-	};
-
 	class SymbolManager
 	{
 	public:
@@ -30,11 +17,20 @@ namespace gdbw
 		~SymbolManager();
 
 		std::expected<bool, std::string> Init(HANDLE debuggee);
-		std::expected<Symbol*, std::string> SymbolFromAddress(DWORD64 address);
-		std::expected<Symbol*, std::string> SymbolFromName(PCSTR name);
+		// Resolve an address, answered from the symbol cache when possible
+		std::expected<Symbol, std::string> SymbolFromAddress(DWORD64 address);
+		// Resolve many addresses in one pass, `addresses` must be sorted & unique.
+		// Result is parallel to `addresses`, misses are std::nullopt.
+		std::vector<std::optional<Symbol>> SymbolsFromAddresses(const std::vector<DWORD64>& addresses);
+		std::expected<Symbol, std::string> SymbolFromName(PCSTR name);
 		std::expected<bool, std::string> RefreshModuleList(void);
+		// Get the address & size of every function symbol in the module at `base`
+		std::expected<std::vector<std::pair<DWORD64, ULONG>>, std::string> FunctionsInModule(DWORD64 base);
+		// Forget cached symbols within [base, base+size), size 0 forgets everything
+		void InvalidateCache(DWORD64 base, DWORD64 size);
 	private:
 		HANDLE m_hdebuggee;
+		SymbolCache m_cache;
 	};
 }
 
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Registers.hpp"
+#include "SymbolCache.hpp"
+
+namespace gdbw
+{
+	// A committed memory region as reported by a target. Protections, state & type use the
+	// Windows PAGE_* / MEM_* values regardless of the backend.
+	struct TargetRegion
+	{
+		uint64_t baseaddress;
+		uint64_t allocationbase;
+		uint64_t size;
+		uint32_t protections;
+		uint32_t state;
+		uint32_t type;
+	};
+
+	// A loaded module (image) in the target
+	struct TargetModule
+	{
+		uint64_t base;
+		uint64_t size;
+		std::string name;
+	};
+
+	// Everything the engine's caches & bindings need from a debuggee. The live DbgEng engine is
+	// one implementation, SnapshotTarget replays a process saved to disk.
+	// Only uses standard types so backends (and anything built on them) don't need Windows.
+	class Target
+	{
+	public:
+		virtual ~Target() = default;
+
+		// Read up to `len` bytes at `address`, returns the number of bytes read
+		virtual std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) = 0;
+		// Write up to `len` bytes at `address`, returns the number of bytes written
+		virtual std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) = 0;
+		// Get all committed regions, sorted by address
+		virtual std::expected<std::vector<TargetRegion>, std::string> GetRegions(void) = 0;
+		// Get all registers in a set
+		virtual std::expected<DE::RegisterContext, std::string> GetRegisters(DE::RegisterSet set) = 0;
+		// Get all loaded modules
+		virtual std::expected<std::vector<TargetModule>, std::string> GetModules(void) = 0;
+		// Returns true if the target is 64bit
+		virtual bool Is64Bit(void) = 0;
+		// Pointer to [address, address+len) if the target can serve it without copying (e.g. a
+		// memory mapped dump), nullptr otherwise. Stays valid for the lifetime of the target.
+		virtual const uint8_t* View(uint64_t address, uint32_t len) { return nullptr; }
+		// Ids of the threads whose registers GetRegisters can report, the current one first.
+		// Empty if the target only knows the current thread.
+		virtual std::vector<uint32_t> GetThreads(void) { return {}; }
+		// Make GetRegisters report thread `id`
+		virtual std::expected<bool, std::string> SetThread(uint32_t id) { return std::unexpected("SetThread not supported by target"); }
+		// Resolve an address from the target's own symbols (e.g. ELF symbol tables)
+		virtual std::expected<Symbol, std::string> SymbolFromAddress(uint64_t address) { return std::unexpected("Symbols not available for the current target"); }
+		// Resolve a symbol name across all modules
+		virtual std::expected<Symbol, std::string> SymbolFromName(const std::string& name) { return std::unexpected("Symbols not available for the current target"); }
+
+		//
+		// Run control, optional. Only needed by targets that drive their own session loop
+		// (the DbgEng engine resumes through its own event loop instead).
+		//
+
+		// Continue until the next stop. Returns the stop signal, or -1 if the target exited.
+		virtual std::expected<int, std::string> Continue(void) { return std::unexpected("Continue not supported by target"); }
+		// Execute a single instruction. Returns the stop signal, or -1 if the target exited.
+		virtual std::expected<int, std::string> StepInto(void) { return std::unexpected("StepInto not supported by target"); }
+		// Continue until `address` is reached (or the target stops for another reason) using a temporary
+		// breakpoint, a breakpoint already set there is left alone. Returns the stop signal, or -1 if the target exited.
+		virtual std::expected<int, std::string> RunTo(uint64_t address) { return std::unexpected("RunTo not supported by target"); }
+		// Add a software breakpoint, returns its id (the existing one's if there's already a breakpoint at `address`)
+		virtual std::expected<uint32_t, std::string> SetBreakpoint(uint64_t address) { return std::unexpected("Breakpoints not supported by target"); }
+		// Id of the breakpoint at `address`, std::nullopt if there's none
+		virtual std::optional<uint32_t> FindBreakpoint(uint64_t address) { return std::nullopt; }
+		virtual std::expected<bool, std::string> ClearBreakpoint(uint32_t id) { return std::unexpected("Breakpoints not supported by target"); }
+		// Break into a running target, the pending Continue returns once it stops
+		virtual void Interrupt(void) {}
+	};
+}
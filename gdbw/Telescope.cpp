@@ -0,0 +1,67 @@
+#include "Telescope.hpp"
+
+std::expected<std::vector<gdbw::TelescopeEntry>, std::string> gdbw::Telescope::Walk(const PageCache::ReadFunction& read,
+	const RegionMap& regions, bool is64bit, uint64_t address, size_t count, size_t depth)
+{
+	if (count == 0 || count > MaxCount)
+		return std::unexpected(std::format("Telescope count must be 1 to {}", MaxCount));
+
+	size_t ptrsize = is64bit ? 8 : 4;
+	std::vector<uint8_t> window(count * ptrsize);
+	auto result = read(address, (uint32_t)window.size(), window.data());
+	if (!result)
+		return std::unexpected(result.error());
+	count = *result / ptrsize; // short read, stop at the first unreadable slot
+
+	std::vector<TelescopeEntry> entries(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		TelescopeEntry& entry = entries[i];
+		entry.address = address + i * ptrsize;
+
+		uint64_t value = 0;
+		memcpy(&value, window.data() + i * ptrsize, ptrsize);
+		while (entry.hops.size() < depth)
+		{
+			ptrdiff_t region = regions.Find(value);
+			entry.hops.push_back({ value, region, region >= 0 ? StringAt(read, value) : std::string() });
+			if (region < 0 || !entry.hops.back().string.empty())
+				break;
+
+			// Stop at self references & cycles (e.g. a list head pointing at itself)
+			uint64_t next = 0;
+			auto nextresult = read(value, (uint32_t)ptrsize, &next);
+			if (!nextresult || *nextresult != ptrsize || next == entry.address)
+				break;
+			bool cycle = false;
+			for (auto& hop : entry.hops)
+				cycle = cycle || hop.value == next;
+			if (cycle)
+				break;
+			value = next;
+		}
+	}
+	return entries;
+}
+
+std::string gdbw::Telescope::StringAt(const PageCache::ReadFunction& read, uint64_t address)
+{
+	uint8_t data[MaxString * 2] = { 0 };
+	auto result = read(address, sizeof(data), data);
+	if (!result)
+		return "";
+	size_t len = *result;
+
+	auto printable = [](uint8_t c) { return (c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n' || c == '\r'; };
+	std::string str;
+	for (size_t i = 0; i < len && str.size() < MaxString && printable(data[i]); i++)
+		str.push_back((char)data[i]);
+	if (str.size() >= MinString)
+		return str;
+
+	// UTF-16LE, ascii only
+	str.clear();
+	for (size_t i = 0; i + 1 < len && str.size() < MaxString && data[i + 1] == 0 && printable(data[i]); i += 2)
+		str.push_back((char)data[i]);
+	return str.size() >= MinString ? str : "";
+}
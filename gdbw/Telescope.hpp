@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PageCache.hpp"
+#include "RegionMap.hpp"
+
+namespace gdbw
+{
+	// One value in a pointer chain
+	struct TelescopeHop
+	{
+		uint64_t value;
+		ptrdiff_t region;   // region map index of the memory `value` points to, -1 if it isn't a pointer
+		std::string string; // printable ASCII/UTF-16 string at `value`, empty if there isn't one
+	};
+
+	// A pointer sized slot and the chain of pointers it leads to
+	struct TelescopeEntry
+	{
+		uint64_t address;
+		std::vector<TelescopeHop> hops;
+	};
+
+	// Recursive pointer dereferencing (pwndbg's telescope). The window is read with a single
+	// request, chains are only followed into committed memory according to the region map.
+	class Telescope
+	{
+	public:
+		// Shortest & longest string reported at a pointer
+		static constexpr size_t MinString = 4;
+		static constexpr size_t MaxString = 64;
+		// Most pointers read by one Walk, the window is a single read
+		static constexpr size_t MaxCount = 0x10000;
+
+		// Read `count` (1 to MaxCount) pointers from `address` and follow each for up to `depth` values
+		static std::expected<std::vector<TelescopeEntry>, std::string> Walk(const PageCache::ReadFunction& read,
+			const RegionMap& regions, bool is64bit, uint64_t address, size_t count, size_t depth);
+	private:
+		// Printable string at `address`, empty if there isn't one
+		static std::string StringAt(const PageCache::ReadFunction& read, uint64_t address);
+	};
+}
@@ -0,0 +1,123 @@
+#include "Tracepoint.hpp"
+
+template <typename T>
+static void WriteValue(std::ofstream& out, T value)
+{
+	out.write((const char*)&value, sizeof(T));
+}
+
+std::expected<gdbw::Tracepoint, std::string> gdbw::Tracepoint::Compile(std::string_view fields, DE::RegisterSet set, size_t capacity)
+{
+	Tracepoint tracepoint;
+	size_t pos = 0;
+	while (pos <= fields.size())
+	{
+		size_t end = std::min(fields.find(',', pos), fields.size());
+		std::string_view field = fields.substr(pos, end - pos);
+		field.remove_prefix(std::min(field.find_first_not_of(" \t"), field.size()));
+		field.remove_suffix(field.size() - std::min(field.find_last_not_of(" \t") + 1, field.size()));
+		auto condition = Condition::Compile(field, set);
+		if (!condition)
+			return std::unexpected(condition.error());
+		tracepoint.m_fields.push_back(std::move(*condition));
+		pos = end + 1;
+	}
+	if (tracepoint.m_fields.size() > MaxFields)
+		return std::unexpected(std::format("Tracepoint has more than {} fields", MaxFields));
+
+	// Allocated up front, recording never allocates
+	size_t maxcapacity = MaxBytes / (tracepoint.Stride() * sizeof(uint64_t));
+	if (capacity == 0 || capacity > maxcapacity)
+		return std::unexpected(std::format("Tracepoint capacity must be 1 to {} records with {} fields", maxcapacity, tracepoint.m_fields.size()));
+	tracepoint.m_capacity = capacity;
+	try
+	{
+		tracepoint.m_data.resize(tracepoint.m_capacity * tracepoint.Stride());
+	}
+	catch (const std::bad_alloc&)
+	{
+		return std::unexpected(std::format("Tracepoint failed to allocate {} records", capacity));
+	}
+	return tracepoint;
+}
+
+void gdbw::Tracepoint::Record(const DE::RegisterContext& registers, const Condition::ReadFunction& read, uint64_t thread)
+{
+	uint64_t* record = m_data.data() + m_next * Stride();
+	record[0] = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	record[1] = thread;
+	record[2] = 0;
+	for (size_t i = 0; i < m_fields.size(); i++)
+	{
+		auto value = m_fields[i].Evaluate(registers, read);
+		record[3 + i] = value ? *value : 0;
+		if (value)
+			record[2] |= 1ull << i;
+	}
+
+	m_next = (m_next + 1) % m_capacity;
+	m_count = std::min(m_count + 1, m_capacity);
+	m_hits++;
+}
+
+std::expected<bool, std::string> gdbw::Tracepoint::WriteCsv(const std::string& path) const
+{
+	std::ofstream out(path, std::ios::trunc);
+	if (!out)
+		return std::unexpected(std::format("Tracepoint.WriteCsv failed to open {}", path));
+
+	// Expressions can't contain quotes, quoting is only needed for the commas of multi field headers
+	out << "timestamp,thread";
+	for (auto& field : m_fields)
+		out << ",\"" << field.Expression() << '"';
+	out << '\n';
+
+	std::string line;
+	for (size_t i = 0; i < m_count; i++)
+	{
+		const uint64_t* record = At(i);
+		line = std::format("{},{}", record[0], record[1]);
+		for (size_t j = 0; j < m_fields.size(); j++)
+		{
+			if (record[2] & (1ull << j))
+				line += std::format(",{:#x}", record[3 + j]);
+			else
+				line += ',';
+		}
+		line += '\n';
+		out.write(line.data(), line.size());
+	}
+
+	if (!out)
+		return std::unexpected(std::format("Tracepoint.WriteCsv failed writing {}", path));
+	return true;
+}
+
+std::expected<bool, std::string> gdbw::Tracepoint::WriteBinary(const std::string& path) const
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return std::unexpected(std::format("Tracepoint.WriteBinary failed to open {}", path));
+
+	out.write(Magic, sizeof(Magic));
+	WriteValue(out, Version);
+	WriteValue(out, (uint32_t)m_fields.size());
+	WriteValue(out, (uint64_t)m_count);
+	WriteValue(out, Dropped());
+	for (auto& field : m_fields)
+	{
+		WriteValue(out, (uint32_t)field.Expression().size());
+		out.write(field.Expression().data(), field.Expression().size());
+	}
+
+	// Oldest first, at most two contiguous runs of the ring
+	size_t first = (m_next + m_capacity - m_count) % m_capacity;
+	size_t run = std::min(m_count, m_capacity - first);
+	out.write((const char*)At(0), run * Stride() * sizeof(uint64_t));
+	if (run < m_count)
+		out.write((const char*)m_data.data(), (m_count - run) * Stride() * sizeof(uint64_t));
+
+	if (!out)
+		return std::unexpected(std::format("Tracepoint.WriteBinary failed writing {}", path));
+	return true;
+}
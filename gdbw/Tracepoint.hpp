@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Condition.hpp"
+
+namespace gdbw
+{
+	// Breakpoint that records a tuple of expressions (e.g. "rcx, rdx, dword [rsp+28]") into a ring buffer
+	// on every hit and resumes, the oldest records are overwritten once it's full. Fields are compiled
+	// with the breakpoint condition compiler.
+	//
+	// Binary dump layout (little endian):
+	//   "GDBWTRCE" u32 version u32 fields u64 records u64 dropped
+	//   fields { u32 len expression[len] }
+	//   records { u64 timestamp (ns, steady clock) u64 thread u64 valid (bit i set if field i was read) u64 values[fields] }
+	class Tracepoint
+	{
+	public:
+		static constexpr char Magic[8] = { 'G','D','B','W','T','R','C','E' };
+		static constexpr uint32_t Version = 1;
+		// Fields are flagged in a 64 bit mask
+		static constexpr size_t MaxFields = 64;
+		// The ring buffer is allocated up front, capacity is limited to what fits in this many bytes
+		static constexpr size_t MaxBytes = 0x40000000;
+
+		// Compile comma separated `fields`, keeping the last `capacity` records (1 up to MaxBytes worth)
+		static std::expected<Tracepoint, std::string> Compile(std::string_view fields, DE::RegisterSet set, size_t capacity);
+
+		// Evaluate every field & append a record. Fields that fail to evaluate (e.g. unreadable memory) are recorded as 0
+		// with their valid bit clear.
+		void Record(const DE::RegisterContext& registers, const Condition::ReadFunction& read, uint64_t thread);
+
+		std::expected<bool, std::string> WriteCsv(const std::string& path) const;
+		std::expected<bool, std::string> WriteBinary(const std::string& path) const;
+
+		inline const std::vector<Condition>& Fields(void) const { return m_fields; }
+		inline DE::RegisterSet Set(void) const { return m_fields.front().Set(); }
+		inline size_t Capacity(void) const { return m_capacity; }
+		// Records currently held
+		inline size_t Size(void) const { return m_count; }
+		inline uint64_t Hits(void) const { return m_hits; }
+		// Records overwritten because the buffer was full
+		inline uint64_t Dropped(void) const { return m_hits - m_count; }
+	private:
+		Tracepoint() = default;
+		// Record `index` (0 is the oldest held)
+		inline const uint64_t* At(size_t index) const
+		{
+			size_t slot = (m_next + m_capacity - m_count + index) % m_capacity;
+			return m_data.data() + slot * Stride();
+		}
+		// u64s per record: timestamp, thread, valid mask, values
+		inline size_t Stride(void) const { return 3 + m_fields.size(); }
+
+		std::vector<Condition> m_fields;
+		std::vector<uint64_t> m_data; // m_capacity records
+		size_t m_capacity = 0;
+		size_t m_next = 0;            // slot the next record goes to
+		size_t m_count = 0;
+		uint64_t m_hits = 0;
+	};
+}
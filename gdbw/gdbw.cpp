@@ -1,14 +1,28 @@
 #include "DebugEngine.hpp"
 #include "Bindings.hpp"
+#include "BatchRunner.hpp"
+#include "GdbRemoteTarget.hpp"
+#include "ScanScheduler.hpp"
 #include "thirdparty/argparse/argparse.hpp"
+#ifdef __linux__
+#include <csignal>
+#include "LinuxTarget.hpp"
+#endif
 
-gdbw::DE::Engine* g_dbg;
+// Engine the bindings use, batch mode workers each set their own
+thread_local gdbw::DE::Engine* g_dbg;
+// Interactive session engine, CtrlHandler runs on a thread of its own so can't use g_dbg
+gdbw::DE::Engine* g_session;
+#ifdef __linux__
+// Native process being debugged, detached (or killed if launched) on exit
+gdbw::LinuxTarget* g_process;
+#endif
 
 argparse::ArgumentParser* parse_args(int argc, char** argv)
 {
 	auto parser = new argparse::ArgumentParser("gdbw", "0.1.0");
 	parser->add_description("gdb for windows 'but scriptable' by (0xLegacyy & Zopazz)");
-	// Add attach and file arguments (mutually exclusive and at least one is required)
+	// Add attach, file, remote, dump and script arguments (mutually exclusive and at least one is required)
 	auto& group = parser->add_mutually_exclusive_group(true);
 	group.add_argument("-a", "--attach")
 		.help("attach to a process via pid (e.g. 12004)")
@@ -16,6 +30,22 @@ argparse::ArgumentParser* parse_args(int argc, char** argv)
 	group.add_argument("-f", "--file")
 		.help("debug a binary on disk (e.g. C:\\tmp\\DebugMe.exe)")
 		.metavar("path");
+	group.add_argument("-r", "--remote")
+		.help("connect to a gdbserver compatible stub (e.g. localhost:1234)")
+		.metavar("host:port");
+	group.add_argument("-d", "--dump")
+		.help("inspect a minidump, ELF core file or gdbw snapshot (e.g. C:\\tmp\\crash.dmp)")
+		.metavar("path");
+	group.add_argument("-s", "--script")
+		.help("run a lua script over each input dump/snapshot without prompting, results are written as JSON lines")
+		.metavar("path");
+	parser->add_argument("-j", "--jobs")
+		.help("number of inputs to process in parallel with --script (default: number of cores)")
+		.metavar("count")
+		.scan<'i', int>();
+	parser->add_argument("inputs")
+		.help("dumps/snapshots to run the --script over (or on Linux, arguments for the --file binary)")
+		.remaining();
 
 	try
 	{
@@ -29,51 +59,117 @@ argparse::ArgumentParser* parse_args(int argc, char** argv)
 	return parser;
 }
 
+#ifdef _WIN32
 BOOL WINAPI CtrlHandler(DWORD fdwCtrlType)
 {
 	if (fdwCtrlType == CTRL_C_EVENT)
 	{
-		auto result = g_dbg->Interrupt(DEBUG_INTERRUPT_ACTIVE);
+		// A running memory scan is cancelled instead, the target is suspended anyway
+		if (gdbw::ScanScheduler::Cancel())
+			return TRUE;
+
+		auto result = g_session->Interrupt(DEBUG_INTERRUPT_ACTIVE);
 		if (!result)
 			std::println("Error breaking: {}", result.error());
 		return TRUE;
 	}
 	return FALSE;
 }
-
-int main(int argc, char** argv)
+#else
+void CtrlHandler(int signal)
 {
-	auto args = parse_args(argc, argv);
+	// A running memory scan is cancelled instead, the target is suspended anyway
+	if (gdbw::ScanScheduler::Cancel())
+		return;
 
-	auto lua = new gdbw::LuaManager();
+	// Off Windows there is always a target, which only signals the process (no printing in a signal handler)
+	g_session->Interrupt(DEBUG_INTERRUPT_ACTIVE);
+}
+#endif
 
-	// Register bindings
+// Register bindings, called for the interactive lua state and for every batch mode worker's
+void register_bindings(gdbw::LuaManager* lua)
+{
 	lua->RegisterGlobalFunction(gdbw::bindings::AddressToModuleName, "AddressToModuleName");
 	lua->RegisterGlobalFunction(gdbw::bindings::AddressToSymbol, "AddressToSymbol");
+	lua->RegisterGlobalFunction(gdbw::bindings::AddressesToSymbols, "AddressesToSymbols");
 	lua->RegisterGlobalFunction(gdbw::bindings::BreakpointAdd, "BreakpointAdd");
 	lua->RegisterGlobalFunction(gdbw::bindings::BreakpointSetFlags, "BreakpointSetFlags");
 	lua->RegisterGlobalFunction(gdbw::bindings::BreakpointRemove, "BreakpointRemove");
+	lua->RegisterGlobalFunction(gdbw::bindings::BreakpointSetCondition, "BreakpointSetCondition");
 	lua->RegisterGlobalFunction(gdbw::bindings::BreakpointGetAll, "BreakpointGetAll");
 	lua->RegisterGlobalFunction(gdbw::bindings::ConsoleCols, "ConsoleCols");
 	lua->RegisterGlobalFunction(gdbw::bindings::ConsoleRows, "ConsoleRows");
 	lua->RegisterGlobalFunction(gdbw::bindings::Continue, "Continue");
+	lua->RegisterGlobalFunction(gdbw::bindings::CoverageAdd, "CoverageAdd");
+	lua->RegisterGlobalFunction(gdbw::bindings::CoverageClear, "CoverageClear");
+	lua->RegisterGlobalFunction(gdbw::bindings::CoverageDump, "CoverageDump");
+	lua->RegisterGlobalFunction(gdbw::bindings::CoverageGetStats, "CoverageGetStats");
 	lua->RegisterGlobalFunction(gdbw::bindings::Disassemble, "Disassemble");
+	lua->RegisterGlobalFunction(gdbw::bindings::EmitResult, "EmitResult");
 	lua->RegisterGlobalFunction(gdbw::bindings::Evaluate, "Evaluate");
+	lua->RegisterGlobalFunction(gdbw::bindings::FindPointerPaths, "FindPointerPaths");
+	lua->RegisterGlobalFunction(gdbw::bindings::FindStrings, "FindStrings");
+	lua->RegisterGlobalFunction(gdbw::bindings::GetDisasmCacheStats, "GetDisasmCacheStats");
 	lua->RegisterGlobalFunction(gdbw::bindings::Is64BitTarget, "Is64BitTarget");
 	lua->RegisterGlobalFunction(gdbw::bindings::GetCommands, "GetCommands");
 	lua->RegisterGlobalFunction(gdbw::bindings::GetContext32, "GetContext32");
 	lua->RegisterGlobalFunction(gdbw::bindings::GetContext64, "GetContext64");
+	lua->RegisterGlobalFunction(gdbw::bindings::GetFullContext, "GetFullContext");
+	lua->RegisterGlobalFunction(gdbw::bindings::GetMemoryCacheStats, "GetMemoryCacheStats");
+	lua->RegisterGlobalFunction(gdbw::bindings::GetThreads, "GetThreads");
 	lua->RegisterGlobalFunction(gdbw::bindings::GetVMRegion, "GetVMRegion");
 	lua->RegisterGlobalFunction(gdbw::bindings::GetVMRegions, "GetVMRegions");
+	lua->RegisterGlobalFunction(gdbw::bindings::GetTargetGeneration, "GetTargetGeneration");
 	lua->RegisterGlobalFunction(gdbw::bindings::ReadMemory, "ReadMemory");
+	lua->RegisterGlobalFunction(gdbw::bindings::RegionOf, "RegionOf");
+	lua->RegisterGlobalFunction(gdbw::bindings::RegionsOf, "RegionsOf");
+	lua->RegisterGlobalFunction(gdbw::bindings::SaveSnapshot, "SaveSnapshot");
+	lua->RegisterGlobalFunction(gdbw::bindings::SearchMemory, "SearchMemory");
+	lua->RegisterGlobalFunction(gdbw::bindings::SetThread, "SetThread");
 	lua->RegisterGlobalFunction(gdbw::bindings::StepInto, "StepInto");
 	lua->RegisterGlobalFunction(gdbw::bindings::StepOver, "StepOver");
+	lua->RegisterGlobalFunction(gdbw::bindings::Telescope, "Telescope");
+	lua->RegisterGlobalFunction(gdbw::bindings::TracepointAdd, "TracepointAdd");
+	lua->RegisterGlobalFunction(gdbw::bindings::TracepointDump, "TracepointDump");
+	lua->RegisterGlobalFunction(gdbw::bindings::WatchAdd, "WatchAdd");
 	lua->RegisterGlobalFunction(gdbw::bindings::WriteMemory, "WriteMemory");
 	lua->RegisterGlobalFunction(gdbw::bindings::SymbolNameToSymbol, "SymbolNameToSymbol");
+}
+
+int main(int argc, char** argv)
+{
+	auto args = parse_args(argc, argv);
+
+	// Batch mode, no prompt and no DbgEng session
+	if (auto script = args->present("-s"))
+	{
+		auto inputs = args->present<std::vector<std::string>>("inputs").value_or(std::vector<std::string>());
+		size_t jobs = args->present<int>("-j").value_or((int)std::thread::hardware_concurrency());
+		gdbw::BatchRunner runner(*script, inputs, jobs, register_bindings);
+		auto run_result = runner.Run();
+		if (!run_result)
+		{
+			std::println(stderr, "Error during BatchRunner.Run: {}", run_result.error());
+			return 7;
+		}
+		if (*run_result != 0)
+			std::println(stderr, "Script failed on {} of {} inputs", *run_result, inputs.size());
+		return *run_result != 0 ? 7 : 0;
+	}
+
+	auto lua = new gdbw::LuaManager();
+	register_bindings(lua);
 
-	g_dbg = new gdbw::DE::Engine();
-	
-	auto init_result = g_dbg->Init(lua);
+	g_session = g_dbg = new gdbw::DE::Engine();
+
+	// Remote stubs & dumps are driven without a DbgEng session, as is everything off Windows
+#ifdef _WIN32
+	bool live = args->present("-a") || args->present("-f");
+	auto init_result = live ? g_dbg->Init(lua) : g_dbg->InitOffline(lua);
+#else
+	auto init_result = g_dbg->InitOffline(lua);
+#endif
 	if (!init_result)
 	{
 		std::println("Error during Engine.Init: {}", init_result.error());
@@ -81,32 +177,110 @@ int main(int argc, char** argv)
 	}
 
 	// attach
+	gdbw::Target* target = nullptr;
 	if (auto attach = args->present("-a"))
 	{
+#ifdef _WIN32
 		auto attach_result = g_dbg->Attach(std::stoi(*attach));
 		if (!attach_result)
 		{
 			std::println("Error during Engine.Attach: {}", attach_result.error());
 			return 2;
 		}
+#else
+		g_process = new gdbw::LinuxTarget();
+		auto attach_result = g_process->Attach(std::stoi(*attach));
+		if (!attach_result)
+		{
+			std::println("Error during LinuxTarget.Attach: {}", attach_result.error());
+			return 2;
+		}
+		g_dbg->SetTarget(g_process);
+		target = g_process;
+#endif
+	}
+	else if (auto address = args->present("-r"))
+	{
+		size_t colon = address->rfind(':');
+		uint32_t port = 0;
+		auto [end, ec] = colon == std::string::npos ? std::from_chars_result{ nullptr, std::errc::invalid_argument }
+			: std::from_chars(address->data() + colon + 1, address->data() + address->size(), port);
+		if (ec != std::errc() || end != address->data() + address->size() || port == 0 || port > 0xffff)
+		{
+			std::println("Error: --remote expects host:port");
+			return 5;
+		}
+
+		auto remote = new gdbw::GdbRemoteTarget();
+		auto connect_result = remote->Connect(address->substr(0, colon), (uint16_t)port);
+		if (!connect_result)
+		{
+			std::println("Error during GdbRemoteTarget.Connect: {}", connect_result.error());
+			return 5;
+		}
+		g_dbg->SetTarget(remote);
+		target = remote;
+	}
+	else if (auto path = args->present("-d"))
+	{
+		// Snapshots (SaveSnapshot) replay the same way as dumps
+		auto open_result = gdbw::BatchRunner::OpenInput(*path);
+		if (!open_result)
+		{
+			std::println("Error opening dump: {}", open_result.error());
+			return 6;
+		}
+		target = open_result->release();
+		g_dbg->SetTarget(target);
 	}
 	else // --file
 	{
 		auto file = args->present("-f");
 		// TODO: add --no-entrybreak flag
+#ifdef _WIN32
 		auto attach_result = g_dbg->CreateAndAttach((PSTR)file->c_str());
 		if (!attach_result)
 		{
 			std::println("Error during Engine.CreateAndAttach: {}", attach_result.error());
 			return 3;
 		}
+#else
+		std::vector<std::string> command = { *file };
+		auto inputs = args->present<std::vector<std::string>>("inputs").value_or(std::vector<std::string>());
+		command.insert(command.end(), inputs.begin(), inputs.end());
+
+		g_process = new gdbw::LinuxTarget();
+		auto launch_result = g_process->Launch(command);
+		if (!launch_result)
+		{
+			std::println("Error during LinuxTarget.Launch: {}", launch_result.error());
+			return 3;
+		}
+		g_dbg->SetTarget(g_process);
+		target = g_process;
+#endif
 	}
 
 	// Set Ctrl+C handler
+#ifdef _WIN32
 	if (!SetConsoleCtrlHandler(CtrlHandler, TRUE))
 		std::println("Warning: could not register CTRL+C handler");
+#else
+	struct sigaction action = {};
+	action.sa_handler = CtrlHandler;
+	action.sa_flags = SA_RESTART;
+	if (sigaction(SIGINT, &action, nullptr) != 0)
+		std::println("Warning: could not register CTRL+C handler");
+	// `quit` exits from the prompt, breakpoints must not be left behind in an attached process
+	std::atexit([]() { delete g_process; });
+#endif
 
-	auto debug_result = g_dbg->EnterDebugLoop();
+	// Remote stubs, dumps & Linux processes have their own run control, everything else goes through DbgEng
+#ifdef _WIN32
+	auto debug_result = target ? g_dbg->EnterTargetLoop() : g_dbg->EnterDebugLoop();
+#else
+	auto debug_result = g_dbg->EnterTargetLoop();
+#endif
 	if (!debug_result)
 	{
 		std::println("Error during Engine.EnterDebugLoop: {}", debug_result.error());
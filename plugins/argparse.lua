@@ -139,7 +139,7 @@ function ArgumentParser:ParseArgs(commandline_str)
                     if string.len(commandline[i]) == 2 then
                         table.insert(tokenised, "")
                     else
-                        table.insert(tokenised, string.sub(commandline[i], 2, -1))
+                        table.insert(tokenised, string.sub(commandline[i], 2, -2))
                     end
                 else
                     in_string = true
@@ -1,13 +1,14 @@
 breakpoint = {
     iscommand=true;
     alias={"breakpoint","bp"};
-    help="usage: breakpoint <address>";
+    help="usage: breakpoint <address> [-c condition]";
 }
 
 function breakpoint:parseargs(args)
     local parser = ArgumentParser
     parser:init("breakpoint", "add breakpoint at a given address", false)
     parser:AddArgument("address", "breakpoint address", true, "store", Evaluate)
+    parser:AddArgument({"-c", "--condition"}, "only stop when this is non zero, e.g. \"rcx == 0x10 && [rdx+8] > 4\"", false, "store", nil)
     return parser:ParseArgs(args)
 end
 
@@ -16,6 +17,26 @@ function breakpoint:command(args)
     if namespace == nil then return end
 
     local address = namespace["address"]
-    local bpid = BreakpointAdd(address)
+    local bpid, created = BreakpointAdd(address)
+    local condition = namespace["--condition"]
+    if condition ~= nil then
+        local success, err = pcall(function() BreakpointSetCondition(bpid, condition) end)
+        if success == false then
+            -- A breakpoint that was already there is left as it was
+            if created then BreakpointRemove(bpid) end
+            printf("Invalid condition: %s", err)
+            return
+        end
+        if not created then
+            printf("Breakpoint %d @ 0x%x already set, condition replaced with %s", bpid, address, condition)
+            return
+        end
+        printf("Breakpoint %d set @ 0x%x if %s", bpid, address, condition)
+        return
+    end
+    if not created then
+        printf("Breakpoint %d @ 0x%x already set", bpid, address)
+        return
+    end
     printf("Breakpoint %d set @ 0x%x", bpid, address)
 end
\ No newline at end of file
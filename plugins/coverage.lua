@@ -0,0 +1,87 @@
+coverage = {
+    iscommand=true;
+    alias={"coverage", "cov"};
+    help="usage: coverage [-m module] [-b blocks] [-w path] [--clear]";
+}
+
+function coverage:parseargs(args)
+    local parser = ArgumentParser
+    parser:init("coverage", "record which functions (or basic blocks) of a module execute with one shot breakpoints, shows the coverage so far without arguments", false)
+    parser:AddArgument({"-m", "--module"}, "module (name or any address in it) to cover", false, "store", Evaluate)
+    parser:AddArgument({"-b", "--blocks"}, "file of block offsets from the module base, one '<offset> [size]' (hex) per line, instead of every function", false, "store", nil)
+    parser:AddArgument({"-w", "--write"}, "write the coverage to a drcov file", false, "store", nil)
+    parser:AddArgument("--clear", "remove the breakpoints not hit yet & forget all coverage", false, "store_true", nil)
+    return parser:ParseArgs(args)
+end
+
+---Read '<offset> [size]' lines, offsets are relative to the module base
+---@param path string
+---@return table|nil
+function coverage:readblocks(path)
+    local file = io.open(path, "r")
+    if file == nil then return nil end
+
+    local blocks = {}
+    for line in file:lines() do
+        local offset, size = string.match(line, "^%s*(%x+)%s*(%x*)")
+        if offset ~= nil then
+            local block = {offset=tonumber(offset, 16), size=1}
+            if size ~= "" then block.size = tonumber(size, 16) end
+            table.insert(blocks, block)
+        end
+    end
+    file:close()
+    return blocks
+end
+
+function coverage:command(args)
+    local namespace = coverage:parseargs(args)
+    if namespace == nil then return end
+
+    if namespace["--clear"] then
+        local success, removed = pcall(function() return CoverageClear() end)
+        if success == false then
+            printf("Failed to clear coverage: %s", removed)
+            return
+        end
+        printf("Coverage cleared, removed %d breakpoints", removed)
+        return
+    end
+
+    local module = namespace["--module"]
+    if module ~= nil then
+        local blocks = nil
+        if namespace["--blocks"] ~= nil then
+            blocks = coverage:readblocks(namespace["--blocks"])
+            if blocks == nil then
+                printf("Failed to open %s", namespace["--blocks"])
+                return
+            end
+        end
+
+        local success, placed = pcall(function() return CoverageAdd(module, blocks) end)
+        if success == false then
+            printf("Failed to add coverage: %s", placed)
+            return
+        end
+        printf("Placed %d coverage breakpoints", placed)
+    end
+
+    local path = namespace["--write"]
+    if path ~= nil then
+        local success, hits = pcall(function() return CoverageDump(path) end)
+        if success == false then
+            printf("Failed to write coverage: %s", hits)
+            return
+        end
+        printf("Wrote %d blocks to %s", hits, path)
+    end
+
+    if module == nil and path == nil then
+        local stats = CoverageGetStats()
+        for i, mod in ipairs(stats.modules) do
+            printf("%s %s%s%s %d/%d blocks", address2hex(mod.base), colour.GREEN, mod.path, colour.DEFAULT, mod.hits, mod.blocks)
+        end
+        printf("%d/%d blocks hit", stats.hits, stats.blocks)
+    end
+end
\ No newline at end of file
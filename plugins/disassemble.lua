@@ -12,13 +12,17 @@ function disassemble:parseargs(args)
 end
 
 function disassemble:print_instructions(instructions, ip)
+    local addresses = {}
+    for i, insn in pairs(instructions) do
+        addresses[i] = insn.address
+    end
+    local symbols = AddressesToSymbols(addresses)
+
     for i, insn in pairs(instructions) do
         ---@type Symbol
-        local symbol
-        local success
+        local symbol = symbols[i]
         local disasm_line
-        success, symbol = pcall(function(a) return AddressToSymbol(a) end, insn.address)
-        if success then
+        if symbol ~= nil then
             disasm_line = string.format("%s <%s+%d> \t%s\t\t%s", address2hex(insn.address), symbol.name, symbol.displacement, insn.mnemonic, insn.opstr)
         else
             disasm_line = string.format("%s \t%s\t\t%s", address2hex(insn.address), insn.mnemonic, insn.opstr)
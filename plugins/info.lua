@@ -4,7 +4,6 @@ info = {
     help = "usage: info [breakpoint|registername]";
     targetis64bit = true;
     displayed = false;
-    virtual_map = nil;
     print_cache = nil;
     old_ctx = {
         rax = 0,
@@ -35,28 +34,19 @@ function info:get_gen_purp_registers()
     end
 end
 
+---Telescope `depth` stack slots from the stack pointer
+---@return [TelescopeEntry]
 function info:get_stack(depth, ctx)
     local stack_start
-    local ptr_size
-    local vals = {}
     if info.targetis64bit then
         stack_start = ctx.rsp
-        ptr_size = 8
     else
         stack_start = ctx.esp
-        ptr_size = 4
     end
 
-    for i = 1, depth, 1 do
-        local toread = stack_start + ((i-1)*ptr_size)
-        local rawmem = ReadMemory(toread, ptr_size)
-        local memnum = 0
-        for j = 1, ptr_size, 1 do
-            memnum = memnum | (string.byte(rawmem, j) << ((j-1)*ptr_size))
-        end
-        vals[toread] = memnum
-    end
-    return vals
+    local success, entries = pcall(function() return Telescope(stack_start, depth, 4) end)
+    if success == false then return {} end
+    return entries
 end
 
 function info:create_border(name)
@@ -85,15 +75,15 @@ function info:create_border(name)
     return border
 end
 
+---@param region RegionInfo|nil
+function info:get_region_colour(region)
+    if region == nil then return colour.DEFAULT end
+    if region.kind == "stack" then return colour.YELLOW end
+    return vmmap:prot2colour(region.protections)
+end
+
 function info:get_addr_colour(addr)
-    for i, region in pairs(info.virtual_map) do
-        if ((addr >= region.baseaddress) and (addr < (region.baseaddress + region.size))) then
-            return vmmap:prot2colour(region.protections)
-        end
-        if (addr < region.baseaddress) then
-            return colour.DEFAULT
-        end
-    end
+    return info:get_region_colour(RegionOf(addr))
 end
 
 function info:get_register_pprint(name, value, color)
@@ -136,12 +126,16 @@ function info:get_disasm_str(ctx)
     local longest_mnemonic = 0
     local sz = 0
 
+    local addresses = {}
+    for i, insn in pairs(instructions) do
+        addresses[i] = insn.address
+    end
+    local symbols = AddressesToSymbols(addresses)
+
     for i, insn in pairs(instructions) do
         ---@type Symbol
-        local symbol
-        local success
-        success, symbol = pcall(function(a) return AddressToSymbol(a) end, insn.address)
-        if success then
+        local symbol = symbols[i]
+        if symbol ~= nil then
             local prefix = string.format("%s <%s+%d> ",  address2hex(insn.address), symbol.name, symbol.displacement)
             if longest_prefix < string.len(prefix) then
                 longest_prefix = string.len(prefix)
@@ -176,23 +170,39 @@ function info:get_disasm_str(ctx)
     return to_print
 end
 
+---Pointer chain of a telescope entry, e.g. 0x1000 -> 0x2000 (main+0x10)
+---@param hops [TelescopeHop]
+---@return string
+function info:get_chain_str(hops)
+    local parts = {}
+    for i, hop in ipairs(hops) do
+        local part = string.format("%s0x%x%s", info:get_region_colour(hop.region), hop.value, colour.DEFAULT)
+        if hop.symbol ~= nil then
+            part = part .. string.format(" (%s)", hop.symbol)
+        end
+        if hop.string ~= nil then
+            part = part .. string.format(" %s\"%s\"%s", colour.GREEN, hop.string, colour.DEFAULT)
+        end
+        parts[#parts + 1] = part
+    end
+    return table.concat(parts, " -> ")
+end
+
 function info:get_stack_str(ctx)
     local to_print = info:create_border("STACK") .. string.char(10)
-    local stack_vals = info:get_stack(8, ctx)
+    local entries = info:get_stack(8, ctx)
     local ptr_size
     if info.targetis64bit then ptr_size = 8 else ptr_size = 4 end
-    local i = 0
-    for k, v in pairs(stack_vals) do
+    for i, entry in ipairs(entries) do
         local register_on_stack = ""
         for k1, v1 in pairs(ctx) do
-            if v1 == k then
+            if v1 == entry.address then
                 register_on_stack = k1
             end
         end
-        to_print = to_print .. string.format("%02x:%04x|", i, i*ptr_size)
-        to_print = to_print .. string.format("%s%s0x%x%s ", string.pad(register_on_stack, 5, " "), colour.YELLOW,  k, colour.DEFAULT)
-        to_print = to_print .. string.format(": %s0x%x%s", info:get_addr_colour(v), v, colour.DEFAULT) .. string.char(10)
-        i = i + 1
+        to_print = to_print .. string.format("%02x:%04x|", i - 1, (i - 1)*ptr_size)
+        to_print = to_print .. string.format("%s%s0x%x%s ", string.pad(register_on_stack, 5, " "), colour.YELLOW, entry.address, colour.DEFAULT)
+        to_print = to_print .. ": " .. info:get_chain_str(entry.hops) .. string.char(10)
     end
     return to_print
 end
@@ -203,7 +213,19 @@ function info:print_breakpoints()
         if bp.enabled then
             enabled_str = colour.GREEN .. "enabled" .. colour.DEFAULT
         end
-        printf("%d: %s %s", bp.id, address2hex(bp.address), enabled_str)
+        local details = ""
+        if bp.watch ~= nil then
+            details = string.format(" watch %s %d bytes", bp.watch.access, bp.watch.size)
+            if bp.watch.changed then details = details .. " on change" end
+        end
+        if bp.tracepoint ~= nil then
+            local tp = bp.tracepoint
+            details = string.format(" trace %s (%d hits, %d/%d records)", table.concat(tp.fields, ", "), tp.hits, tp.records, tp.capacity)
+        end
+        if bp.condition ~= nil then
+            details = details .. " if " .. bp.condition
+        end
+        printf("%d: %s %s%s", bp.id, address2hex(bp.address), enabled_str, details)
     end
 end
 
@@ -213,7 +235,6 @@ function info:print_state(ctx)
         print(info.print_cache)
         return
     end
-    info.virtual_map = GetVMRegions()
     local to_print = info:get_gen_purp_register_str(ctx)
     to_print = to_print .. info:get_disasm_str(ctx)
     to_print = to_print .. info:get_stack_str(ctx)
@@ -254,6 +275,15 @@ function info:command(args)
         else
             if (ctx[args] ~= nil) then
                 print(address2hex(ctx[args]))
+                return
+            end
+            -- flags, segment, debug, x87 & vector registers
+            local value = GetFullContext()[args]
+            if type(value) == "string" then
+                -- packed little endian bytes, print most significant byte first
+                print("0x" .. string.gsub(string.reverse(value), ".", function(c) return string.format("%02x", string.byte(c)) end))
+            elseif value ~= nil then
+                print(address2hex(value))
             else
                 printf("Unknown register %s", args)
             end
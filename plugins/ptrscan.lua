@@ -0,0 +1,59 @@
+ptrscan = {
+    iscommand=true;
+    alias={"ptrscan"};
+    help="usage: ptrscan <address> [-d depth] [-o offset] [-l limit]";
+}
+
+function ptrscan:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("ptrscan", "find static (module+offset) pointer paths leading to an address", false)
+    parser:AddArgument("address", "address the paths should lead to", true, "store", Evaluate)
+    parser:AddArgument({"-d", "--depth"}, "maximum number of dereferences (default 4)", false, "store", math.tointeger)
+    parser:AddArgument({"-o", "--offset"}, "maximum offset added after a dereference (default 0x1000)", false, "store", Evaluate)
+    parser:AddArgument({"-l", "--limit"}, "maximum number of paths to display (default 64)", false, "store", math.tointeger)
+    return parser:ParseArgs(args)
+end
+
+---@param path PointerPath
+---@return string
+function ptrscan:path2str(path)
+    local str = string.format("[%s+0x%x]", path.module, path.moduleoffset)
+    for i, offset in ipairs(path.offsets) do
+        if i == #path.offsets then
+            str = string.format("%s + 0x%x", str, offset)
+        else
+            str = string.format("[%s + 0x%x]", str, offset)
+        end
+    end
+    return str
+end
+
+function ptrscan:command(args)
+    local namespace = ptrscan:parseargs(args)
+    if namespace == nil then return end
+
+    local address = namespace["address"]
+    if address == nil then
+        print("Could not evaluate address")
+        return
+    end
+
+    local limit = namespace["--limit"] or 64
+    local opts = {depth=namespace["--depth"], offset=namespace["--offset"], limit=limit + 1}
+    local success, paths, stats = pcall(function() return FindPointerPaths(address, opts) end)
+    if success == false then
+        printf("Pointer scan failed: %s", paths)
+        return
+    end
+    if stats.cancelled then
+        print("Scan cancelled, paths are based on a partial index")
+    end
+
+    for i = 1, math.min(#paths, limit) do
+        printf("%s%s%s -> %s", info:get_addr_colour(paths[i].base), ptrscan:path2str(paths[i]), colour.DEFAULT, address2hex(address))
+    end
+    if #paths > limit then
+        printf("... more than %d paths, use -l to show more", limit)
+    end
+    printf("%d paths (%s)", math.min(#paths, limit), search:stats2str(stats))
+end
\ No newline at end of file
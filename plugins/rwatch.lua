@@ -0,0 +1,22 @@
+rwatch = {
+    iscommand=true;
+    alias={"rwatch"};
+    help="usage: rwatch <address> [-s size] [--changed] [-c condition]";
+}
+
+function rwatch:parseargs(args)
+    local parser = ArgumentParser
+    parser:init("rwatch", "stop when memory is read or written with a hardware data breakpoint (at most 4)", false)
+    parser:AddArgument("address", "address to watch, aligned to size", true, "store", Evaluate)
+    parser:AddArgument({"-s", "--size"}, "bytes watched: 1, 2, 4 or 8 (default pointer size)", false, "store", math.tointeger)
+    parser:AddArgument("--changed", "only stop when the value differs from the last one", false, "store_true", nil)
+    parser:AddArgument({"-c", "--condition"}, "only stop when this is non zero", false, "store", nil)
+    return parser:ParseArgs(args)
+end
+
+function rwatch:command(args)
+    local namespace = rwatch:parseargs(args)
+    if namespace == nil then return end
+
+    watch:add(namespace, "read")
+end
\ No newline at end of file
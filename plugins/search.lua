@@ -0,0 +1,96 @@
+search = {
+    iscommand=true;
+    alias={"search"};
+    help="usage: search <pattern> [-t type] [-l limit] [-a align]";
+    valid_types={"hex", "string", "wstring", "byte", "word", "dword", "qword"};
+}
+
+function search:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("search", "search committed memory for a byte pattern", false)
+    parser:AddArgument("pattern", "hex bytes with ?? wildcards (e.g. \"48 8b ?? 05\"), a string or an integer", true, "store", nil)
+    parser:AddArgument({"-t", "--type"}, "pattern type: hex (default), string, wstring, byte, word, dword or qword", false, "store", nil)
+    parser:AddArgument({"-l", "--limit"}, "maximum number of matches to display (default 256)", false, "store", math.tointeger)
+    parser:AddArgument({"-a", "--align"}, "only report matches aligned to this many bytes", false, "store", math.tointeger)
+    return parser:ParseArgs(args)
+end
+
+---Hex & ascii preview of the bytes at a match
+---@param address integer
+---@param len integer
+---@return string
+function search:preview(address, len)
+    local data = memory:read(address, len)
+    if data == nil then return "" end
+    local hex = {}
+    local ascii = {}
+    for i = 1, #data do
+        local byte = string.byte(data, i)
+        hex[#hex + 1] = string.format("%02x", byte)
+        if byte >= 0x20 and byte < 0x7F then
+            ascii[#ascii + 1] = string.char(byte)
+        else
+            ascii[#ascii + 1] = "."
+        end
+    end
+    return table.concat(hex, " ") .. "  " .. table.concat(ascii)
+end
+
+---@param stats ScanStats
+---@return string
+function search:stats2str(stats)
+    return string.format("scanned %.1f MB in %.2fs, %.1f MB/s", stats.bytes / 0x100000, stats.seconds, stats.bytespersecond / 0x100000)
+end
+
+function search:command(args)
+    local namespace = search:parseargs(args)
+    if namespace == nil then return end
+
+    local pattern_type = namespace["--type"] or "hex"
+    if table.indexOf(search.valid_types, pattern_type) == nil then
+        printf("Unknown pattern type %s, expected one of: %s", pattern_type, table.concat(search.valid_types, ", "))
+        return
+    end
+
+    local pattern = namespace["pattern"]
+    if pattern_type == "byte" or pattern_type == "word" or pattern_type == "dword" or pattern_type == "qword" then
+        pattern = Evaluate(pattern)
+        if pattern == nil then
+            printf("Could not evaluate %s", namespace["pattern"])
+            return
+        end
+    end
+
+    local limit = namespace["--limit"] or 256
+    local success, matches, stats = pcall(function()
+        return SearchMemory(pattern, {type=pattern_type, limit=limit + 1, align=namespace["--align"] or 1})
+    end)
+    if success == false then
+        printf("Search failed: %s", matches)
+        return
+    end
+    if stats.cancelled then
+        print("Search cancelled, showing matches found so far")
+    end
+    if #matches == 0 then
+        printf("No matches (%s)", search:stats2str(stats))
+        return
+    end
+
+    local regions = RegionsOf(matches)
+    for i = 1, math.min(#matches, limit) do
+        local region = regions[i]
+        local name = ""
+        if region ~= nil then
+            name = region.module
+            if region.kind == "stack" or region.kind == "heap" then
+                name = "[" .. region.kind .. "]"
+            end
+        end
+        printf("%s%s%s %s %s", info:get_region_colour(region), address2hex(matches[i]), colour.DEFAULT, string.rpad(name, 16, " "), search:preview(matches[i], 16))
+    end
+    if #matches > limit then
+        printf("... more than %d matches, use -l to show more", limit)
+    end
+    printf("%d matches (%s)", math.min(#matches, limit), search:stats2str(stats))
+end
\ No newline at end of file
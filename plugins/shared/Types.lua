@@ -4,6 +4,33 @@
 ---@field id integer breakpoint id
 ---@field address integer breakpoint address
 ---@field enabled boolean true if breakpoint enabled
+---@field condition string|nil condition the breakpoint only stops on, nil if it always stops
+---@field tracepoint TracepointInfo|nil set if the breakpoint records fields instead of stopping
+---@field watch WatchInfo|nil set for data breakpoints
+
+---@class WatchInfo
+---@field size integer bytes watched
+---@field access "read"|"write"|"execute"
+---@field changed boolean only stops when the value changes
+
+---@class TracepointInfo
+---@field fields [string] expressions recorded on every hit
+---@field hits integer
+---@field records integer records held in the ring buffer
+---@field dropped integer oldest records overwritten once the buffer was full
+---@field capacity integer
+
+---@class CoverageStats
+---@field blocks integer blocks with a coverage breakpoint placed
+---@field hits integer blocks executed at least once
+---@field modules [CoverageModule]
+
+---@class CoverageModule
+---@field base integer
+---@field size integer
+---@field path string
+---@field blocks integer
+---@field hits integer
 
 ---@class Command Registered debugger command
 ---@field name string command name (e.g. disassemble)
@@ -40,6 +67,34 @@
 ---@field r14 integer
 ---@field r15 integer
 
+---@class FullContext Extended register values for a thread. Registers the target doesn't have are nil.
+---Vector & x87 registers are packed little endian binary strings (use string.unpack)
+---@field eflags integer
+---@field cs integer
+---@field ds integer
+---@field es integer
+---@field fs integer
+---@field gs integer
+---@field ss integer
+---@field dr0 integer
+---@field dr1 integer
+---@field dr2 integer
+---@field dr3 integer
+---@field dr6 integer
+---@field dr7 integer
+---@field fpcw integer
+---@field fpsw integer
+---@field fptw integer
+---@field mxcsr integer
+---@field st0 string 10 bytes (st0-st7)
+---@field xmm0 string 16 bytes (xmm0-xmm15)
+---@field ymm0 string 32 bytes (ymm0-ymm15), only present when AVX state is available
+
+---@class DisasmCacheStats Decoded instruction cache counters for the current session
+---@field hits integer instructions served from the cache
+---@field misses integer instructions that had to be decoded
+---@field instructions integer instructions currently cached
+
 ---@class Instruction Defines a single disassembled instruction
 ---@field address integer
 ---@field mnemonic string
@@ -47,11 +102,21 @@
 ---@field bytes string
 ---@field size integer
 
+---@class MemoryCacheStats Memory read cache counters for the current session
+---@field hits integer page reads served from the cache
+---@field misses integer page reads that went to the target
+---@field pages integer pages currently cached
+
 ---@class MemoryRegion Defines a single memory region
 ---@field baseaddress integer
 ---@field protections integer
 ---@field size integer
 ---@field state integer
+---@field type integer MEM_IMAGE, MEM_MAPPED or MEM_PRIVATE
+
+---@class RegionInfo : MemoryRegion A committed memory region and what it is used for
+---@field kind "stack"|"heap"|"image"|"mapped"|"private"
+---@field module string name of the owning module, "" if not part of an image
 
 ---@class Symbol Defines a single symbol (e.g. a function)
 ---@field address integer
@@ -73,9 +138,15 @@ function AddressToModuleName(address) end
 ---@return Symbol
 function AddressToSymbol(address) end
 
----Add a software breakpoint
+---Get symbols for a list of addresses in one call
+---@param addresses [integer]
+---@return [Symbol|nil] Array parallel to addresses, nil where no symbol was found
+function AddressesToSymbols(addresses) end
+
+---Add a software breakpoint, an existing code breakpoint at the address is returned instead
 ---@param address integer breakpoint address
 ---@return integer breakpoint id
+---@return boolean created false if the breakpoint was already there
 function BreakpointAdd(address) end
 
 ---Get all registered breakpoints
@@ -91,6 +162,40 @@ function BreakpointSetFlags(id, flags) end
 ---@param id integer breakpoint id
 function BreakpointRemove(id) end
 
+---Only stop at a breakpoint when a condition is non zero, e.g. `rcx == 0x10 && [rdx+8] > 4`.
+---The condition is compiled once and evaluated by the engine on every hit, hits where it's zero
+---resume without entering the prompt. Errors if the condition doesn't compile.
+---Operators follow C, numbers are hex (0n for decimal), [x] reads a pointer, byte/word/dword/qword [x] sized values.
+---@param id integer breakpoint id
+---@param condition string|nil nil or "" to always stop
+function BreakpointSetCondition(id, condition) end
+
+---Add a tracepoint, a breakpoint that records comma separated fields (e.g. "rcx, rdx, dword [rsp+28]",
+---same syntax as conditions) into a ring buffer on every hit and resumes without stopping or calling lua.
+---A condition set with BreakpointSetCondition decides which hits are recorded.
+---@param address integer
+---@param fields string
+---@param capacity integer|nil Records kept, the oldest are overwritten (default 65536)
+---@return integer breakpoint id
+function TracepointAdd(address, fields, capacity) end
+
+---Add a hardware data breakpoint, at most 4 can be set. Conditions set with BreakpointSetCondition apply.
+---@param address integer aligned to size
+---@param size integer|nil 1, 2, 4 or 8 (default pointer size), execute watches must be 1
+---@param access "write"|"read"|"execute"|nil Default "write", "read" also stops on writes
+---@param changed boolean|nil Only stop when the value differs from the last one seen, checked by the engine
+---@return integer breakpoint id, an identical watch already set is returned instead
+---@return boolean created false if the watch was already there
+function WatchAdd(address, size, access, changed) end
+
+---Write a tracepoint's records (oldest first) to a file. CSV has a timestamp (ns), thread & hex value
+---column per field, fields that couldn't be read are left empty. See Tracepoint.hpp for the binary layout.
+---@param id integer breakpoint id
+---@param path string
+---@param format "csv"|"binary"|nil Default "csv"
+---@return integer records written
+function TracepointDump(id, path, format) end
+
 ---Get console cols
 ---@return integer
 function ConsoleCols() end
@@ -102,6 +207,27 @@ function ConsoleRows() end
 ---Inform the debugger that it should continue
 function Continue() end
 
+---Place a one shot breakpoint on every block of a module. Each records its hit into a bitmap & removes itself
+---the first time it executes, resuming without stopping or calling lua. Without blocks every function is covered
+---(from the exception directory, or symbols for x86 images). Blocks already placed are skipped.
+---@param address integer any address in the module
+---@param blocks [integer|{offset: integer, size: integer}]|nil offsets from the module base
+---@return integer breakpoints placed
+function CoverageAdd(address, blocks) end
+
+---Remove the coverage breakpoints not hit yet & forget all coverage
+---@return integer breakpoints removed
+function CoverageClear() end
+
+---Write the blocks hit so far in drcov format
+---@param path string
+---@return integer blocks written
+function CoverageDump(path) end
+
+---Get coverage counts, overall & per module
+---@return CoverageStats
+function CoverageGetStats() end
+
 ---Disassemble code at a given address
 ---@param address integer
 ---@param len integer
@@ -109,10 +235,19 @@ function Continue() end
 ---@return [Instruction] Array of instructions
 function Disassemble(address, len, instruction_count) end
 
+---Get decoded instruction cache counters
+---@return DisasmCacheStats
+function GetDisasmCacheStats() end
+
 ---Get all registered commands
 ---@return [Command] Array of commands
 function GetCommands() end
 
+---Write a result for the current input as a JSON line ({"input": path, "result": value}).
+---Only available to scripts run with --script, which receive the input path as `...`
+---@param value any Tables, strings, numbers & booleans
+function EmitResult(value) end
+
 ---Evaluate an expression and get the returned integer, otherwise nil
 ---@param expression string
 ---@return integer|nil
@@ -122,19 +257,54 @@ function Evaluate(expression) end
 ---@return boolean
 function Is64BitTarget() end
 
----Get a virtual memory region
+---Retrieve flags, segment, debug, x87, SSE & AVX registers in one call
+---@return FullContext
+function GetFullContext() end
+
+---Get memory read cache counters
+---@return MemoryCacheStats
+function GetMemoryCacheStats() end
+
+---Get a virtual memory region. Targets other than a live process only know committed regions, nil
+---is returned for anything else.
 ---@param address integer
----@return MemoryRegion
+---@return MemoryRegion|nil
 function GetVMRegion(address) end
 
----Get a list of all virtual memory regions
+---Get a list of all committed virtual memory regions, sorted by address.
+---The engine caches the map until the target generation changes.
 ---@return [MemoryRegion]
 function GetVMRegions() end
 
+---Get the target generation, changes whenever the target runs, a module is (un)loaded or memory is written.
+---Useful for caching anything derived from target state in lua.
+---@return integer
+function GetTargetGeneration() end
+
+---Get the committed region containing an address (binary search over the cached region map)
+---@param address integer
+---@return RegionInfo|nil
+function RegionOf(address) end
+
+---Get the committed region containing each address in a list.
+---The result is parallel to `addresses`, addresses outside any committed region are nil.
+---@param addresses [integer]
+---@return [RegionInfo]
+function RegionsOf(addresses) end
+
 ---Retrieve thread context from the debugger
 ---@return Context32
 function GetContext32() end
 
+---Get the ids of the threads whose registers the target can report (e.g. every thread saved in a dump),
+---the current one first. Empty if the target only knows the current thread.
+---@return [integer]
+function GetThreads() end
+
+---Make GetContext32/GetContext64 report another thread's registers
+---@param id integer thread id from GetThreads
+function SetThread(id) end
+
 ---Retrieve thread context from the debugger
 ---@return Context64
 function GetContext64() end
@@ -145,6 +315,92 @@ function GetContext64() end
 ---@return string
 function ReadMemory(address, len) end
 
+---Save the registers, committed memory & modules of the target to a snapshot file,
+---which can be replayed without a live target. Errors if the file can't be written.
+---@param path string
+function SaveSnapshot(path) end
+
+---@class SearchOptions
+---@field type string|nil "hex" (default, e.g. "48 8b ?? 05"), "string", "wstring" (UTF-8, searched as UTF-16LE), "byte", "word", "dword" or "qword"
+---@field start integer|nil Lowest address to search
+---@field end integer|nil Address to stop searching at
+---@field limit integer|nil Stop after this many matches (default: no limit)
+---@field align integer|nil Only report matches aligned to this many bytes
+
+---@class ScanStats
+---@field bytes integer Bytes scanned
+---@field seconds number
+---@field bytespersecond number
+---@field cancelled boolean True if the scan was cancelled with Ctrl+C
+
+---Search committed, readable memory for a pattern. Regions are streamed through a
+---vectorized matcher on every core, errors if the pattern is invalid.
+---@param pattern string|integer
+---@param opts SearchOptions|nil
+---@return [integer] matches Addresses of matches in ascending order
+---@return ScanStats stats
+function SearchMemory(pattern, opts) end
+
+---@class PointerScanOptions
+---@field depth integer|nil Maximum number of dereferences (default 4)
+---@field offset integer|nil Maximum offset added after a dereference (default 0x1000)
+---@field limit integer|nil Stop after this many paths (default 256, 0 for no limit)
+
+---@class PointerPath
+---@field base integer Address in an image the path starts at
+---@field module string Module `base` belongs to
+---@field moduleoffset integer Offset of `base` from the module's base address
+---@field offsets [integer] Added after each dereference, `[[base] + offsets[1]] + offsets[2] ...` is the address
+
+---Find static pointer paths to `address`. Every pointer stored in writable memory is indexed on
+---every core, then the index is walked back from `address` until pointers stored in images are found.
+---Shortest paths are returned first.
+---@param address integer
+---@param opts PointerScanOptions|nil
+---@return [PointerPath] paths
+---@return ScanStats stats Statistics of the index scan
+function FindPointerPaths(address, opts) end
+
+---@class StringQuery
+---@field start integer|nil Only strings at or after this address
+---@field end integer|nil Only strings before this address
+---@field contains string|nil Only strings containing this text
+---@field limit integer|nil Stop after this many strings (default: no limit)
+
+---@class FoundString
+---@field address integer
+---@field string string Text, UTF-16 strings are narrowed to ascii (at most 1024 characters)
+---@field encoding "ascii"|"utf16"
+
+---Find printable strings in committed, readable memory. Every region is indexed on every core the
+---first time strings are asked for, later queries are served from the index until the memory layout
+---changes (module or thread load/unload, writes). Strings that changed since the index was built are
+---skipped; new ones written while the target ran are only found once the index is rebuilt.
+---@param min_len integer|nil Minimum length in characters (default 4)
+---@param encodings "all"|"ascii"|"utf16"|nil Default "all"
+---@param query StringQuery|nil
+---@return [FoundString] strings In address order
+---@return ScanStats|nil stats Statistics of the index scan, nil if the index was reused
+function FindStrings(min_len, encodings, query) end
+
+---@class TelescopeHop
+---@field value integer
+---@field region RegionInfo|nil Region `value` points into, nil if it isn't a pointer
+---@field symbol string|nil Symbol (with displacement) of values pointing into an image
+---@field string string|nil Printable ASCII/UTF-16 string `value` points to
+
+---@class TelescopeEntry
+---@field address integer Address of the slot
+---@field hops [TelescopeHop] Value in the slot followed by the values it leads to
+
+---Read `count` pointer sized values at `address` in one request and follow each value while it
+---points to committed memory, up to `depth` values per slot. Errors if `address` can't be read.
+---@param address integer
+---@param count integer
+---@param depth integer|nil Default 4
+---@return [TelescopeEntry]
+function Telescope(address, count, depth) end
+
 ---Step into
 function StepInto() end
 
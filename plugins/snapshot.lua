@@ -0,0 +1,24 @@
+snapshot = {
+    iscommand=true;
+    alias={"snapshot"};
+    help="usage: snapshot <path>"
+}
+
+function snapshot:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("snapshot", "save registers, memory & modules of the target to a file", false)
+    parser:AddArgument("path", "file to write the snapshot to", true, "store", nil)
+    return parser:ParseArgs(args)
+end
+
+function snapshot:command(args)
+    local namespace = snapshot:parseargs(args)
+    if namespace == nil then return end
+
+    local success, err = pcall(function(p) SaveSnapshot(p) end, namespace["path"])
+    if success == false then
+        printf("Failed to save snapshot: %s", err)
+        return
+    end
+    printf("Snapshot saved to %s", namespace["path"])
+end
\ No newline at end of file
@@ -0,0 +1,70 @@
+strings = {
+    iscommand=true;
+    alias={"strings"};
+    help="usage: strings [filter] [-n min] [-e encoding] [-r address] [--start address] [--end address] [-l limit]";
+    valid_encodings={"all", "ascii", "utf16"};
+}
+
+function strings:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("strings", "list ascii & utf-16 strings in committed memory", false)
+    parser:AddArgument("filter", "only show strings containing this text", false, "store", nil)
+    parser:AddArgument({"-n", "--min"}, "minimum string length (default 4)", false, "store", math.tointeger)
+    parser:AddArgument({"-e", "--encoding"}, "all (default), ascii or utf16", false, "store", nil)
+    parser:AddArgument({"-r", "--region"}, "only show strings in the region containing this address", false, "store", Evaluate)
+    parser:AddArgument("--start", "only show strings at or after this address", false, "store", Evaluate)
+    parser:AddArgument("--end", "only show strings before this address", false, "store", Evaluate)
+    parser:AddArgument({"-l", "--limit"}, "maximum number of strings to display (default 256)", false, "store", math.tointeger)
+    return parser:ParseArgs(args)
+end
+
+function strings:command(args)
+    local namespace = strings:parseargs(args)
+    if namespace == nil then return end
+
+    local encoding = namespace["--encoding"] or "all"
+    if table.indexOf(strings.valid_encodings, encoding) == nil then
+        printf("Unknown encoding %s, expected one of: %s", encoding, table.concat(strings.valid_encodings, ", "))
+        return
+    end
+
+    local limit = namespace["--limit"] or 256
+    local query = {start=namespace["--start"], ["end"]=namespace["--end"], contains=namespace["filter"], limit=limit + 1}
+    if namespace["--region"] ~= nil then
+        local region = RegionOf(namespace["--region"])
+        if region == nil then
+            printf("%s is not in a committed region", address2hex(namespace["--region"]))
+            return
+        end
+        query.start = region.baseaddress
+        query["end"] = region.baseaddress + region.size
+    end
+
+    local success, found, stats = pcall(function() return FindStrings(namespace["--min"] or 4, encoding, query) end)
+    if success == false then
+        printf("Failed to find strings: %s", found)
+        return
+    end
+    if stats ~= nil and stats.cancelled then
+        print("Scan cancelled, the index only covers the memory scanned so far")
+    end
+
+    local addresses = {}
+    for i = 1, math.min(#found, limit) do
+        addresses[i] = found[i].address
+    end
+    local regions = RegionsOf(addresses)
+    for i = 1, math.min(#found, limit) do
+        local tag = ""
+        if found[i].encoding == "utf16" then tag = "L" end
+        printf("%s%s%s %s%s\"%s\"%s", info:get_region_colour(regions[i]), address2hex(found[i].address), colour.DEFAULT, tag, colour.GREEN, found[i].string, colour.DEFAULT)
+    end
+    if #found > limit then
+        printf("... more than %d strings, use -l to show more", limit)
+    end
+    if stats ~= nil then
+        printf("%d strings (indexed: %s)", math.min(#found, limit), search:stats2str(stats))
+    else
+        printf("%d strings", math.min(#found, limit))
+    end
+end
\ No newline at end of file
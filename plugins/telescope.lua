@@ -0,0 +1,40 @@
+telescope = {
+    iscommand=true;
+    alias={"telescope", "tel"};
+    help="usage: telescope [address] [-c count] [-d depth]";
+}
+
+function telescope:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("telescope", "display pointer sized values at an address and the pointer chains they lead to", false)
+    parser:AddArgument("address", "address to start at (default: stack pointer)", false, "store", Evaluate)
+    parser:AddArgument({"-c", "--count"}, "number of values to display (default 8)", false, "store", math.tointeger)
+    parser:AddArgument({"-d", "--depth"}, "maximum number of pointers to follow per value (default 4)", false, "store", math.tointeger)
+    return parser:ParseArgs(args)
+end
+
+function telescope:command(args)
+    local namespace = telescope:parseargs(args)
+    if namespace == nil then return end
+
+    local ptr_size = 4
+    local address = namespace["address"]
+    if Is64BitTarget() then
+        ptr_size = 8
+        if address == nil then address = GetContext64().rsp end
+    elseif address == nil then
+        address = GetContext32().esp
+    end
+
+    local count = namespace["--count"] or 8
+    local depth = namespace["--depth"] or 4
+    local success, entries = pcall(function() return Telescope(address, count, depth) end)
+    if success == false then
+        printf("Failed to read memory at %s: %s", address2hex(address), entries)
+        return
+    end
+
+    for i, entry in ipairs(entries) do
+        printf("%02x:%04x| %s0x%x%s : %s", i - 1, (i - 1)*ptr_size, colour.YELLOW, entry.address, colour.DEFAULT, info:get_chain_str(entry.hops))
+    end
+end
\ No newline at end of file
@@ -0,0 +1,48 @@
+thread = {
+    iscommand=true;
+    alias={"thread"};
+    help="usage: thread [id]"
+}
+
+function thread:parseargs(args)
+    local parser = ArgumentParser;
+    parser:init("thread", "list the target's threads or switch to one (e.g. another thread saved in a dump)", false)
+    parser:AddArgument("id", "thread to switch to", false, "store", tonumber)
+    return parser:ParseArgs(args)
+end
+
+function thread:command(args)
+    local namespace = thread:parseargs(args)
+    if namespace == nil then return end
+
+    local id = namespace["id"]
+    if id == nil then
+        local threads = GetThreads()
+        if #threads == 0 then
+            print("Target only reports the current thread")
+            return
+        end
+        local current = thread.current_index(threads)
+        for i, tid in ipairs(threads) do
+            printf("%s%d", i == current and "* " or "  ", tid)
+        end
+        return
+    end
+
+    local success, err = pcall(function(t) SetThread(t) end, id)
+    if success == false then
+        printf("Failed to switch thread: %s", err)
+        return
+    end
+    thread.current = id
+    info.displayed = false
+    printf("Switched to thread %d", id)
+end
+
+-- Index of the selected thread, the first one until `thread <id>` picks another
+function thread.current_index(threads)
+    for i, tid in ipairs(threads) do
+        if tid == thread.current then return i end
+    end
+    return 1
+end
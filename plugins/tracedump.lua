@@ -0,0 +1,28 @@
+tracedump = {
+    iscommand=true;
+    alias={"tracedump"};
+    help="usage: tracedump <id> <path> [-b]";
+}
+
+function tracedump:parseargs(args)
+    local parser = ArgumentParser
+    parser:init("tracedump", "write the records of a tracepoint to a csv (or binary) file", false)
+    parser:AddArgument("id", "tracepoint id", true, "store", math.tointeger)
+    parser:AddArgument("path", "output file", true, "store", nil)
+    parser:AddArgument({"-b", "--binary"}, "write the compact binary format instead of csv", false, "store_true", nil)
+    return parser:ParseArgs(args)
+end
+
+function tracedump:command(args)
+    local namespace = tracedump:parseargs(args)
+    if namespace == nil then return end
+
+    local format = "csv"
+    if namespace["--binary"] then format = "binary" end
+    local success, records = pcall(function() return TracepointDump(namespace["id"], namespace["path"], format) end)
+    if success == false then
+        printf("Failed to dump tracepoint: %s", records)
+        return
+    end
+    printf("Wrote %d records to %s", records, namespace["path"])
+end
\ No newline at end of file
@@ -0,0 +1,38 @@
+tracepoint = {
+    iscommand=true;
+    alias={"tracepoint","tp"};
+    help="usage: tracepoint <address> <fields> [-n capacity] [-c condition]";
+}
+
+function tracepoint:parseargs(args)
+    local parser = ArgumentParser
+    parser:init("tracepoint", "record comma separated fields (e.g. \"rcx, rdx, dword [rsp+28]\") on every hit without stopping", false)
+    parser:AddArgument("address", "tracepoint address", true, "store", Evaluate)
+    parser:AddArgument("fields", "registers & memory to record, same syntax as breakpoint conditions", true, "store", nil)
+    parser:AddArgument({"-n", "--capacity"}, "records to keep, the oldest are overwritten (default 65536)", false, "store", math.tointeger)
+    parser:AddArgument({"-c", "--condition"}, "only record hits where this is non zero", false, "store", nil)
+    return parser:ParseArgs(args)
+end
+
+function tracepoint:command(args)
+    local namespace = tracepoint:parseargs(args)
+    if namespace == nil then return end
+
+    local address = namespace["address"]
+    local success, bpid = pcall(function() return TracepointAdd(address, namespace["fields"], namespace["--capacity"]) end)
+    if success == false then
+        printf("Failed to add tracepoint: %s", bpid)
+        return
+    end
+
+    local condition = namespace["--condition"]
+    if condition ~= nil then
+        local ok, err = pcall(function() BreakpointSetCondition(bpid, condition) end)
+        if ok == false then
+            BreakpointRemove(bpid)
+            printf("Invalid condition: %s", err)
+            return
+        end
+    end
+    printf("Tracepoint %d set @ 0x%x recording %s", bpid, address, namespace["fields"])
+end
\ No newline at end of file
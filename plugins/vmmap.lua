@@ -39,48 +39,35 @@ function vmmap:command(args)
     local namespace = vmmap:parseargs(args)
     if namespace == nil then return end
     
-    local regions = GetVMRegions()
+    local regions = {}
     -- `vmmap [address]`
     local address = namespace["address"]
     if address ~= nil then
-        local found = false
-        for i, region in pairs(regions) do
-            if (address >= region.baseaddress) and (address < region.baseaddress + region.size) then
-                found = true
-                if i == 0 then
-                    regions = {regions[i], regions[i+1]}
-                    break
-                else
-                    regions = {regions[i-1], regions[i], regions[i+1]}
-                    break
-                end
-            end
-        end
-
-        if found == false then
+        local region = RegionOf(address)
+        if region == nil then
             print("Could not find region with specified address")
             return
         end
+        -- neighbours, if they're committed
+        regions[#regions + 1] = RegionOf(region.baseaddress - 1)
+        regions[#regions + 1] = region
+        regions[#regions + 1] = RegionOf(region.baseaddress + region.size)
+    else
+        local bases = {}
+        for i, region in pairs(GetVMRegions()) do
+            bases[i] = region.baseaddress
+        end
+        regions = RegionsOf(bases)
     end
 
     -- legend
     printf("LEGEND: " .. colour.YELLOW .. "STACK" .. colour.DEFAULT .. " | " .. colour.RED .. "CODE" .. colour.DEFAULT .. " | " .. colour.MAGENTA .. "DATA" .. colour.DEFAULT .. " | " .. colour.RED .. colour.UNDERLINE .. "RWX" .. colour.DEFAULT .. " | " .. "RODATA")
 
     printf("%s\t%s %s %s %s", string.lpad("Start", 18, " "), string.lpad("End", 18, " "), string.lpad("Prot", 6, " "), string.lpad("Size", 8, " "), "Name")
-    -- To grab the stack we need to know what page range stack pointer is in
-    local ctx;
-    local sp;
-    if info.targetis64bit then
-        ctx = GetContext64()
-        sp = ctx.rsp
-    else
-        ctx = GetContext32()
-        sp = ctx.esp
-    end
     for i, region in pairs(regions) do
         -- Do the color first. The color depends on the protections of the page
         local _colour;
-        if ((sp > region.baseaddress) and (sp < (region.baseaddress + region.size))) then
+        if region.kind == "stack" then
             _colour = colour.YELLOW
         else
             -- TODO: if there's an RWX page, this underlines the entire line of output
@@ -92,9 +79,9 @@ function vmmap:command(args)
         local prot_str = string.lpad(memory:prot2str(region.protections), 6, " ")
         local size_str = string.lpad(string.format("%x", region.size), 8, " ")
 
-        local success, name = pcall(function(a) return AddressToModuleName(a) end, region.baseaddress)
-        if success == false then
-            name = ""
+        local name = region.module
+        if region.kind == "stack" or region.kind == "heap" then
+            name = "[" .. region.kind .. "]"
         end
 
         printf("%s%s\t%s %s %s %s%s", _colour, base_str, end_str, prot_str, size_str, name, colour.DEFAULT)
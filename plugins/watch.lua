@@ -0,0 +1,58 @@
+watch = {
+    iscommand=true;
+    alias={"watch"};
+    help="usage: watch <address> [-s size] [-x] [--changed] [-c condition]";
+}
+
+function watch:parseargs(args)
+    local parser = ArgumentParser
+    parser:init("watch", "stop when memory is written with a hardware data breakpoint (at most 4)", false)
+    parser:AddArgument("address", "address to watch, aligned to size", true, "store", Evaluate)
+    parser:AddArgument({"-s", "--size"}, "bytes watched: 1, 2, 4 or 8 (default pointer size)", false, "store", math.tointeger)
+    parser:AddArgument({"-x", "--execute"}, "stop when the address executes instead", false, "store_true", nil)
+    parser:AddArgument("--changed", "only stop when the written value differs from the last one", false, "store_true", nil)
+    parser:AddArgument({"-c", "--condition"}, "only stop when this is non zero", false, "store", nil)
+    return parser:ParseArgs(args)
+end
+
+---Add a data breakpoint & its condition, shared with rwatch
+---@param namespace table
+---@param access string
+function watch:add(namespace, access)
+    local address = namespace["address"]
+    local size = namespace["--size"]
+    if access == "execute" then size = 1 end
+    local success, bpid, created = pcall(function() return WatchAdd(address, size, access, namespace["--changed"]) end)
+    if success == false then
+        printf("Failed to add watch: %s", bpid)
+        return
+    end
+
+    local condition = namespace["--condition"]
+    if condition ~= nil then
+        local ok, err = pcall(function() BreakpointSetCondition(bpid, condition) end)
+        if ok == false then
+            -- A watch that was already there is left as it was
+            if created then BreakpointRemove(bpid) end
+            printf("Invalid condition: %s", err)
+            return
+        end
+    end
+    if not created and condition ~= nil then
+        printf("Watch %d @ 0x%x (%s) already set, condition replaced with %s", bpid, address, access, condition)
+        return
+    elseif not created then
+        printf("Watch %d @ 0x%x (%s) already set", bpid, address, access)
+        return
+    end
+    printf("Watch %d set @ 0x%x (%s)", bpid, address, access)
+end
+
+function watch:command(args)
+    local namespace = watch:parseargs(args)
+    if namespace == nil then return end
+
+    local access = "write"
+    if namespace["--execute"] then access = "execute" end
+    watch:add(namespace, access)
+end
\ No newline at end of file
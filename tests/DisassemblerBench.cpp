@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "Disassembler.hpp"
+
+using gdbw::Disassembler;
+using gdbw::InstructionBatch;
+
+// Timing only, not run by ctest. Compares a capstone handle opened per call (the Disassembler before
+// it kept its handles) against the persistent handle, with the decoded instruction cache cold & warm.
+
+// x86-64 prologue, body & epilogue, 23 instructions. Every call decodes all of it, about what
+// the prompt disassembles after each stop.
+static const uint8_t Corpus[] = {
+	0x55,                                     // push rbp
+	0x48, 0x89, 0xe5,                         // mov rbp, rsp
+	0x41, 0x57,                               // push r15
+	0x41, 0x56,                               // push r14
+	0x53,                                     // push rbx
+	0x48, 0x83, 0xec, 0x28,                   // sub rsp, 0x28
+	0x48, 0x89, 0x7d, 0xd8,                   // mov [rbp-0x28], rdi
+	0x89, 0x75, 0xd4,                         // mov [rbp-0x2c], esi
+	0x48, 0x8b, 0x45, 0xd8,                   // mov rax, [rbp-0x28]
+	0x48, 0x8d, 0x15, 0x00, 0x00, 0x00, 0x00, // lea rdx, [rip]
+	0xe8, 0x00, 0x00, 0x00, 0x00,             // call
+	0x85, 0xc0,                               // test eax, eax
+	0x74, 0x0a,                               // je
+	0x0f, 0xb6, 0x04, 0x0a,                   // movzx eax, byte [rdx+rcx]
+	0xc5, 0xf8, 0x77,                         // vzeroupper
+	0xf3, 0x0f, 0x6f, 0x06,                   // movdqu xmm0, [rsi]
+	0x66, 0x0f, 0xef, 0xc1,                   // pxor xmm0, xmm1
+	0x48, 0x83, 0xc4, 0x28,                   // add rsp, 0x28
+	0x5b,                                     // pop rbx
+	0x41, 0x5e,                               // pop r14
+	0x41, 0x5f,                               // pop r15
+	0x5d,                                     // pop rbp
+	0xc3,                                     // ret
+};
+static constexpr size_t CorpusInstructions = 23;
+
+template <typename F>
+static void Time(const char* name, size_t iterations, F fn)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+		fn();
+	auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-28s %10.0f ns/call %8.1f ns/insn\n", name, elapsed / iterations, elapsed / iterations / CorpusInstructions);
+}
+
+int main(int argc, char** argv)
+{
+	size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+
+	Time("cs_open per call", iterations, []() {
+		csh handle;
+		cs_insn* insn;
+		if (cs_open(CS_ARCH_X86, CS_MODE_64, &handle) != CS_ERR_OK)
+			std::exit(1);
+		size_t count = cs_disasm(handle, Corpus, sizeof(Corpus), 0x1000, 0, &insn);
+		if (count != CorpusInstructions)
+			std::exit(1);
+		cs_free(insn, count);
+		cs_close(&handle);
+	});
+
+	Disassembler disassembler(CS_ARCH_X86, CS_MODE_64);
+	InstructionBatch batch;
+	Time("persistent handle", iterations, [&]() {
+		disassembler.GetCache()->Flush();
+		batch.Clear();
+		auto decoded = disassembler.Disasm(Corpus, sizeof(Corpus), 0, batch);
+		if (!decoded || *decoded != CorpusInstructions)
+			std::exit(1);
+	});
+	Time("persistent handle, cached", iterations, [&]() {
+		batch.Clear();
+		auto decoded = disassembler.Disasm(Corpus, sizeof(Corpus), 0, batch);
+		if (!decoded || *decoded != CorpusInstructions)
+			std::exit(1);
+	});
+	return 0;
+}
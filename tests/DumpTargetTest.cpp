@@ -0,0 +1,92 @@
+#include <filesystem>
+#include <fstream>
+#include "DumpTarget.hpp"
+#include "Test.hpp"
+
+using gdbw::DumpTarget;
+
+template <typename T>
+static void Patch(std::vector<uint8_t>& data, size_t offset, T value)
+{
+	memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+static void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write((const char*)data.data(), data.size());
+}
+
+static uint64_t Rip(DumpTarget& target)
+{
+	auto registers = target.GetRegisters(gdbw::DE::RegisterSet::GP64);
+	CHECK(registers);
+	return registers->values[6];
+}
+
+// Minidump with a system info stream, three threads & optionally an exception in the second one
+static std::vector<uint8_t> Minidump(bool exception)
+{
+	static constexpr uint32_t ContextSize = 0x4D0;
+	static constexpr uint32_t RipOffset = 0xF8;
+	std::vector<uint8_t> data(0x1600);
+	Patch<uint32_t>(data, 0, 0x504D444D);
+	Patch<uint32_t>(data, 8, exception ? 3 : 2);
+	Patch<uint32_t>(data, 12, 32);
+
+	// Directory: type, size, rva
+	uint32_t directory[][3] = { { 7, 4, 68 }, { 3, 4 + 3 * 48, 72 }, { 6, 168, 220 } };
+	memcpy(data.data() + 32, directory, sizeof(directory));
+	Patch<uint16_t>(data, 68, 9); // amd64
+
+	// Thread list, the faulting thread's context is somewhere in exception dispatch
+	Patch<uint32_t>(data, 72, 3);
+	uint32_t ids[] = { 10, 20, 30 };
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		size_t thread = 76 + i * 48;
+		uint32_t context = 0x200 + i * 0x500;
+		Patch<uint32_t>(data, thread, ids[i]);
+		Patch<uint32_t>(data, thread + 40, ContextSize);
+		Patch<uint32_t>(data, thread + 44, context);
+		Patch<uint64_t>(data, context + RipOffset, ids[i] == 20 ? 0x2020 : 0x1000 + ids[i]);
+	}
+
+	// Exception in thread 20, with the context at the fault
+	Patch<uint32_t>(data, 220, 20);
+	Patch<uint32_t>(data, 220 + 160, ContextSize);
+	Patch<uint32_t>(data, 220 + 164, 0x1100);
+	Patch<uint64_t>(data, 0x1100 + RipOffset, 0xE20);
+	return data;
+}
+
+int main()
+{
+	std::string path = (std::filesystem::temp_directory_path() / "gdbw_dump_test.dmp").string();
+
+	// Faulting thread first with the exception's context, every other thread is kept
+	{
+		WriteFile(path, Minidump(true));
+		DumpTarget target;
+		CHECK(target.Open(path));
+		CHECK((target.GetThreads() == std::vector<uint32_t>{ 20, 10, 30 }));
+		CHECK(Rip(target) == 0xE20);
+		CHECK(target.SetThread(30) && Rip(target) == 0x101E);
+		CHECK(target.SetThread(10) && Rip(target) == 0x100A);
+		CHECK(target.SetThread(20) && Rip(target) == 0xE20);
+		CHECK(!target.SetThread(99) && Rip(target) == 0xE20);
+	}
+
+	// Without an exception the first thread is current
+	{
+		WriteFile(path, Minidump(false));
+		DumpTarget target;
+		CHECK(target.Open(path));
+		CHECK((target.GetThreads() == std::vector<uint32_t>{ 10, 20, 30 }));
+		CHECK(Rip(target) == 0x100A);
+		CHECK(target.SetThread(20) && Rip(target) == 0x2020);
+	}
+
+	std::filesystem::remove(path);
+	return 0;
+}
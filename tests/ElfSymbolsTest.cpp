@@ -0,0 +1,81 @@
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "ElfSymbols.hpp"
+#include "Test.hpp"
+
+using gdbw::ElfSymbols;
+using gdbw::SymbolCache;
+
+// Write a relocatable ELF holding only a .symtab of `count` one byte functions at 0x1000 + i, named "f<i>"
+static std::string WriteImage(size_t count)
+{
+	std::string strings(1, '\0');
+	std::vector<Elf64_Sym> syms(1);
+	for (size_t i = 0; i < count; i++)
+	{
+		Elf64_Sym sym = { 0 };
+		sym.st_name = (uint32_t)strings.size();
+		sym.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+		sym.st_shndx = 1;
+		sym.st_value = 0x1000 + i;
+		sym.st_size = 1;
+		syms.push_back(sym);
+		strings += "f" + std::to_string(i);
+		strings.push_back('\0');
+	}
+
+	Elf64_Ehdr ehdr = { 0 };
+	memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+	ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+	ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+	ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+	ehdr.e_type = ET_REL;
+	ehdr.e_machine = EM_X86_64;
+	ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+	ehdr.e_shentsize = sizeof(Elf64_Shdr);
+	ehdr.e_shnum = 3;
+	ehdr.e_shoff = sizeof(Elf64_Ehdr);
+
+	Elf64_Shdr shdrs[3] = { 0 };
+	shdrs[1].sh_type = SHT_SYMTAB;
+	shdrs[1].sh_offset = sizeof(Elf64_Ehdr) + sizeof(shdrs);
+	shdrs[1].sh_size = syms.size() * sizeof(Elf64_Sym);
+	shdrs[1].sh_link = 2;
+	shdrs[1].sh_entsize = sizeof(Elf64_Sym);
+	shdrs[2].sh_type = SHT_STRTAB;
+	shdrs[2].sh_offset = shdrs[1].sh_offset + shdrs[1].sh_size;
+	shdrs[2].sh_size = strings.size();
+
+	std::string path = "ElfSymbolsTest." + std::to_string(getpid()) + ".o";
+	std::ofstream file(path, std::ios::binary);
+	file.write((const char*)&ehdr, sizeof(ehdr));
+	file.write((const char*)shdrs, sizeof(shdrs));
+	file.write((const char*)syms.data(), shdrs[1].sh_size);
+	file.write(strings.data(), strings.size());
+	return path;
+}
+
+int main()
+{
+	// An image's whole table is kept, even past the point a SymbolCache would flush
+	size_t count = SymbolCache::MaxNames + 1;
+	auto path = WriteImage(count);
+	ElfSymbols symbols;
+	auto loaded = symbols.Load(path, 0);
+	unlink(path.c_str());
+	CHECK(loaded);
+	CHECK(symbols.Size() == count);
+
+	auto first = symbols.Lookup(0x1000);
+	CHECK(first && first->Address() == 0x1000 && strcmp(first->Name(), "f0") == 0);
+	auto last = symbols.Lookup(0x1000 + count - 1);
+	CHECK(last && last->Displacement() == 0 && last->Name() == "f" + std::to_string(count - 1));
+	CHECK(!symbols.Lookup(0x1000 + count));
+	CHECK(!symbols.Lookup(0xfff));
+	CHECK(symbols.FromName("f1234") == 0x1000 + 1234);
+	return 0;
+}
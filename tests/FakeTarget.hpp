@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "Target.hpp"
+
+// In memory target for tests. Regions are served from their data, a region without data can't be
+// read and `readlimit` bytes into a region reads start failing (0 means no limit).
+class FakeTarget : public gdbw::Target
+{
+public:
+	struct Region
+	{
+		gdbw::TargetRegion info;
+		std::vector<uint8_t> data;
+		uint64_t readlimit = 0;
+	};
+
+	std::expected<uint32_t, std::string> ReadMemory(uint64_t address, uint32_t len, void* out) override
+	{
+		reads++;
+		Region* region = Find(address);
+		if (!region || region->data.empty())
+			return std::unexpected("FakeTarget no memory");
+		uint64_t offset = address - region->info.baseaddress;
+		uint64_t end = region->readlimit ? region->readlimit : region->info.size;
+		if (offset >= end)
+			return std::unexpected("FakeTarget read failed");
+		uint32_t count = (uint32_t)std::min<uint64_t>(len, end - offset);
+		memcpy(out, region->data.data() + offset, count);
+		return count;
+	}
+
+	std::expected<uint32_t, std::string> WriteMemory(uint64_t address, uint32_t len, const void* in) override
+	{
+		Region* region = Find(address);
+		if (!region || region->data.empty())
+			return std::unexpected("FakeTarget no memory");
+		uint64_t offset = address - region->info.baseaddress;
+		uint32_t count = (uint32_t)std::min<uint64_t>(len, region->info.size - offset);
+		memcpy(region->data.data() + offset, in, count);
+		return count;
+	}
+
+	std::expected<std::vector<gdbw::TargetRegion>, std::string> GetRegions(void) override
+	{
+		std::vector<gdbw::TargetRegion> infos;
+		for (auto& region : regions)
+			infos.push_back(region.info);
+		return infos;
+	}
+
+	std::expected<gdbw::DE::RegisterContext, std::string> GetRegisters(gdbw::DE::RegisterSet set) override
+	{
+		gdbw::DE::RegisterContext context = { set, 0, nullptr, { 0 } };
+		context.count = gdbw::DE::GetRegisterSetNames(set, &context.names);
+		for (size_t i = 0; i < context.count; i++)
+			context.values[i] = 0x1000 + i;
+		return context;
+	}
+
+	std::expected<std::vector<gdbw::TargetModule>, std::string> GetModules(void) override { return modules; }
+	bool Is64Bit(void) override { return true; }
+
+	// Add a region filled with a pattern derived from its address
+	Region& AddRegion(uint64_t base, uint64_t size, bool readable = true)
+	{
+		Region region = { { base, base, size, 0x04, 0x1000, 0x20000 }, {} };
+		if (readable)
+		{
+			region.data.resize(size);
+			for (uint64_t i = 0; i < size; i++)
+				region.data[i] = (uint8_t)((base + i) * 7 >> 3);
+		}
+		regions.push_back(std::move(region));
+		return regions.back();
+	}
+
+	std::vector<Region> regions; // sorted by base address
+	std::vector<gdbw::TargetModule> modules;
+	size_t reads = 0;
+private:
+	Region* Find(uint64_t address)
+	{
+		for (auto& region : regions)
+			if (address >= region.info.baseaddress && address - region.info.baseaddress < region.info.size)
+				return &region;
+		return nullptr;
+	}
+};
@@ -0,0 +1,68 @@
+#include "GdbRemoteTarget.hpp"
+#include "RspStub.hpp"
+#include "Test.hpp"
+
+using gdbw::GdbRemoteTarget;
+
+static void CheckMemory(GdbRemoteTarget& target, const RspStub& stub, uint64_t address, uint32_t len)
+{
+	std::vector<uint8_t> data(len);
+	auto read = target.ReadMemory(address, len, data.data());
+	CHECK(read && *read == len);
+	CHECK(memcmp(data.data(), stub.Memory().data() + (address - RspStub::Base), len) == 0);
+}
+
+int main()
+{
+	// Ack mode, the stub NAKs the first reads & every one must be resent before the next is sent
+	{
+		RspStub stub({ .noack = false, .naks = 3 });
+		GdbRemoteTarget target;
+		CHECK(target.Connect("127.0.0.1", stub.Port()));
+
+		CheckMemory(target, stub, RspStub::Base + 0x10, 0x1000);
+		CHECK(stub.Naks() == 3 && stub.Resent() == 3);
+
+		auto regions = target.GetRegions();
+		CHECK(regions && regions->size() == 1);
+		CHECK((*regions)[0].baseaddress == RspStub::Base && (*regions)[0].size == RspStub::Size);
+
+		auto registers = target.GetRegisters(gdbw::DE::RegisterSet::GP64);
+		CHECK(registers && registers->values[6] == RspStub::Entry && registers->values[0] == 0x1000);
+
+		uint8_t bytes[] = { 0x90, 0x90 };
+		auto written = target.WriteMemory(RspStub::Base + 0x20, sizeof(bytes), bytes);
+		CHECK(written && *written == sizeof(bytes));
+		CheckMemory(target, stub, RspStub::Base + 0x20, sizeof(bytes));
+
+		// Step over a call: run to the return address with a temporary breakpoint
+		auto stop = target.RunTo(RspStub::Entry + 5);
+		CHECK(stop && *stop == 5);
+		registers = target.GetRegisters(gdbw::DE::RegisterSet::GP64);
+		CHECK(registers && registers->values[6] == RspStub::Entry + 5);
+		CHECK(stub.Breakpoints().empty());
+
+		// A user breakpoint at the return address survives a RunTo to it
+		auto id = target.SetBreakpoint(RspStub::Entry + 0x10);
+		CHECK(id);
+		stop = target.RunTo(RspStub::Entry + 0x10);
+		CHECK(stop && *stop == 5 && stub.Breakpoints().size() == 1);
+		CHECK(target.ClearBreakpoint(*id));
+
+		auto exited = target.Continue();
+		CHECK(exited && *exited == -1);
+	}
+
+	// No-ack mode, a large read is pipelined
+	{
+		RspStub stub({ .noack = true });
+		GdbRemoteTarget target;
+		CHECK(target.Connect("127.0.0.1", stub.Port()));
+		uint64_t sent = target.PacketsSent();
+		CheckMemory(target, stub, RspStub::Base, (uint32_t)RspStub::Size);
+		// 0x400 byte packets carry 0x1f8 bytes of memory each
+		CHECK(target.PacketsSent() - sent == (RspStub::Size + 0x1f7) / 0x1f8);
+		CHECK(!target.ReadMemory(RspStub::Base + RspStub::Size, 0x10, nullptr));
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "LinuxTarget.hpp"
+#include "Test.hpp"
+
+using gdbw::LinuxTarget;
+
+// The test runs itself as the debuggee (`LinuxTargetTest child`), these are found through its ELF symbols
+extern "C" __attribute__((noinline)) void HandlerBreak(void) { asm volatile(""); }
+
+static std::atomic<int> g_started;
+
+static void StartThreads(void)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		std::thread([]() {
+			g_started++;
+			while (true)
+				pause();
+		}).detach();
+	}
+	while (g_started != 2)
+		std::this_thread::yield();
+}
+
+static int Child(void)
+{
+	signal(SIGUSR1, [](int) { HandlerBreak(); });
+	StartThreads();
+	raise(SIGUSR1);
+	// Skips exit time checks (e.g. leak detection) that don't expect to be traced
+	_exit(0);
+}
+
+static uint64_t Rip(LinuxTarget& target)
+{
+	auto registers = target.GetRegisters(gdbw::DE::RegisterSet::GP64);
+	CHECK(registers);
+	return registers->values[6];
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "child") == 0)
+		return Child();
+
+	// Launch, threads started by the process are traced & a signal stopped on is delivered when
+	// stepping off a breakpoint
+	{
+		LinuxTarget target;
+		CHECK(target.Launch({ argv[0], "child" }));
+		CHECK(target.GetThreads().size() == 1);
+		// Maps are parsed once per stop, the libraries & thread stacks mapped while running show up after it
+		auto regions = target.GetRegions();
+		CHECK(regions && target.GetRegions()->size() == regions->size());
+
+		auto stop = target.Continue();
+		CHECK(stop && *stop == SIGUSR1);
+		CHECK(target.GetThreads().size() == 3);
+		CHECK(target.GetRegions()->size() > regions->size());
+		CHECK(target.GetThreads()[0] == (uint32_t)target.Pid());
+
+		auto handler = target.SymbolFromName("HandlerBreak");
+		CHECK(handler && strcmp(handler->Name(), "HandlerBreak") == 0);
+		uint64_t raised = Rip(target);
+		auto here = target.SetBreakpoint(raised);
+		auto inhandler = target.SetBreakpoint(handler->Address());
+		CHECK(here && inhandler);
+
+		stop = target.Continue();
+		CHECK(stop && *stop == SIGTRAP && Rip(target) == handler->Address());
+		// Back where the signal was raised once the handler returns
+		stop = target.Continue();
+		CHECK(stop && *stop == SIGTRAP && Rip(target) == raised);
+
+		CHECK(target.ClearBreakpoint(*here) && target.ClearBreakpoint(*inhandler));
+		stop = target.Continue();
+		CHECK(stop && *stop == -1);
+	}
+
+	// Attach, every thread already running is stopped & traced
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			StartThreads();
+			while (true)
+				pause();
+		}
+		auto tasks = std::format("/proc/{}/task", pid);
+		while (std::distance(std::filesystem::directory_iterator(tasks), std::filesystem::directory_iterator()) != 3)
+			std::this_thread::yield();
+
+		{
+			LinuxTarget target;
+			CHECK(target.Attach(pid));
+			auto threads = target.GetThreads();
+			CHECK(threads.size() == 3 && threads[0] == (uint32_t)pid);
+			CHECK(target.SetThread(threads[2]));
+			CHECK(target.GetThreads()[0] == threads[2]);
+			CHECK(Rip(target) != 0);
+			CHECK(!target.SetThread(0));
+			CHECK(target.Detach());
+		}
+		kill(pid, SIGKILL);
+		waitpid(pid, nullptr, 0);
+	}
+	return 0;
+}
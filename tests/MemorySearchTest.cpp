@@ -0,0 +1,38 @@
+#include <cstring>
+#include <vector>
+#include "MemorySearch.hpp"
+#include "Test.hpp"
+
+using gdbw::BytePattern;
+
+// Offsets `pattern` matches at in `data`
+static std::vector<uint64_t> Find(const BytePattern& pattern, const std::vector<uint8_t>& data)
+{
+	std::vector<uint64_t> matches;
+	pattern.Scan(data.data(), data.size(), 0, 1, 0, matches);
+	return matches;
+}
+
+int main()
+{
+	// "aé€😀" in UTF-16LE, the emoji as a surrogate pair
+	const std::vector<uint8_t> wide = { 0x61, 0x00, 0xE9, 0x00, 0xAC, 0x20, 0x3D, 0xD8, 0x00, 0xDE };
+	std::vector<uint8_t> data(5, 0xCC);
+	data.insert(data.end(), wide.begin(), wide.end());
+
+	auto pattern = BytePattern::FromWide("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+	CHECK(pattern && pattern->Size() == wide.size());
+	CHECK(Find(*pattern, data) == std::vector<uint64_t>{ 5 });
+
+	// Non-ASCII is no longer zero extended byte by byte
+	auto accent = BytePattern::FromWide("\xC3\xA9");
+	CHECK(accent && accent->Size() == 2 && Find(*accent, data) == std::vector<uint64_t>{ 7 });
+
+	// Truncated, stray continuation, overlong, surrogate & out of range sequences are refused
+	CHECK(!BytePattern::FromWide("\xC3"));
+	CHECK(!BytePattern::FromWide("\x80"));
+	CHECK(!BytePattern::FromWide("\xC0\xAF"));
+	CHECK(!BytePattern::FromWide("\xED\xA0\x80"));
+	CHECK(!BytePattern::FromWide("\xF4\x90\x80\x80"));
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "FakeTarget.hpp"
+#include "PageCache.hpp"
+#include "Test.hpp"
+
+using gdbw::PageCache;
+
+int main()
+{
+	FakeTarget target;
+	target.AddRegion(0x10000, 0x10000);
+	target.AddRegion(0x20000, 0x1000, false);
+	// Readable for the first page and a half only
+	target.AddRegion(0x30000, 0x4000).readlimit = 0x1800;
+
+	PageCache cache([&](uint64_t address, uint32_t len, void* out) { return target.ReadMemory(address, len, out); });
+	auto expect = [&](uint64_t address, const uint8_t* data, size_t len) {
+		return memcmp(data, target.regions[0].data.data() + (address - 0x10000), len) == 0;
+	};
+	uint8_t buffer[PageCache::MaxCachedRead + PageCache::PageSize] = { 0 };
+
+	// A miss fetches the page once, later reads of it are hits
+	auto read = cache.Read(0x10010, 0x20, buffer);
+	CHECK(read && *read == 0x20 && expect(0x10010, buffer, 0x20));
+	CHECK(target.reads == 1 && cache.Misses() == 1 && cache.Hits() == 0);
+	read = cache.Read(0x10800, 0x100, buffer);
+	CHECK(read && *read == 0x100 && expect(0x10800, buffer, 0x100));
+	CHECK(target.reads == 1 && cache.Hits() == 1);
+
+	// Several missing pages are fetched with one backend read, cached pages at the ends are trimmed
+	target.reads = 0;
+	read = cache.Read(0x10f00, 0x3200, buffer);
+	CHECK(read && *read == 0x3200 && expect(0x10f00, buffer, 0x3200));
+	CHECK(target.reads == 1 && cache.CachedPages() == 5);
+
+	// Reads run short at an unreadable page, and unreadable pages are remembered
+	target.reads = 0;
+	read = cache.Read(0x1ff00, 0x200, buffer);
+	CHECK(read && *read == 0x100 && expect(0x1ff00, buffer, 0x100));
+	CHECK(!cache.Read(0x20000, 0x10, buffer));
+	size_t reads = target.reads;
+	CHECK(!cache.Read(0x20010, 0x10, buffer));
+	CHECK(target.reads == reads);
+
+	// A short bulk fetch only keeps whole pages, the partial page is then marked page by page
+	read = cache.Read(0x30000, 0x3000, buffer);
+	CHECK(read && *read == 0x1000);
+	CHECK(memcmp(buffer, target.regions[2].data.data(), 0x1000) == 0);
+	CHECK(!cache.Read(0x31000, 0x10, buffer));
+
+	// Invalidate drops only the overlapping pages, Flush drops all
+	size_t pages = cache.CachedPages();
+	cache.Invalidate(0x10ff0, 0x20);
+	CHECK(cache.CachedPages() == pages - 2);
+	target.regions[0].data[0x1000] ^= 0xff;
+	read = cache.Read(0x11000, 1, buffer);
+	CHECK(read && buffer[0] == target.regions[0].data[0x1000]);
+	cache.Invalidate(0xfffffffffffff000, 0x1000); // no wrap at the top of the address space
+	cache.Flush();
+	CHECK(cache.CachedPages() == 0);
+
+	// Bulk reads go straight to the backend
+	target.reads = 0;
+	read = cache.Read(0x10000, PageCache::MaxCachedRead + 1, buffer);
+	CHECK(read && *read == 0x10000);
+	CHECK(target.reads == 1 && cache.CachedPages() == 0);
+	return 0;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal GDB remote serial protocol stub serving a fake x86-64 process over a loopback socket, for
+// testing GdbRemoteTarget. Memory is a single region of `Size` bytes at `Base`, execution is faked:
+// `s` steps into the call at Entry, `c` stops on the next breakpoint above rip or exits without one.
+class RspStub
+{
+public:
+	static constexpr uint64_t Base = 0x400000;
+	static constexpr uint64_t Size = 0x10000;
+	static constexpr uint64_t Entry = 0x401000;  // call 0x402000
+	static constexpr uint64_t Callee = 0x402000;
+
+	struct Options
+	{
+		bool noack = false;  // offer QStartNoAckMode
+		size_t naks = 0;     // NAK this many `m` packets (as if corrupted) before accepting them
+	};
+
+	RspStub(Options options) : m_options(options)
+	{
+#ifdef _WIN32
+		WSADATA wsadata = { 0 };
+		WSAStartup(MAKEWORD(2, 2), &wsadata);
+#endif
+		m_memory.resize(Size);
+		for (size_t i = 0; i < Size; i++)
+			m_memory[i] = (uint8_t)(i * 13 + (i >> 8));
+		uint8_t call[] = { 0xe8, 0xfb, 0x0f, 0x00, 0x00 };
+		memcpy(m_memory.data() + (Entry - Base), call, sizeof(call));
+		m_rip = Entry;
+
+		m_listener = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		bind(m_listener, (sockaddr*)&addr, sizeof(addr));
+		socklen_t len = sizeof(addr);
+		getsockname(m_listener, (sockaddr*)&addr, &len);
+		m_port = ntohs(addr.sin_port);
+		listen(m_listener, 1);
+		m_thread = std::thread([this]() { Serve(); });
+	}
+
+	~RspStub()
+	{
+		m_thread.join();
+		Close(m_listener);
+	}
+
+	inline uint16_t Port(void) const { return m_port; }
+	// Stub state, only read once the client has disconnected or while it waits for a reply
+	inline uint64_t Rip(void) const { return m_rip; }
+	inline size_t Naks(void) const { return m_naksent; }
+	inline size_t Resent(void) const { return m_resent; }
+	inline const std::set<uint64_t>& Breakpoints(void) const { return m_breakpoints; }
+	inline const std::vector<uint8_t>& Memory(void) const { return m_memory; }
+private:
+#ifdef _WIN32
+	using socket_t = SOCKET;
+	static void Close(socket_t s) { closesocket(s); }
+#else
+	using socket_t = int;
+	static void Close(socket_t s) { close(s); }
+#endif
+
+	void Serve(void)
+	{
+		socket_t client = accept(m_listener, nullptr, nullptr);
+		std::string buffer;
+		bool noack = false;
+		std::string lastnak;
+		while (true)
+		{
+			size_t start = buffer.find('$');
+			size_t end = start == std::string::npos ? std::string::npos : buffer.find('#', start);
+			if (end == std::string::npos || end + 2 >= buffer.size())
+			{
+				char data[0x1000];
+				int n = recv(client, data, sizeof(data), 0);
+				if (n <= 0)
+					break;
+				buffer.append(data, n);
+				continue;
+			}
+
+			std::string payload = buffer.substr(start + 1, end - start - 1);
+			buffer.erase(0, end + 3);
+			if (!noack)
+			{
+				if (!lastnak.empty() && payload == lastnak)
+					m_resent++;
+				lastnak.clear();
+				if (payload[0] == 'm' && m_naksent < m_options.naks)
+				{
+					m_naksent++;
+					lastnak = payload;
+					Send(client, "-");
+					continue;
+				}
+				Send(client, "+");
+			}
+
+			std::string reply = Handle(payload);
+			uint8_t checksum = 0;
+			for (char c : reply)
+				checksum += (uint8_t)c;
+			Send(client, std::format("${}#{:02x}", reply, checksum));
+			if (payload == "QStartNoAckMode")
+				noack = true;
+		}
+		Close(client);
+	}
+
+	std::string Handle(const std::string& packet)
+	{
+		if (packet.starts_with("qSupported"))
+			return std::string("PacketSize=400;qXfer:memory-map:read+") + (m_options.noack ? ";QStartNoAckMode+" : "");
+		if (packet == "QStartNoAckMode")
+			return "OK";
+		if (packet == "?")
+			return "S05";
+		if (packet.starts_with("qXfer:memory-map:read::"))
+			return std::format("l<memory-map><memory type=\"ram\" start=\"{:#x}\" length=\"{:#x}\"/></memory-map>", Base, Size);
+		if (packet == "g")
+		{
+			// 17 GP registers then eflags & the segments, rip is register 16
+			std::string hex;
+			for (uint64_t i = 0; i < 24; i++)
+				hex += Hex(i == 16 ? m_rip : 0x1000 + i, i < 17 ? 8 : 4);
+			return hex;
+		}
+		if (packet[0] == 'm' || packet[0] == 'M')
+		{
+			uint64_t address = strtoull(packet.c_str() + 1, nullptr, 16);
+			uint64_t len = strtoull(packet.c_str() + packet.find(',') + 1, nullptr, 16);
+			if (address < Base || address + len > Base + Size)
+				return "E01";
+			uint8_t* data = m_memory.data() + (address - Base);
+			if (packet[0] == 'm')
+				return Hex(data, len);
+			const char* hex = packet.c_str() + packet.find(':') + 1;
+			for (uint64_t i = 0; i < len; i++)
+				data[i] = (uint8_t)strtoul(std::string(hex + i * 2, 2).c_str(), nullptr, 16);
+			return "OK";
+		}
+		if (packet.starts_with("Z0,") || packet.starts_with("z0,"))
+		{
+			uint64_t address = strtoull(packet.c_str() + 3, nullptr, 16);
+			if (packet[0] == 'Z')
+				m_breakpoints.insert(address);
+			else
+				m_breakpoints.erase(address);
+			return "OK";
+		}
+		if (packet == "s")
+		{
+			m_rip = m_rip == Entry ? Callee : m_rip + 1;
+			return "T05";
+		}
+		if (packet == "c")
+		{
+			auto next = m_breakpoints.upper_bound(m_rip);
+			if (next == m_breakpoints.end())
+				return "W00";
+			m_rip = *next;
+			return "T05";
+		}
+		return "";
+	}
+
+	static std::string Hex(uint64_t value, size_t width) { return Hex((const uint8_t*)&value, width); }
+	static std::string Hex(const uint8_t* data, size_t len)
+	{
+		std::string hex;
+		for (size_t i = 0; i < len; i++)
+			hex += std::format("{:02x}", data[i]);
+		return hex;
+	}
+
+	static void Send(socket_t s, const std::string& data) { send(s, data.data(), (int)data.size(), 0); }
+
+	Options m_options;
+	socket_t m_listener;
+	uint16_t m_port = 0;
+	std::thread m_thread;
+	std::vector<uint8_t> m_memory;
+	uint64_t m_rip = 0;
+	std::set<uint64_t> m_breakpoints;
+	size_t m_naksent = 0;
+	size_t m_resent = 0;
+};
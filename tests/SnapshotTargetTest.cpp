@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <fstream>
+#include "FakeTarget.hpp"
+#include "SnapshotTarget.hpp"
+#include "Test.hpp"
+
+using gdbw::SnapshotTarget;
+
+static std::vector<uint8_t> ReadFile(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+}
+
+static void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write((const char*)data.data(), data.size());
+}
+
+template <typename T>
+static void Patch(std::vector<uint8_t>& data, size_t offset, T value)
+{
+	memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+// Offset of the first region entry: magic, version, bitness, set, count, GP64 values, region count
+static constexpr size_t FirstRegion = 8 + 4 * 4 + 17 * 8 + 4;
+
+int main()
+{
+	std::string path = (std::filesystem::temp_directory_path() / "gdbw_snapshot_test.snap").string();
+
+	FakeTarget source;
+	// Bigger than a save chunk, so it's streamed in several pieces
+	source.AddRegion(0x10000, 0x280000);
+	source.AddRegion(0x400000, 0x1000, false);
+	// Stops reading part way, must be saved without data
+	source.AddRegion(0x500000, 0x200000).readlimit = 0x180000;
+	source.AddRegion(0x800000, 0x2000);
+	source.modules.push_back({ 0x10000, 0x280000, "C:\\Windows\\System32\\ntdll.dll" });
+
+	// Round trip
+	auto saved = SnapshotTarget::Save(source, path);
+	CHECK(saved);
+	{
+		SnapshotTarget snapshot;
+		CHECK(snapshot.Load(path));
+		CHECK(snapshot.Is64Bit());
+
+		auto regions = snapshot.GetRegions();
+		CHECK(regions && regions->size() == 4);
+		CHECK((*regions)[2].baseaddress == 0x500000 && (*regions)[2].size == 0x200000);
+
+		std::vector<uint8_t> data(0x280000);
+		auto read = snapshot.ReadMemory(0x10000, (uint32_t)data.size(), data.data());
+		CHECK(read && *read == data.size());
+		CHECK(data == source.regions[0].data);
+		read = snapshot.ReadMemory(0x800000, 0x2000, data.data());
+		CHECK(read && *read == 0x2000 && memcmp(data.data(), source.regions[3].data.data(), 0x2000) == 0);
+		CHECK(!snapshot.ReadMemory(0x400000, 16, data.data()));
+		CHECK(!snapshot.ReadMemory(0x500000, 16, data.data()));
+
+		auto registers = snapshot.GetRegisters(gdbw::DE::RegisterSet::GP64);
+		CHECK(registers && registers->count == 17 && registers->values[6] == 0x1006);
+
+		auto modules = snapshot.GetModules();
+		CHECK(modules && modules->size() == 1 && (*modules)[0].name == source.modules[0].name);
+	}
+
+	// The partly read region's data was rewound, nothing is left past the module list
+	std::vector<uint8_t> file = ReadFile(path);
+	size_t expected = FirstRegion + 4 * 37 + 0x280000 + 0x2000 + 4 + 20 + source.modules[0].name.size();
+	CHECK(file.size() == expected);
+
+	// Sizes & counts larger than the file are rejected before anything is allocated
+	{
+		auto corrupt = file;
+		Patch<uint64_t>(corrupt, FirstRegion + 16, 1ull << 60);
+		WriteFile(path, corrupt);
+		SnapshotTarget snapshot;
+		CHECK(!snapshot.Load(path));
+	}
+	{
+		auto corrupt = file;
+		Patch<uint32_t>(corrupt, FirstRegion - 4, 0xffffffff);
+		WriteFile(path, corrupt);
+		SnapshotTarget snapshot;
+		CHECK(!snapshot.Load(path));
+	}
+	{
+		auto corrupt = file;
+		Patch<uint32_t>(corrupt, file.size() - source.modules[0].name.size() - 4, 0x7fffffff);
+		WriteFile(path, corrupt);
+		SnapshotTarget snapshot;
+		CHECK(!snapshot.Load(path));
+	}
+	{
+		auto corrupt = file;
+		corrupt.resize(FirstRegion + 37 + 0x1000);
+		WriteFile(path, corrupt);
+		SnapshotTarget snapshot;
+		CHECK(!snapshot.Load(path));
+	}
+
+	std::filesystem::remove(path);
+	return 0;
+}
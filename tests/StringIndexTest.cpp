@@ -0,0 +1,37 @@
+#include "FakeTarget.hpp"
+#include "StringIndex.hpp"
+#include "Test.hpp"
+
+using gdbw::StringIndex;
+
+int main()
+{
+	FakeTarget target;
+	auto& region = target.AddRegion(0x10000, 0x1000);
+	std::fill(region.data.begin(), region.data.end(), 0);
+	memcpy(region.data.data() + 0x100, "first string", 12);
+	memcpy(region.data.data() + 0x200, "s\0e\0c\0o\0n\0d\0", 12);
+	memcpy(region.data.data() + 0x300, "third string", 12);
+
+	gdbw::RegionMap regions;
+	regions.Add(MemoryRegion(region.info));
+	StringIndex index;
+	index.Build(target, regions, { { 0x10000, 0x1000 } }, 7, 4, gdbw::STRING_ASCII | gdbw::STRING_UTF16);
+	CHECK(index.Covers(7, 4, gdbw::STRING_ASCII) && !index.Covers(8, 4, gdbw::STRING_ASCII));
+
+	auto matches = index.Query(0, ~0ull, "", 4, gdbw::STRING_ASCII | gdbw::STRING_UTF16, 0);
+	CHECK(matches.size() == 3 && index.Text(*matches[1]) == "second" && matches[1]->encoding == gdbw::STRING_UTF16);
+
+	// Strings that changed in memory fail verification & are skipped by a query checking them
+	auto read = [&](uint64_t address, uint32_t len, void* out) { return target.ReadMemory(address, len, out); };
+	auto current = [&](const StringIndex::Entry& entry) { return index.Verify(entry, read); };
+	CHECK(index.Verify(*matches[0], read) && index.Verify(*matches[1], read));
+	region.data[0x104] = 'X';
+	region.data[0x201] = 'Y';
+	CHECK(!index.Verify(*matches[0], read) && !index.Verify(*matches[1], read));
+	matches = index.Query(0, ~0ull, "", 4, gdbw::STRING_ASCII | gdbw::STRING_UTF16, 1, current);
+	CHECK(matches.size() == 1 && index.Text(*matches[0]) == "third string");
+	matches = index.Query(0, ~0ull, "string", 4, gdbw::STRING_ASCII, 0, current);
+	CHECK(matches.size() == 1 && matches[0]->address == 0x10300);
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include "StringPool.hpp"
+#include "Test.hpp"
+
+using gdbw::StringPool;
+
+int main()
+{
+	StringPool pool;
+
+	// Enough strings to grow the table several times, every one interned twice
+	for (int round = 0; round < 2; round++)
+	{
+		for (uint32_t i = 0; i < 5000; i++)
+		{
+			std::string str = "str" + std::to_string(i);
+			CHECK(pool.Intern(str) == i);
+		}
+	}
+	CHECK(pool.Count() == 5000);
+	CHECK(pool.View(1234) == "str1234" && strcmp(pool.Get(4999), "str4999") == 0);
+	const char* first = pool.Get(0);
+
+	// Oversized strings get their own block & still dedupe
+	std::string big(StringPool::BlockSize + 10, 'x');
+	uint32_t id = pool.Intern(big);
+	CHECK(pool.Intern(big) == id && pool.View(id) == big);
+	CHECK(pool.Get(0) == first);
+
+	// Clear starts ids over
+	pool.Clear();
+	CHECK(pool.Count() == 0);
+	CHECK(pool.Intern("") == 0 && pool.Intern("a") == 1 && pool.Intern("") == 0);
+	CHECK(pool.Intern(big) == 2 && pool.Intern("str1") == 3);
+
+	// Only oversized strings interned before a clear
+	StringPool large;
+	large.Intern(big);
+	large.Clear();
+	CHECK(large.Intern("small") == 0 && large.View(0) == "small");
+	return 0;
+}
@@ -0,0 +1,54 @@
+#include "SymbolCache.hpp"
+#include "Test.hpp"
+#include <string>
+
+using gdbw::SymbolCache;
+
+int main()
+{
+	SymbolCache cache;
+
+	// A sized symbol answers for every address inside it
+	cache.Insert(0x1010, 0x1000, 0x40, 0, 0x1000, "func");
+	auto symbol = cache.Lookup(0x1030);
+	CHECK(symbol && symbol->Address() == 0x1000 && symbol->Displacement() == 0x30 && strcmp(symbol->Name(), "func") == 0);
+	CHECK(!cache.Lookup(0x1040));
+
+	// Misses are remembered, but only up to MaxMisses
+	bool miss = false;
+	cache.InsertMiss(0x5000);
+	CHECK(!cache.Lookup(0x5000, &miss) && miss);
+	for (uint64_t i = 1; i < SymbolCache::MaxMisses; i++)
+		cache.InsertMiss(0x100000 + i);
+	CHECK(cache.Misses() == SymbolCache::MaxMisses);
+	cache.InsertMiss(0x6000);
+	CHECK(cache.Misses() == 1);
+	CHECK(!cache.Lookup(0x5000, &miss) && !miss);
+	CHECK(!cache.Lookup(0x6000, &miss) && miss);
+
+	// Distinct names past MaxNames flush the cache instead of growing the pool forever
+	cache.Flush();
+	for (uint64_t i = 0; i < SymbolCache::MaxNames; i++)
+		cache.Insert(0x100000 + i, 0x100000 + i, 1, 0, 0x100000, ("sym" + std::to_string(i)).c_str());
+	CHECK(cache.Size() == SymbolCache::MaxNames);
+	symbol = cache.Insert(0x10, 0x10, 1, 0, 0, "last");
+	CHECK(cache.Size() == 1 && strcmp(symbol->Name(), "last") == 0);
+	CHECK(!cache.Lookup(0x100000));
+
+	// A batch holding names from before the limit keeps them valid, the flush waits for the batch to end
+	cache.Flush();
+	for (uint64_t i = 0; i < SymbolCache::MaxNames - 1; i++)
+		cache.Insert(0x100000 + i, 0x100000 + i, 1, 0, 0x100000, ("sym" + std::to_string(i)).c_str());
+	{
+		SymbolCache::DeferFlush defer(cache);
+		auto first = cache.Insert(0x20, 0x20, 1, 0, 0, "first");
+		auto second = cache.Insert(0x30, 0x30, 1, 0, 0, "second");
+		auto third = cache.Insert(0x40, 0x40, 1, 0, 0, "third");
+		CHECK(cache.Size() == SymbolCache::MaxNames + 2);
+		CHECK(strcmp(first.Name(), "first") == 0 && strcmp(second.Name(), "second") == 0 && strcmp(third.Name(), "third") == 0);
+		CHECK(cache.Lookup(0x100000) && strcmp(cache.Lookup(0x100000)->Name(), "sym0") == 0);
+	}
+	symbol = cache.Insert(0x50, 0x50, 1, 0, 0, "after");
+	CHECK(cache.Size() == 1 && strcmp(symbol->Name(), "after") == 0);
+	return 0;
+}
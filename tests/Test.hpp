@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// Tests are plain executables run by ctest, a failed check prints where it failed & exits non zero
+#define CHECK(expr) \
+	do \
+	{ \
+		if (!(expr)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			std::exit(1); \
+		} \
+	} while (0)